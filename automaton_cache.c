@@ -0,0 +1,433 @@
+#include "cox_prot.h"
+
+/******************************************************************************/
+/* Function: search_canonical_labelling                                       */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN/OUT search - The search so far. The best labelling is       */
+/*                             updated whenever a smaller one is found.       */
+/*             IN     depth - The number of generators labelled so far.       */
+/*                                                                            */
+/* Operation: Try each unlabelled generator as the next label. The canonical  */
+/*            labelling is the one giving the smallest matrix, comparing the  */
+/*            entries below the diagonal row by row. Labelling a generator    */
+/*            fixes the next row, so a generator whose row is bigger than the */
+/*            best's can't lead anywhere better and is skipped.               */
+/******************************************************************************/
+void search_canonical_labelling(CANONICAL_SEARCH *search, int depth)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  CANONICAL_LABELLING *labelling = search->labelling;
+  long entry;
+  int gg;
+  int ii;
+  int jj;
+
+  if (depth == search->num_generators)
+  {
+    for (ii = 0; ii < search->num_generators; ii++)
+    {
+      labelling->generator_at[ii] = search->order[ii];
+      labelling->canonical_of[search->order[ii]] = ii;
+      for (jj = 0; jj < search->num_generators; jj++)
+      {
+        labelling->matrix[ii][jj] =
+                search->coxeter_matrix[search->order[ii]][search->order[jj]];
+      }
+    }
+    search->have_best = true;
+    search->smaller_at = -1;
+    goto EXIT_LABEL;
+  }
+
+  for (gg = 0; gg < search->num_generators; gg++)
+  {
+    if (search->used[gg])
+    {
+      continue;
+    }
+
+    /**************************************************************************/
+    /* While the labels so far give the same rows as the best labelling,      */
+    /* compare the row this generator would give.                             */
+    /**************************************************************************/
+    if (search->have_best && search->smaller_at == -1)
+    {
+      for (jj = 0; jj < depth; jj++)
+      {
+        entry = search->coxeter_matrix[gg][search->order[jj]];
+        if (entry != labelling->matrix[depth][jj])
+        {
+          break;
+        }
+      }
+      if (jj < depth && entry > labelling->matrix[depth][jj])
+      {
+        continue;
+      }
+      if (jj < depth)
+      {
+        search->smaller_at = depth;
+      }
+    }
+
+    search->used[gg] = true;
+    search->order[depth] = gg;
+    search_canonical_labelling(search, depth + 1);
+    search->used[gg] = false;
+    if (search->smaller_at == depth)
+    {
+      search->smaller_at = -1;
+    }
+  }
+
+EXIT_LABEL:
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: find_canonical_labelling                                         */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     matrix_data - Precalculated information about the group.*/
+/*             IN     num_generators - The number of group generators.        */
+/*             OUT    labelling - Will be returned holding the canonical      */
+/*                                labelling of the generators.                */
+/*                                                                            */
+/* Operation: Search every labelling for the one giving the smallest matrix.  */
+/*            Groups have few enough generators that this is quick, even for  */
+/*            a graph with many symmetries where little can be skipped.       */
+/******************************************************************************/
+void find_canonical_labelling(MATRIX_DATA *matrix_data,
+                              int num_generators,
+                              CANONICAL_LABELLING *labelling)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  CANONICAL_SEARCH search;
+  int ii;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(matrix_data != NULL);
+  assert(num_generators > 0 && num_generators <= MAX_GENERATORS);
+  assert(labelling != NULL);
+
+  search.coxeter_matrix = matrix_data->coxeter_matrix;
+  search.num_generators = num_generators;
+  search.have_best = false;
+  search.smaller_at = -1;
+  search.labelling = labelling;
+  for (ii = 0; ii < num_generators; ii++)
+  {
+    search.used[ii] = false;
+  }
+  search_canonical_labelling(&search, 0);
+
+  labelling->num_generators = num_generators;
+  for (ii = 0; ii < num_generators; ii++)
+  {
+    labelling->matrix_rows[ii] = labelling->matrix[ii];
+  }
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: automaton_cache_filename                                         */
+/*                                                                            */
+/* Returns: One of CACHED_AUTOMATON_RET_CODES.                                */
+/*                                                                            */
+/* Parameters: IN     directory - The cache directory.                        */
+/*             IN     labelling - The canonical labelling of the group.       */
+/*             OUT    filename - Will be returned holding the name of the     */
+/*                               group's file in the cache. Must be freed by  */
+/*                               the caller.                                  */
+/*                                                                            */
+/* Operation: Name the file after a hash of the canonical matrix. Groups with */
+/*            the same hash share a file, which is why the matrix in a cached */
+/*            file is always checked before it is used.                       */
+/******************************************************************************/
+int automaton_cache_filename(char *directory,
+                             CANONICAL_LABELLING *labelling,
+                             char **filename)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = CACHED_AUTOMATON_OK;
+  uint64_t key[MAX_GENERATORS * MAX_GENERATORS];
+  int num_generators = labelling->num_generators;
+  int ii;
+  int jj;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(directory != NULL);
+  assert(labelling != NULL);
+  assert(filename != NULL);
+
+  for (ii = 0; ii < num_generators; ii++)
+  {
+    for (jj = 0; jj < num_generators; jj++)
+    {
+      key[ii * num_generators + jj] = (uint64_t) labelling->matrix[ii][jj];
+    }
+  }
+
+  *filename = (char *) malloc(strlen(directory) +
+                              1 +
+                              AUTOMATON_CACHE_NAME_LENGTH);
+  if (*filename == NULL)
+  {
+    ret_code = CACHED_AUTOMATON_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  sprintf(*filename,
+          "%s/%016llx.aut",
+          directory,
+          (unsigned long long) hash_root_bitset(key,
+                                                num_generators *
+                                                num_generators));
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: relabel_automaton_table                                          */
+/*                                                                            */
+/* Returns: One of CACHED_AUTOMATON_RET_CODES.                                */
+/*                                                                            */
+/* Parameters: IN     table - The automaton to relabel.                       */
+/*             IN     column_of - The generator of table which each generator */
+/*                                of the relabelled table reads as.           */
+/*             OUT    relabelled - Will be returned holding a copy of table   */
+/*                                 with its columns permuted.                 */
+/*                                                                            */
+/* Operation: Relabelling the generators doesn't change the states, so only   */
+/*            the columns of the transitions move.                            */
+/******************************************************************************/
+int relabel_automaton_table(AUTOMATON_TABLE *table,
+                            int *column_of,
+                            AUTOMATON_TABLE **relabelled)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = CACHED_AUTOMATON_OK;
+  int num_generators = table->num_generators;
+  int32_t *row;
+  int32_t *new_row;
+  long ii;
+  int gg;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(table != NULL);
+  assert(column_of != NULL);
+  assert(relabelled != NULL);
+
+  if (init_automaton_table(num_generators,
+                           table->num_states,
+                           relabelled) != INIT_AUTOMATON_TABLE_OK)
+  {
+    ret_code = CACHED_AUTOMATON_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  (*relabelled)->start_state = table->start_state;
+
+  for (ii = 0; ii < table->num_states; ii++)
+  {
+    row = table->transitions + ii * num_generators;
+    new_row = (*relabelled)->transitions + ii * num_generators;
+    for (gg = 0; gg < num_generators; gg++)
+    {
+      new_row[gg] = row[column_of[gg]];
+    }
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: load_cached_automaton                                            */
+/*                                                                            */
+/* Returns: One of CACHED_AUTOMATON_RET_CODES. CACHED_AUTOMATON_MISSING if    */
+/*          the group isn't in the cache in any labelling.                    */
+/*                                                                            */
+/* Parameters: IN     directory - The cache directory.                        */
+/*             IN     matrix_data - Precalculated information about the group.*/
+/*             IN     num_generators - The number of group generators.        */
+/*             OUT    table - Will be returned holding the automaton for the  */
+/*                            group with the caller's labelling.              */
+/*                                                                            */
+/* Operation: Find the canonical labelling, map the file it names and check   */
+/*            it holds the same canonical matrix. The cached automaton reads  */
+/*            canonical labels, so it is copied with the columns put back in  */
+/*            the caller's order. A file which can't be mapped (one saved in  */
+/*            an older format, say) is treated as missing so that it gets     */
+/*            replaced.                                                       */
+/******************************************************************************/
+int load_cached_automaton(char *directory,
+                          MATRIX_DATA *matrix_data,
+                          int num_generators,
+                          AUTOMATON_TABLE **table)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code;
+  CANONICAL_LABELLING labelling;
+  MATRIX_DATA canonical_data;
+  MAPPED_AUTOMATON *mapped = NULL;
+  char *filename = NULL;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(directory != NULL);
+  assert(matrix_data != NULL);
+  assert(table != NULL);
+
+  find_canonical_labelling(matrix_data, num_generators, &labelling);
+  ret_code = automaton_cache_filename(directory, &labelling, &filename);
+  if (ret_code != CACHED_AUTOMATON_OK)
+  {
+    goto EXIT_LABEL;
+  }
+
+  ret_code = map_automaton_file(filename, &mapped);
+  if (ret_code == MAP_AUTOMATON_FILE_MEM_ERR)
+  {
+    ret_code = CACHED_AUTOMATON_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  if (ret_code != MAP_AUTOMATON_FILE_OK)
+  {
+    ret_code = CACHED_AUTOMATON_MISSING;
+    goto EXIT_LABEL;
+  }
+
+  memset(&canonical_data, 0, sizeof(canonical_data));
+  canonical_data.coxeter_matrix = labelling.matrix_rows;
+  if (!automaton_file_matches_group(mapped, &canonical_data, num_generators))
+  {
+    ret_code = CACHED_AUTOMATON_MISSING;
+    goto EXIT_LABEL;
+  }
+
+  ret_code = relabel_automaton_table(&(mapped->table),
+                                     labelling.canonical_of,
+                                     table);
+
+EXIT_LABEL:
+
+  if (mapped != NULL)
+  {
+    unmap_automaton_file(mapped);
+  }
+  free(filename);
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: store_cached_automaton                                           */
+/*                                                                            */
+/* Returns: One of CACHED_AUTOMATON_RET_CODES.                                */
+/*                                                                            */
+/* Parameters: IN     directory - The cache directory, which is created if it */
+/*                                doesn't exist.                              */
+/*             IN     matrix_data - Precalculated information about the group.*/
+/*             IN     num_generators - The number of group generators.        */
+/*             IN     table - The automaton built for the group.              */
+/*                                                                            */
+/* Operation: Relabel the automaton to read canonical labels and save it      */
+/*            along with the canonical matrix under the name the labelling    */
+/*            gives. The minimal roots aren't saved as they are in terms of   */
+/*            the caller's generators.                                        */
+/******************************************************************************/
+int store_cached_automaton(char *directory,
+                           MATRIX_DATA *matrix_data,
+                           int num_generators,
+                           AUTOMATON_TABLE *table)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code;
+  CANONICAL_LABELLING labelling;
+  MATRIX_DATA canonical_data;
+  AUTOMATON_TABLE *canonical_table = NULL;
+  char *filename = NULL;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(directory != NULL);
+  assert(matrix_data != NULL);
+  assert(table != NULL);
+  assert(table->num_generators == num_generators);
+
+  if (mkdir(directory, 0777) != 0 && errno != EEXIST)
+  {
+    ret_code = CACHED_AUTOMATON_FILE_ERR;
+    goto EXIT_LABEL;
+  }
+
+  find_canonical_labelling(matrix_data, num_generators, &labelling);
+  ret_code = automaton_cache_filename(directory, &labelling, &filename);
+  if (ret_code != CACHED_AUTOMATON_OK)
+  {
+    goto EXIT_LABEL;
+  }
+  ret_code = relabel_automaton_table(table,
+                                     labelling.generator_at,
+                                     &canonical_table);
+  if (ret_code != CACHED_AUTOMATON_OK)
+  {
+    goto EXIT_LABEL;
+  }
+
+  memset(&canonical_data, 0, sizeof(canonical_data));
+  canonical_data.coxeter_matrix = labelling.matrix_rows;
+  ret_code = save_automaton_file(filename,
+                                 canonical_table,
+                                 &canonical_data,
+                                 NULL);
+  if (ret_code == SAVE_AUTOMATON_FILE_MEM_ERR)
+  {
+    ret_code = CACHED_AUTOMATON_MEM_ERR;
+  }
+  else if (ret_code != SAVE_AUTOMATON_FILE_OK)
+  {
+    ret_code = CACHED_AUTOMATON_FILE_ERR;
+  }
+  else
+  {
+    ret_code = CACHED_AUTOMATON_OK;
+  }
+
+EXIT_LABEL:
+
+  if (canonical_table != NULL)
+  {
+    free_automaton_table(canonical_table);
+  }
+  free(filename);
+
+  return(ret_code);
+}
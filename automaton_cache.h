@@ -0,0 +1,56 @@
+/******************************************************************************/
+/* Group: CACHED_AUTOMATON_RET_CODES                                          */
+/*                                                                            */
+/* The return codes for functions load_cached_automaton,                      */
+/* store_cached_automaton, automaton_cache_filename and                       */
+/* relabel_automaton_table.                                                   */
+/******************************************************************************/
+#define CACHED_AUTOMATON_OK       0
+#define CACHED_AUTOMATON_MEM_ERR  1
+#define CACHED_AUTOMATON_FILE_ERR 2
+#define CACHED_AUTOMATON_MISSING  3
+
+/******************************************************************************/
+/* The length of the name of a file in the cache directory: the key as 16 hex */
+/* digits, ".aut" and the terminating null.                                   */
+/******************************************************************************/
+#define AUTOMATON_CACHE_NAME_LENGTH 21
+
+/******************************************************************************/
+/* This structure is the canonical labelling of the generators of a group.    */
+/* Relabelling the generators of any group with the same Coxeter graph this   */
+/* way gives the same matrix, so it is used as the key of the cache.          */
+/* canonical_of - The canonical label of each of the caller's generators.     */
+/* generator_at - The caller's generator with each canonical label, which is  */
+/*                the permutation back to the caller's labelling.             */
+/* matrix - The Coxeter matrix under the canonical labelling.                 */
+/* matrix_rows - The rows of matrix, in the form MATRIX_DATA holds them.      */
+/******************************************************************************/
+typedef struct canonical_labelling
+{
+  int num_generators;
+  int canonical_of[MAX_GENERATORS];
+  int generator_at[MAX_GENERATORS];
+  long matrix[MAX_GENERATORS][MAX_GENERATORS];
+  long *matrix_rows[MAX_GENERATORS];
+} CANONICAL_LABELLING;
+
+/******************************************************************************/
+/* This structure holds the state of the search for a canonical labelling.    */
+/* order - The generators given canonical labels 0, 1, ... so far.            */
+/* used - Whether each generator is in order yet.                             */
+/* have_best - Whether a complete labelling has been found yet.               */
+/* smaller_at - The label at which order first gave a smaller matrix than the */
+/*              best labelling so far, or -1 if it hasn't.                    */
+/* labelling - The best labelling found so far.                               */
+/******************************************************************************/
+typedef struct canonical_search
+{
+  long **coxeter_matrix;
+  int num_generators;
+  int order[MAX_GENERATORS];
+  bool used[MAX_GENERATORS];
+  bool have_best;
+  int smaller_at;
+  CANONICAL_LABELLING *labelling;
+} CANONICAL_SEARCH;
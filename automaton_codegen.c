@@ -0,0 +1,344 @@
+#include "cox_prot.h"
+
+/******************************************************************************/
+/* Function: is_c_identifier                                                  */
+/*                                                                            */
+/* Returns: true if the name can be used as a C identifier and false          */
+/*          otherwise.                                                        */
+/*                                                                            */
+/* Parameters: IN     name - The name to be checked.                          */
+/*                                                                            */
+/* Operation: The name must be letters, digits and underscores and must not   */
+/*            start with a digit.                                             */
+/******************************************************************************/
+bool is_c_identifier(char *name)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  bool result = true;
+  int ii;
+
+  assert(name != NULL);
+
+  if (name[0] == '\0' || isdigit((unsigned char) name[0]))
+  {
+    result = false;
+    goto EXIT_LABEL;
+  }
+  for (ii = 0; name[ii] != '\0'; ii++)
+  {
+    if (!isalnum((unsigned char) name[ii]) && name[ii] != '_')
+    {
+      result = false;
+      goto EXIT_LABEL;
+    }
+  }
+
+EXIT_LABEL:
+
+  return(result);
+}
+
+/******************************************************************************/
+/* Function: write_transition_array                                           */
+/*                                                                            */
+/* Returns: One of WRITE_AUTOMATON_SOURCE_RET_CODES.                          */
+/*                                                                            */
+/* Parameters: IN     source_file - The file being written.                   */
+/*             IN     table - The automaton to write out.                     */
+/*             IN     array_name - The name of the array in the source.       */
+/*                                                                            */
+/* Operation: Write the transitions as a static const two dimensional array   */
+/*            with one row per state, so that the row width is a constant the */
+/*            compiler can see. The narrowest signed type which holds every   */
+/*            state id and -1 for the reject state is used.                   */
+/******************************************************************************/
+int write_transition_array(FILE *source_file,
+                           AUTOMATON_TABLE *table,
+                           char *array_name)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = WRITE_AUTOMATON_SOURCE_OK;
+  char *type_name;
+  long ii;
+  int gg;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(source_file != NULL);
+  assert(table != NULL);
+  assert(array_name != NULL);
+
+  if (table->num_states <= INT8_MAX)
+  {
+    type_name = "int8_t";
+  }
+  else if (table->num_states <= INT16_MAX)
+  {
+    type_name = "int16_t";
+  }
+  else
+  {
+    type_name = "int32_t";
+  }
+
+  fprintf(source_file,
+          "static const %s %s[%ld][%d] =\n{\n",
+          type_name,
+          array_name,
+          table->num_states,
+          table->num_generators);
+  for (ii = 0; ii < table->num_states; ii++)
+  {
+    fprintf(source_file, "  {");
+    for (gg = 0; gg < table->num_generators; gg++)
+    {
+      fprintf(source_file,
+              (gg == 0) ? "%d" : ", %d",
+              (int) table->transitions[ii * table->num_generators + gg]);
+    }
+    fprintf(source_file, (ii + 1 < table->num_states) ? "},\n" : "}\n");
+  }
+  fprintf(source_file, "};\n\n");
+
+  if (ferror(source_file))
+  {
+    ret_code = WRITE_AUTOMATON_SOURCE_FILE_ERR;
+  }
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: write_automaton_source                                           */
+/*                                                                            */
+/* Returns: One of WRITE_AUTOMATON_SOURCE_RET_CODES.                          */
+/*                                                                            */
+/* Parameters: IN     prefix - The name of the file written (with .c added)   */
+/*                             and the prefix of everything defined in it.    */
+/*                             Must be a C identifier.                        */
+/*             IN     automaton_table - The automaton to write out.           */
+/*                                                                            */
+/* Operation: Write a standalone C file holding the transition table as a     */
+/*            static const array along with <prefix>_is_reduced and           */
+/*            <prefix>_reduce, which reduces a word in place in one pass as   */
+/*            reduce_generator_word does. The reduced words are closed under  */
+/*            reversal, so the same table finds the letter a rejected one     */
+/*            cancels with. Both functions check every letter is one of the   */
+/*            generators before using it as an index. Every size in the file  */
+/*            is a constant, so the file can be compiled into another program */
+/*            which then needs no automaton construction at startup.          */
+/******************************************************************************/
+int write_automaton_source(char *prefix, AUTOMATON_TABLE *automaton_table)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = WRITE_AUTOMATON_SOURCE_OK;
+  FILE *source_file = NULL;
+  char *filename = NULL;
+  char *upper_prefix = NULL;
+  char *array_name = NULL;
+  size_t prefix_length;
+  size_t ii;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(prefix != NULL && is_c_identifier(prefix));
+  assert(automaton_table != NULL);
+
+  prefix_length = strlen(prefix);
+  filename = (char *) malloc(prefix_length + 3);
+  upper_prefix = (char *) malloc(prefix_length + 1);
+  array_name = (char *) malloc(prefix_length + 7);
+  if (filename == NULL || upper_prefix == NULL || array_name == NULL)
+  {
+    ret_code = WRITE_AUTOMATON_SOURCE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  sprintf(filename, "%s.c", prefix);
+  for (ii = 0; ii <= prefix_length; ii++)
+  {
+    upper_prefix[ii] = (char) toupper((unsigned char) prefix[ii]);
+  }
+
+  source_file = fopen(filename, "w");
+  if (source_file == NULL)
+  {
+    ret_code = WRITE_AUTOMATON_SOURCE_FILE_ERR;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* The constants and the table.                                             */
+  /****************************************************************************/
+  fprintf(source_file,
+          "/* Reduced word automaton for a Coxeter group on %d generators.\n"
+          " * Generated by the coxeter program. Do not edit.\n"
+          " * %s_is_reduced returns 1 if the word is reduced, 0 if it isn't\n"
+          " * and %s_BAD_LETTER if a letter isn't a generator, setting\n"
+          " * *fail_index to the letter it stopped at. %s_reduce reduces\n"
+          " * the word in place and returns its length, or returns\n"
+          " * %s_BAD_LETTER or %s_MEM_ERR leaving the word as it was. */\n"
+          "#include <stdint.h>\n"
+          "#include <stdlib.h>\n"
+          "#include <string.h>\n\n",
+          automaton_table->num_generators,
+          prefix,
+          upper_prefix,
+          prefix,
+          upper_prefix,
+          upper_prefix);
+  fprintf(source_file,
+          "#define %s_NUM_GENERATORS %d\n"
+          "#define %s_START_STATE %d\n"
+          "#define %s_BAD_LETTER (-1)\n"
+          "#define %s_MEM_ERR (-2)\n\n",
+          upper_prefix,
+          automaton_table->num_generators,
+          upper_prefix,
+          (int) automaton_table->start_state,
+          upper_prefix,
+          upper_prefix);
+
+  sprintf(array_name, "%s_table", prefix);
+  ret_code = write_transition_array(source_file, automaton_table, array_name);
+  if (ret_code != WRITE_AUTOMATON_SOURCE_OK)
+  {
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* <prefix>_is_reduced returns whether the word is reduced and where it     */
+  /* stopped being reduced if it isn't.                                       */
+  /****************************************************************************/
+  fprintf(source_file,
+          "int %s_is_reduced(const char *word, int *fail_index)\n"
+          "{\n"
+          "  int state = %s_START_STATE;\n"
+          "  int generator;\n"
+          "  int ii;\n\n"
+          "  for (ii = 0; word[ii] != '\\0'; ii++)\n"
+          "  {\n"
+          "    generator = word[ii] - 'a';\n"
+          "    if (generator < 0 || generator >= %s_NUM_GENERATORS)\n"
+          "    {\n"
+          "      *fail_index = ii;\n"
+          "      return(%s_BAD_LETTER);\n"
+          "    }\n"
+          "    state = %s_table[state][generator];\n"
+          "    if (state < 0)\n"
+          "    {\n"
+          "      *fail_index = ii;\n"
+          "      return(0);\n"
+          "    }\n"
+          "  }\n"
+          "  *fail_index = 0;\n\n"
+          "  return(1);\n"
+          "}\n\n",
+          prefix,
+          upper_prefix,
+          upper_prefix,
+          upper_prefix,
+          prefix);
+
+  /****************************************************************************/
+  /* <prefix>_reduce builds the reduced word at the front of the word,        */
+  /* keeping the state after each letter. A rejected letter is cancelled with */
+  /* the letter at which the table, reading back from it, rejects, and only   */
+  /* the states after that letter are worked out again.                       */
+  /****************************************************************************/
+  fprintf(source_file,
+          "int %s_reduce(char *word)\n"
+          "{\n"
+          "  int length = (int) strlen(word);\n"
+          "  int32_t *states;\n"
+          "  int reduced_length = 0;\n"
+          "  int read_index;\n"
+          "  int cancel_index;\n"
+          "  int generator;\n"
+          "  int state;\n\n"
+          "  for (read_index = 0; read_index < length; read_index++)\n"
+          "  {\n"
+          "    generator = word[read_index] - 'a';\n"
+          "    if (generator < 0 || generator >= %s_NUM_GENERATORS)\n"
+          "    {\n"
+          "      return(%s_BAD_LETTER);\n"
+          "    }\n"
+          "  }\n"
+          "  states = (int32_t *) malloc(sizeof(int32_t) * (length + 1));\n"
+          "  if (states == NULL)\n"
+          "  {\n"
+          "    return(%s_MEM_ERR);\n"
+          "  }\n"
+          "  states[0] = %s_START_STATE;\n\n"
+          "  for (read_index = 0; read_index < length; read_index++)\n"
+          "  {\n"
+          "    generator = word[read_index] - 'a';\n"
+          "    state = %s_table[states[reduced_length]][generator];\n"
+          "    if (state >= 0)\n"
+          "    {\n"
+          "      word[reduced_length] = word[read_index];\n"
+          "      reduced_length++;\n"
+          "      states[reduced_length] = state;\n"
+          "      continue;\n"
+          "    }\n\n"
+          "    state = %s_table[%s_START_STATE][generator];\n"
+          "    for (cancel_index = reduced_length - 1;\n"
+          "         cancel_index > 0;\n"
+          "         cancel_index--)\n"
+          "    {\n"
+          "      state = %s_table[state][word[cancel_index] - 'a'];\n"
+          "      if (state < 0)\n"
+          "      {\n"
+          "        break;\n"
+          "      }\n"
+          "    }\n\n"
+          "    memmove(word + cancel_index,\n"
+          "            word + cancel_index + 1,\n"
+          "            reduced_length - cancel_index - 1);\n"
+          "    reduced_length--;\n"
+          "    for (; cancel_index < reduced_length; cancel_index++)\n"
+          "    {\n"
+          "      generator = word[cancel_index] - 'a';\n"
+          "      states[cancel_index + 1] =\n"
+          "                     %s_table[states[cancel_index]][generator];\n"
+          "    }\n"
+          "  }\n"
+          "  word[reduced_length] = '\\0';\n"
+          "  free(states);\n\n"
+          "  return(reduced_length);\n"
+          "}\n",
+          prefix,
+          upper_prefix,
+          upper_prefix,
+          upper_prefix,
+          upper_prefix,
+          prefix,
+          prefix,
+          upper_prefix,
+          prefix,
+          prefix);
+
+  if (ferror(source_file))
+  {
+    ret_code = WRITE_AUTOMATON_SOURCE_FILE_ERR;
+  }
+
+EXIT_LABEL:
+
+  if (source_file != NULL && fclose(source_file) != 0)
+  {
+    ret_code = WRITE_AUTOMATON_SOURCE_FILE_ERR;
+  }
+  free(filename);
+  free(upper_prefix);
+  free(array_name);
+
+  return(ret_code);
+}
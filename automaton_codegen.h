@@ -0,0 +1,9 @@
+/******************************************************************************/
+/* Group: WRITE_AUTOMATON_SOURCE_RET_CODES                                    */
+/*                                                                            */
+/* The return codes for functions write_automaton_source and                  */
+/* write_transition_array.                                                    */
+/******************************************************************************/
+#define WRITE_AUTOMATON_SOURCE_OK       0
+#define WRITE_AUTOMATON_SOURCE_FILE_ERR 1
+#define WRITE_AUTOMATON_SOURCE_MEM_ERR  2
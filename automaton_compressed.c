@@ -0,0 +1,850 @@
+#include "cox_prot.h"
+
+/******************************************************************************/
+/* Function: find_distinct_rows                                               */
+/*                                                                            */
+/* Returns: One of COMPRESS_AUTOMATON_TABLE_RET_CODES.                        */
+/*                                                                            */
+/* Parameters: IN     table - The automaton whose rows are to be compared.    */
+/*             OUT    row_of_state - An array with one entry per state which  */
+/*                                   is filled in with the row id of the      */
+/*                                   state.                                   */
+/*             OUT    row_states - An array with one entry per state whose    */
+/*                                 first num_rows entries are filled in with  */
+/*                                 a state having each row.                   */
+/*             OUT    num_rows - The number of distinct rows.                 */
+/*                                                                            */
+/* Operation: Hash each row (packed two transitions to a word) into a root    */
+/*            bitset index. Rows are numbered in the order they are first     */
+/*            seen so the start state and its neighbours keep small ids.      */
+/******************************************************************************/
+int find_distinct_rows(AUTOMATON_TABLE *table,
+                       uint32_t *row_of_state,
+                       long *row_states,
+                       long *num_rows)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = COMPRESS_AUTOMATON_TABLE_OK;
+  int num_generators = table->num_generators;
+  int num_words = (num_generators + 1) / 2;
+  ROOT_BITSET_INDEX *index = NULL;
+  uint64_t *key = NULL;
+  int32_t *row;
+  int64_t value;
+  long ii;
+  int gg;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(table != NULL);
+  assert(row_of_state != NULL);
+  assert(row_states != NULL);
+  assert(num_rows != NULL);
+
+  *num_rows = 0;
+  key = (uint64_t *) malloc(num_words * sizeof(uint64_t));
+  if (key == NULL ||
+      init_root_bitset_index(num_words, &index) != ROOT_BITSET_INDEX_OK)
+  {
+    ret_code = COMPRESS_AUTOMATON_TABLE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  for (ii = 0; ii < table->num_states; ii++)
+  {
+    row = table->transitions + ii * num_generators;
+    memset(key, 0, num_words * sizeof(uint64_t));
+    for (gg = 0; gg < num_generators; gg++)
+    {
+      key[gg / 2] |= ((uint64_t) (uint32_t) row[gg]) << (32 * (gg % 2));
+    }
+
+    if (find_in_root_bitset_index(index, key, &value))
+    {
+      row_of_state[ii] = (uint32_t) value;
+    }
+    else
+    {
+      if (set_in_root_bitset_index(index, key, *num_rows) !=
+                                                          ROOT_BITSET_INDEX_OK)
+      {
+        ret_code = COMPRESS_AUTOMATON_TABLE_MEM_ERR;
+        goto EXIT_LABEL;
+      }
+      row_of_state[ii] = (uint32_t) *num_rows;
+      row_states[*num_rows] = ii;
+      (*num_rows)++;
+    }
+  }
+
+EXIT_LABEL:
+
+  if (index != NULL)
+  {
+    free_root_bitset_index(index);
+  }
+  free(key);
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: reserve_compressed_slots                                         */
+/*                                                                            */
+/* Returns: One of COMPRESS_AUTOMATON_TABLE_RET_CODES.                        */
+/*                                                                            */
+/* Parameters: IN/OUT checks - The owner of each slot.                        */
+/*             IN/OUT next_states - The exception held in each slot.          */
+/*             IN/OUT capacity - The number of slots allocated.               */
+/*             IN     needed - The number of slots which must exist.          */
+/*                                                                            */
+/* Operation: Double the arrays until they hold at least needed slots,        */
+/*            marking every new slot unused.                                  */
+/******************************************************************************/
+int reserve_compressed_slots(uint32_t **checks,
+                             uint32_t **next_states,
+                             long *capacity,
+                             long needed)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = COMPRESS_AUTOMATON_TABLE_OK;
+  long new_capacity = *capacity;
+  uint32_t *new_checks;
+  uint32_t *new_next_states;
+  long ii;
+
+  if (needed <= *capacity)
+  {
+    goto EXIT_LABEL;
+  }
+  while (new_capacity < needed)
+  {
+    new_capacity *= 2;
+  }
+
+  new_checks = (uint32_t *) realloc(*checks, new_capacity * sizeof(uint32_t));
+  if (new_checks == NULL)
+  {
+    ret_code = COMPRESS_AUTOMATON_TABLE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  *checks = new_checks;
+  new_next_states = (uint32_t *) realloc(*next_states,
+                                         new_capacity * sizeof(uint32_t));
+  if (new_next_states == NULL)
+  {
+    ret_code = COMPRESS_AUTOMATON_TABLE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  *next_states = new_next_states;
+
+  for (ii = *capacity; ii < new_capacity; ii++)
+  {
+    (*checks)[ii] = COMPRESSED_EMPTY_SLOT;
+    (*next_states)[ii] = 0;
+  }
+  *capacity = new_capacity;
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: narrow_state_ids                                                 */
+/*                                                                            */
+/* Returns: One of COMPRESS_AUTOMATON_TABLE_RET_CODES.                        */
+/*                                                                            */
+/* Parameters: IN     ids - The state ids to be narrowed.                     */
+/*             IN     num_ids - The number of ids.                            */
+/*             IN     id_width - The number of bytes in each narrowed id.     */
+/*             OUT    narrow_ids - Will be returned holding the ids in an     */
+/*                                 array of uint8_t, uint16_t or uint32_t.    */
+/*                                                                            */
+/* Operation: Copy each id into the narrower array. COMPRESSED_EMPTY_SLOT     */
+/*            becomes the largest value of the narrower type.                 */
+/******************************************************************************/
+int narrow_state_ids(uint32_t *ids,
+                     long num_ids,
+                     int id_width,
+                     void **narrow_ids)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = COMPRESS_AUTOMATON_TABLE_OK;
+  long ii;
+
+  /****************************************************************************/
+  /* Always allocate at least one id so that an automaton with no exceptions  */
+  /* still has arrays.                                                        */
+  /****************************************************************************/
+  *narrow_ids = malloc((num_ids + 1) * id_width);
+  if (*narrow_ids == NULL)
+  {
+    ret_code = COMPRESS_AUTOMATON_TABLE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  for (ii = 0; ii < num_ids; ii++)
+  {
+    if (id_width == sizeof(uint8_t))
+    {
+      ((uint8_t *) *narrow_ids)[ii] = (uint8_t) ids[ii];
+    }
+    else if (id_width == sizeof(uint16_t))
+    {
+      ((uint16_t *) *narrow_ids)[ii] = (uint16_t) ids[ii];
+    }
+    else
+    {
+      ((uint32_t *) *narrow_ids)[ii] = ids[ii];
+    }
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: compress_automaton_table                                         */
+/*                                                                            */
+/* Returns: One of COMPRESS_AUTOMATON_TABLE_RET_CODES.                        */
+/*                                                                            */
+/* Parameters: IN     table - The automaton to be compressed.                 */
+/*             OUT    compressed - Will be returned holding the compressed    */
+/*                                 automaton, which accepts the same words.   */
+/*                                                                            */
+/* Operation: Keep one copy of each distinct row and choose the id width from */
+/*            the number of rows. Then for each row pick its most common      */
+/*            transition as the default and place its exceptions first fit    */
+/*            into the shared slots, fullest rows first as they are the       */
+/*            hardest to place. Finally narrow the ids.                       */
+/******************************************************************************/
+int compress_automaton_table(AUTOMATON_TABLE *table,
+                             COMPRESSED_AUTOMATON **compressed)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = COMPRESS_AUTOMATON_TABLE_OK;
+  int num_generators = table->num_generators;
+  uint32_t *row_of_state = NULL;
+  long *row_states = NULL;
+  long num_rows;
+  uint32_t *targets = NULL;
+  uint32_t *defaults = NULL;
+  int *num_exceptions = NULL;
+  uint32_t *checks = NULL;
+  uint32_t *next_states = NULL;
+  long capacity;
+  long first_free = 0;
+  long base;
+  long *next_base = NULL;
+  unsigned int mask;
+  uint32_t reject_state;
+  uint32_t *row;
+  int best_count;
+  int count;
+  int exceptions;
+  int first_exception;
+  long rr;
+  int gg;
+  int hh;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(table != NULL);
+  assert(compressed != NULL);
+
+  *compressed = (COMPRESSED_AUTOMATON *) malloc(sizeof(COMPRESSED_AUTOMATON));
+  if (*compressed == NULL)
+  {
+    ret_code = COMPRESS_AUTOMATON_TABLE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  (*compressed)->bases = NULL;
+  (*compressed)->defaults = NULL;
+  (*compressed)->checks = NULL;
+  (*compressed)->next_states = NULL;
+
+  /****************************************************************************/
+  /* Keep one copy of each distinct row.                                      */
+  /****************************************************************************/
+  row_of_state = (uint32_t *) malloc(table->num_states * sizeof(uint32_t));
+  row_states = (long *) malloc(table->num_states * sizeof(long));
+  if (row_of_state == NULL || row_states == NULL)
+  {
+    ret_code = COMPRESS_AUTOMATON_TABLE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  ret_code = find_distinct_rows(table, row_of_state, row_states, &num_rows);
+  if (ret_code != COMPRESS_AUTOMATON_TABLE_OK)
+  {
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* Pick the narrowest ids which leave the largest value free for the reject */
+  /* state.                                                                   */
+  /****************************************************************************/
+  if (num_rows < UINT8_MAX)
+  {
+    (*compressed)->id_width = sizeof(uint8_t);
+    reject_state = UINT8_MAX;
+  }
+  else if (num_rows < UINT16_MAX)
+  {
+    (*compressed)->id_width = sizeof(uint16_t);
+    reject_state = UINT16_MAX;
+  }
+  else
+  {
+    (*compressed)->id_width = sizeof(uint32_t);
+    reject_state = UINT32_MAX;
+  }
+  (*compressed)->num_states = num_rows;
+  (*compressed)->num_generators = num_generators;
+  (*compressed)->start_state = row_of_state[table->start_state];
+  (*compressed)->reject_state = reject_state;
+
+  /****************************************************************************/
+  /* Rewrite each distinct row in terms of row ids and choose its default.    */
+  /****************************************************************************/
+  targets = (uint32_t *) malloc(num_rows * num_generators * sizeof(uint32_t));
+  defaults = (uint32_t *) malloc(num_rows * sizeof(uint32_t));
+  num_exceptions = (int *) malloc(num_rows * sizeof(int));
+  (*compressed)->bases = (uint32_t *) malloc(num_rows * sizeof(uint32_t));
+  if (targets == NULL ||
+      defaults == NULL ||
+      num_exceptions == NULL ||
+      (*compressed)->bases == NULL)
+  {
+    ret_code = COMPRESS_AUTOMATON_TABLE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  for (rr = 0; rr < num_rows; rr++)
+  {
+    row = targets + rr * num_generators;
+    for (gg = 0; gg < num_generators; gg++)
+    {
+      if (table->transitions[row_states[rr] * num_generators + gg] ==
+                                                  AUTOMATON_TABLE_REJECT_STATE)
+      {
+        row[gg] = reject_state;
+      }
+      else
+      {
+        row[gg] = row_of_state[table->transitions[row_states[rr] *
+                                                  num_generators + gg]];
+      }
+    }
+
+    best_count = 0;
+    for (gg = 0; gg < num_generators; gg++)
+    {
+      count = 0;
+      for (hh = 0; hh < num_generators; hh++)
+      {
+        if (row[hh] == row[gg])
+        {
+          count++;
+        }
+      }
+      if (count > best_count)
+      {
+        best_count = count;
+        defaults[rr] = row[gg];
+      }
+    }
+    num_exceptions[rr] = num_generators - best_count;
+    (*compressed)->bases[rr] = 0;
+  }
+
+  /****************************************************************************/
+  /* Place the exceptions of each row, those with the most exceptions first.  */
+  /* A row is tried at each base from just before the first unused slot until */
+  /* none of its exceptions land on a used slot. Slots are only ever used up, */
+  /* so once a row is placed at a base no later row with its exceptions on    */
+  /* the same generators can fit any lower, and next_base remembers where to  */
+  /* start for each such set of generators. Without that the search is        */
+  /* quadratic when the unused slots are badly fragmented. Rows with no       */
+  /* exceptions keep base 0 as no slot will ever be checked as theirs.        */
+  /****************************************************************************/
+  capacity = num_generators * 2;
+  checks = (uint32_t *) malloc(capacity * sizeof(uint32_t));
+  next_states = (uint32_t *) malloc(capacity * sizeof(uint32_t));
+  next_base = (long *) calloc((size_t) 1 << num_generators, sizeof(long));
+  if (checks == NULL || next_states == NULL || next_base == NULL)
+  {
+    ret_code = COMPRESS_AUTOMATON_TABLE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  for (rr = 0; rr < capacity; rr++)
+  {
+    checks[rr] = COMPRESSED_EMPTY_SLOT;
+    next_states[rr] = 0;
+  }
+  (*compressed)->num_slots = 0;
+
+  for (exceptions = num_generators; exceptions > 0; exceptions--)
+  {
+    for (rr = 0; rr < num_rows; rr++)
+    {
+      if (num_exceptions[rr] != exceptions)
+      {
+        continue;
+      }
+      row = targets + rr * num_generators;
+      first_exception = 0;
+      while (row[first_exception] == defaults[rr])
+      {
+        first_exception++;
+      }
+      mask = 0;
+      for (gg = first_exception; gg < num_generators; gg++)
+      {
+        if (row[gg] != defaults[rr])
+        {
+          mask |= 1u << gg;
+        }
+      }
+
+      base = (first_free > first_exception) ? first_free - first_exception : 0;
+      if (next_base[mask] > base)
+      {
+        base = next_base[mask];
+      }
+      while (true)
+      {
+        ret_code = reserve_compressed_slots(&checks,
+                                            &next_states,
+                                            &capacity,
+                                            base + num_generators);
+        if (ret_code != COMPRESS_AUTOMATON_TABLE_OK)
+        {
+          goto EXIT_LABEL;
+        }
+        for (gg = first_exception; gg < num_generators; gg++)
+        {
+          if (row[gg] != defaults[rr] &&
+              checks[base + gg] != COMPRESSED_EMPTY_SLOT)
+          {
+            break;
+          }
+        }
+        if (gg == num_generators)
+        {
+          break;
+        }
+        base++;
+      }
+
+      (*compressed)->bases[rr] = (uint32_t) base;
+      next_base[mask] = base + 1;
+      for (gg = first_exception; gg < num_generators; gg++)
+      {
+        if (row[gg] != defaults[rr])
+        {
+          checks[base + gg] = (uint32_t) rr;
+          next_states[base + gg] = row[gg];
+          if (base + gg >= (*compressed)->num_slots)
+          {
+            (*compressed)->num_slots = base + gg + 1;
+          }
+        }
+      }
+      while (first_free < capacity &&
+             checks[first_free] != COMPRESSED_EMPTY_SLOT)
+      {
+        first_free++;
+      }
+    }
+  }
+
+  /****************************************************************************/
+  /* Every lookup reads slot bases[s] + g, so make sure the slots run at      */
+  /* least that far.                                                          */
+  /****************************************************************************/
+  for (rr = 0; rr < num_rows; rr++)
+  {
+    if ((*compressed)->bases[rr] + num_generators > (*compressed)->num_slots)
+    {
+      (*compressed)->num_slots = (*compressed)->bases[rr] + num_generators;
+    }
+  }
+  ret_code = reserve_compressed_slots(&checks,
+                                      &next_states,
+                                      &capacity,
+                                      (*compressed)->num_slots);
+  if (ret_code != COMPRESS_AUTOMATON_TABLE_OK)
+  {
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* Narrow the ids. Unused slots become the reject state, which is never a   */
+  /* row id so never matches a check.                                         */
+  /****************************************************************************/
+  for (rr = 0; rr < (*compressed)->num_slots; rr++)
+  {
+    if (checks[rr] == COMPRESSED_EMPTY_SLOT)
+    {
+      checks[rr] = reject_state;
+    }
+  }
+  ret_code = narrow_state_ids(defaults,
+                              num_rows,
+                              (*compressed)->id_width,
+                              &((*compressed)->defaults));
+  if (ret_code == COMPRESS_AUTOMATON_TABLE_OK)
+  {
+    ret_code = narrow_state_ids(checks,
+                                (*compressed)->num_slots,
+                                (*compressed)->id_width,
+                                &((*compressed)->checks));
+  }
+  if (ret_code == COMPRESS_AUTOMATON_TABLE_OK)
+  {
+    ret_code = narrow_state_ids(next_states,
+                                (*compressed)->num_slots,
+                                (*compressed)->id_width,
+                                &((*compressed)->next_states));
+  }
+
+EXIT_LABEL:
+
+  if (ret_code != COMPRESS_AUTOMATON_TABLE_OK && *compressed != NULL)
+  {
+    free_compressed_automaton(*compressed);
+    *compressed = NULL;
+  }
+  free(row_of_state);
+  free(row_states);
+  free(targets);
+  free(defaults);
+  free(num_exceptions);
+  free(checks);
+  free(next_states);
+  free(next_base);
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: free_compressed_automaton                                        */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     compressed - The automaton to be freed.                 */
+/*                                                                            */
+/* Operation: Free each of the arrays and then the structure itself.          */
+/******************************************************************************/
+void free_compressed_automaton(COMPRESSED_AUTOMATON *compressed)
+{
+  assert(compressed != NULL);
+
+  free(compressed->bases);
+  free(compressed->defaults);
+  free(compressed->checks);
+  free(compressed->next_states);
+  free(compressed);
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: compressed_automaton_size                                        */
+/*                                                                            */
+/* Returns: The number of bytes the transitions of the automaton take up.     */
+/*                                                                            */
+/* Parameters: IN     compressed - The automaton to be measured.              */
+/*                                                                            */
+/* Operation: Add up the sizes of the arrays.                                 */
+/******************************************************************************/
+size_t compressed_automaton_size(COMPRESSED_AUTOMATON *compressed)
+{
+  assert(compressed != NULL);
+
+  return(compressed->num_states * (sizeof(uint32_t) + compressed->id_width) +
+         compressed->num_slots * 2 * compressed->id_width);
+}
+
+/******************************************************************************/
+/* Function: compressed_next_state                                            */
+/*                                                                            */
+/* Returns: The state reached by reading the generator from the state, or the */
+/*          reject state of the automaton.                                    */
+/*                                                                            */
+/* Parameters: IN     compressed - The automaton.                             */
+/*             IN     state - The current state.                              */
+/*             IN     generator - The generator being read.                   */
+/*                                                                            */
+/* Operation: Look at the slot for the generator in the state's row and use   */
+/*            it if the state owns it, otherwise use the state's default.     */
+/******************************************************************************/
+uint32_t compressed_next_state(COMPRESSED_AUTOMATON *compressed,
+                               uint32_t state,
+                               int generator)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  uint32_t slot = compressed->bases[state] + generator;
+  uint32_t next_state;
+
+  if (compressed->id_width == sizeof(uint8_t))
+  {
+    next_state = (((uint8_t *) compressed->checks)[slot] == state) ?
+                                  ((uint8_t *) compressed->next_states)[slot] :
+                                  ((uint8_t *) compressed->defaults)[state];
+  }
+  else if (compressed->id_width == sizeof(uint16_t))
+  {
+    next_state = (((uint16_t *) compressed->checks)[slot] == state) ?
+                                 ((uint16_t *) compressed->next_states)[slot] :
+                                 ((uint16_t *) compressed->defaults)[state];
+  }
+  else
+  {
+    next_state = (((uint32_t *) compressed->checks)[slot] == state) ?
+                                 ((uint32_t *) compressed->next_states)[slot] :
+                                 ((uint32_t *) compressed->defaults)[state];
+  }
+
+  return(next_state);
+}
+
+/******************************************************************************/
+/* Function: scan_compressed_uint8                                            */
+/*                                                                            */
+/* Returns: The index of the letter at which the word stopped being reduced,  */
+/*          or finish_index if it is reduced.                                 */
+/*                                                                            */
+/* Parameters: IN     compressed - The automaton, which has 1 byte ids.       */
+/*             IN     word - The word to be read.                             */
+/*             IN     start_index - The first letter to be read.              */
+/*             IN     finish_index - One past the last letter to be read.     */
+/*             IN     direction - SEARCH_FORWARDS or SEARCH_BACKWARDS.        */
+/*                                                                            */
+/* Operation: Follow the word through the automaton. The id width is fixed    */
+/*            so the only test in the loop apart from the reject state is the */
+/*            check, which compilers turn into a conditional move.            */
+/******************************************************************************/
+int scan_compressed_uint8(COMPRESSED_AUTOMATON *compressed,
+                          char *word,
+                          int start_index,
+                          int finish_index,
+                          int direction)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  uint32_t *bases = compressed->bases;
+  uint8_t *defaults = (uint8_t *) compressed->defaults;
+  uint8_t *checks = (uint8_t *) compressed->checks;
+  uint8_t *next_states = (uint8_t *) compressed->next_states;
+  uint8_t reject_state = (uint8_t) compressed->reject_state;
+  uint8_t curr = (uint8_t) compressed->start_state;
+  uint32_t slot;
+  int ii;
+
+  for (ii = start_index; ii != finish_index; ii += direction)
+  {
+    slot = bases[curr] + (uint32_t) (word[ii] - ASCII_LOWER_A);
+    curr = (checks[slot] == curr) ? next_states[slot] : defaults[curr];
+    if (curr == reject_state)
+    {
+      break;
+    }
+  }
+
+  return(ii);
+}
+
+/******************************************************************************/
+/* Function: scan_compressed_uint16                                           */
+/*                                                                            */
+/* Returns: The same as scan_compressed_uint8.                                */
+/*                                                                            */
+/* Parameters: The same as scan_compressed_uint8 but the automaton has 2 byte */
+/*             ids.                                                           */
+/*                                                                            */
+/* Operation: The same as scan_compressed_uint8.                              */
+/******************************************************************************/
+int scan_compressed_uint16(COMPRESSED_AUTOMATON *compressed,
+                           char *word,
+                           int start_index,
+                           int finish_index,
+                           int direction)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  uint32_t *bases = compressed->bases;
+  uint16_t *defaults = (uint16_t *) compressed->defaults;
+  uint16_t *checks = (uint16_t *) compressed->checks;
+  uint16_t *next_states = (uint16_t *) compressed->next_states;
+  uint16_t reject_state = (uint16_t) compressed->reject_state;
+  uint16_t curr = (uint16_t) compressed->start_state;
+  uint32_t slot;
+  int ii;
+
+  for (ii = start_index; ii != finish_index; ii += direction)
+  {
+    slot = bases[curr] + (uint32_t) (word[ii] - ASCII_LOWER_A);
+    curr = (checks[slot] == curr) ? next_states[slot] : defaults[curr];
+    if (curr == reject_state)
+    {
+      break;
+    }
+  }
+
+  return(ii);
+}
+
+/******************************************************************************/
+/* Function: scan_compressed_uint32                                           */
+/*                                                                            */
+/* Returns: The same as scan_compressed_uint8.                                */
+/*                                                                            */
+/* Parameters: The same as scan_compressed_uint8 but the automaton has 4 byte */
+/*             ids.                                                           */
+/*                                                                            */
+/* Operation: The same as scan_compressed_uint8.                              */
+/******************************************************************************/
+int scan_compressed_uint32(COMPRESSED_AUTOMATON *compressed,
+                           char *word,
+                           int start_index,
+                           int finish_index,
+                           int direction)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  uint32_t *bases = compressed->bases;
+  uint32_t *defaults = (uint32_t *) compressed->defaults;
+  uint32_t *checks = (uint32_t *) compressed->checks;
+  uint32_t *next_states = (uint32_t *) compressed->next_states;
+  uint32_t reject_state = compressed->reject_state;
+  uint32_t curr = compressed->start_state;
+  uint32_t slot;
+  int ii;
+
+  for (ii = start_index; ii != finish_index; ii += direction)
+  {
+    slot = bases[curr] + (uint32_t) (word[ii] - ASCII_LOWER_A);
+    curr = (checks[slot] == curr) ? next_states[slot] : defaults[curr];
+    if (curr == reject_state)
+    {
+      break;
+    }
+  }
+
+  return(ii);
+}
+
+/******************************************************************************/
+/* Function: is_reduced_compressed                                            */
+/*                                                                            */
+/* Returns: true if the word is reduced and false otherwise.                  */
+/*                                                                            */
+/* Parameters: IN     compressed - The compressed automaton.                  */
+/*             IN     word - A string consisting of a number of letters which */
+/*                           correspond to generators in the group.           */
+/*             OUT    fail_index - The index in the word that the word was no */
+/*                                 longer reduced. 0 if the word was reduced. */
+/*             IN     start_index - The first letter to be read.              */
+/*             IN     finish_index - One past the last letter to be read. If  */
+/*                                   this is less than start_index then the   */
+/*                                   word is read from right to left.         */
+/*                                                                            */
+/* Operation: The same as is_reduced_table. The id width is looked at once    */
+/*            and the word handed to the scan for that width.                 */
+/******************************************************************************/
+bool is_reduced_compressed(COMPRESSED_AUTOMATON *compressed,
+                           char *word,
+                           int *fail_index,
+                           int start_index,
+                           int finish_index)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  bool reduced = true;
+  int direction;
+  int ii = start_index;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(compressed != NULL);
+  assert(word != NULL);
+
+  /****************************************************************************/
+  /* Work out which way through the word we are going.                        */
+  /****************************************************************************/
+  if (finish_index > start_index)
+  {
+    direction = SEARCH_FORWARDS;
+  }
+  else if (finish_index < start_index)
+  {
+    direction = SEARCH_BACKWARDS;
+  }
+  else
+  {
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* The scan stops early only if the reject state is reached.                */
+  /****************************************************************************/
+  if (compressed->id_width == sizeof(uint8_t))
+  {
+    ii = scan_compressed_uint8(compressed,
+                               word,
+                               start_index,
+                               finish_index,
+                               direction);
+  }
+  else if (compressed->id_width == sizeof(uint16_t))
+  {
+    ii = scan_compressed_uint16(compressed,
+                                word,
+                                start_index,
+                                finish_index,
+                                direction);
+  }
+  else
+  {
+    ii = scan_compressed_uint32(compressed,
+                                word,
+                                start_index,
+                                finish_index,
+                                direction);
+  }
+
+  reduced = (ii == finish_index);
+
+EXIT_LABEL:
+
+  if (reduced == false)
+  {
+    *fail_index = ii;
+  }
+  else
+  {
+    *fail_index = 0;
+  }
+
+  return(reduced);
+}
@@ -0,0 +1,45 @@
+/******************************************************************************/
+/* Group: COMPRESS_AUTOMATON_TABLE_RET_CODES                                  */
+/*                                                                            */
+/* The return codes for function compress_automaton_table.                    */
+/******************************************************************************/
+#define COMPRESS_AUTOMATON_TABLE_OK      0
+#define COMPRESS_AUTOMATON_TABLE_MEM_ERR 1
+
+/******************************************************************************/
+/* The value held in an unused slot of the check array of a compressed        */
+/* automaton before the ids are narrowed. It is never a row id.               */
+/******************************************************************************/
+#define COMPRESSED_EMPTY_SLOT UINT32_MAX
+
+/******************************************************************************/
+/* This structure is a compressed form of AUTOMATON_TABLE.                    */
+/* Rows: States with identical transition rows accept the same words (every   */
+/*       state accepts) so each distinct row is kept once and the states are  */
+/*       renumbered by row.                                                   */
+/* Default plus exceptions: Each row keeps the transition it has most often   */
+/*       as its default. The other transitions, the exceptions, are packed    */
+/*       into the shared next_states array with the rows overlapping wherever */
+/*       their exceptions don't collide. The exception for state s on         */
+/*       generator g is in slot bases[s] + g and checks[slot] is s exactly    */
+/*       when the slot holds one of s's exceptions, so                        */
+/*         next = (checks[slot] == s) ? next_states[slot] : defaults[s]       */
+/*       is a lookup of fixed cost.                                           */
+/* Narrow ids: defaults, checks and next_states hold state ids which are      */
+/*       id_width bytes wide (1, 2 or 4), the smallest which can hold every   */
+/*       row id and the reject state. The reject state is the largest value   */
+/*       of that width, which is also what an unused slot of checks holds.    */
+/******************************************************************************/
+typedef struct compressed_automaton
+{
+  long num_states;
+  int num_generators;
+  int id_width;
+  uint32_t start_state;
+  uint32_t reject_state;
+  long num_slots;
+  uint32_t *bases;
+  void *defaults;
+  void *checks;
+  void *next_states;
+} COMPRESSED_AUTOMATON;
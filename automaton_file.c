@@ -0,0 +1,486 @@
+#include "cox_prot.h"
+
+/******************************************************************************/
+/* Function: align_automaton_file_offset                                      */
+/*                                                                            */
+/* Returns: The offset rounded up to a multiple of AUTOMATON_FILE_ALIGNMENT.  */
+/*                                                                            */
+/* Parameters: IN     offset - The offset to be rounded.                      */
+/*                                                                            */
+/* Operation: Round up.                                                       */
+/******************************************************************************/
+uint64_t align_automaton_file_offset(uint64_t offset)
+{
+  return((offset + AUTOMATON_FILE_ALIGNMENT - 1) /
+         AUTOMATON_FILE_ALIGNMENT *
+         AUTOMATON_FILE_ALIGNMENT);
+}
+
+/******************************************************************************/
+/* Function: write_automaton_file_padding                                     */
+/*                                                                            */
+/* Returns: One of SAVE_AUTOMATON_FILE_RET_CODES.                             */
+/*                                                                            */
+/* Parameters: IN     automaton_file - The file being written.                */
+/*             IN     offset - The number of bytes written so far.            */
+/*                                                                            */
+/* Operation: Write zeros up to the start of the next section.                */
+/******************************************************************************/
+int write_automaton_file_padding(FILE *automaton_file, uint64_t offset)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = SAVE_AUTOMATON_FILE_OK;
+  char padding[AUTOMATON_FILE_ALIGNMENT];
+  size_t padding_size;
+
+  memset(padding, 0, sizeof(padding));
+  padding_size = (size_t) (align_automaton_file_offset(offset) - offset);
+  if (padding_size > 0 &&
+      fwrite(padding, 1, padding_size, automaton_file) != padding_size)
+  {
+    ret_code = SAVE_AUTOMATON_FILE_FILE_ERR;
+  }
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: save_automaton_file                                              */
+/*                                                                            */
+/* Returns: One of SAVE_AUTOMATON_FILE_RET_CODES.                             */
+/*                                                                            */
+/* Parameters: IN     filename - The file to save the automaton in.           */
+/*             IN     table - The automaton to be saved.                      */
+/*             IN     matrix_data - Precalculated information about the group.*/
+/*             IN     minimal_root_table - The minimal roots of the group, or */
+/*                                         NULL if they aren't to be saved.   */
+/*                                                                            */
+/* Operation: Work out where each section goes, then write the header and     */
+/*            the sections with padding between them. The file is written     */
+/*            under a temporary name and renamed into place so that a process */
+/*            mapping it never sees half a file.                              */
+/******************************************************************************/
+int save_automaton_file(char *filename,
+                        AUTOMATON_TABLE *table,
+                        MATRIX_DATA *matrix_data,
+                        ROOT_TABLE *minimal_root_table)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = SAVE_AUTOMATON_FILE_OK;
+  int num_generators = table->num_generators;
+  AUTOMATON_FILE_HEADER header;
+  FILE *automaton_file = NULL;
+  char *temp_filename = NULL;
+  ROOT_TABLE_ELEMENT *current_element;
+  size_t num_transitions;
+  int64_t entry;
+  int ii;
+  int jj;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(filename != NULL);
+  assert(table != NULL);
+  assert(matrix_data != NULL);
+
+  /****************************************************************************/
+  /* Lay out the file.                                                        */
+  /****************************************************************************/
+  memset(&header, 0, sizeof(header));
+  strncpy(header.magic, AUTOMATON_FILE_MAGIC, sizeof(header.magic));
+  header.endian_tag = AUTOMATON_FILE_ENDIAN_TAG;
+  header.version = AUTOMATON_FILE_VERSION;
+  header.num_generators = num_generators;
+  header.start_state = table->start_state;
+  header.num_states = table->num_states;
+  num_transitions = (size_t) table->num_states * num_generators;
+
+  header.matrix_offset = align_automaton_file_offset(sizeof(header));
+  header.transitions_offset = align_automaton_file_offset(
+                                          header.matrix_offset +
+                                          num_generators * num_generators *
+                                          sizeof(int64_t));
+  header.file_size = header.transitions_offset +
+                     num_transitions * sizeof(int32_t);
+  if (minimal_root_table != NULL)
+  {
+    header.num_minimal_roots = minimal_root_table->length;
+    header.minimal_roots_offset = align_automaton_file_offset(
+                                                             header.file_size);
+    header.file_size = header.minimal_roots_offset +
+                       header.num_minimal_roots *
+                       num_generators *
+                       sizeof(double);
+  }
+
+  temp_filename = (char *) malloc(strlen(filename) + 5);
+  if (temp_filename == NULL)
+  {
+    ret_code = SAVE_AUTOMATON_FILE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  sprintf(temp_filename, "%s.tmp", filename);
+  automaton_file = fopen(temp_filename, "wb");
+  if (automaton_file == NULL)
+  {
+    ret_code = SAVE_AUTOMATON_FILE_FILE_ERR;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* The header and the Coxeter matrix.                                       */
+  /****************************************************************************/
+  if (fwrite(&header, sizeof(header), 1, automaton_file) != 1 ||
+      write_automaton_file_padding(automaton_file, sizeof(header)) !=
+                                                        SAVE_AUTOMATON_FILE_OK)
+  {
+    ret_code = SAVE_AUTOMATON_FILE_FILE_ERR;
+    goto EXIT_LABEL;
+  }
+  for (ii = 0; ii < num_generators; ii++)
+  {
+    for (jj = 0; jj < num_generators; jj++)
+    {
+      entry = matrix_data->coxeter_matrix[ii][jj];
+      if (fwrite(&entry, sizeof(entry), 1, automaton_file) != 1)
+      {
+        ret_code = SAVE_AUTOMATON_FILE_FILE_ERR;
+        goto EXIT_LABEL;
+      }
+    }
+  }
+
+  /****************************************************************************/
+  /* The transition table.                                                    */
+  /****************************************************************************/
+  if (write_automaton_file_padding(automaton_file,
+                                   header.matrix_offset +
+                                   num_generators * num_generators *
+                                   sizeof(int64_t)) !=
+                                                      SAVE_AUTOMATON_FILE_OK ||
+      fwrite(table->transitions,
+             sizeof(int32_t),
+             num_transitions,
+             automaton_file) != num_transitions)
+  {
+    ret_code = SAVE_AUTOMATON_FILE_FILE_ERR;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* The minimal roots if they were asked for.                                */
+  /****************************************************************************/
+  if (minimal_root_table != NULL)
+  {
+    if (write_automaton_file_padding(automaton_file,
+                                     header.transitions_offset +
+                                     num_transitions * sizeof(int32_t)) !=
+                                                        SAVE_AUTOMATON_FILE_OK)
+    {
+      ret_code = SAVE_AUTOMATON_FILE_FILE_ERR;
+      goto EXIT_LABEL;
+    }
+    for (current_element = minimal_root_table->first;
+         current_element != NULL;
+         current_element = current_element->next)
+    {
+      if (fwrite(current_element->root->coefficients,
+                 sizeof(double),
+                 num_generators,
+                 automaton_file) != (size_t) num_generators)
+      {
+        ret_code = SAVE_AUTOMATON_FILE_FILE_ERR;
+        goto EXIT_LABEL;
+      }
+    }
+  }
+
+  ret_code = (fclose(automaton_file) == 0) ?
+                       SAVE_AUTOMATON_FILE_OK : SAVE_AUTOMATON_FILE_FILE_ERR;
+  automaton_file = NULL;
+  if (ret_code == SAVE_AUTOMATON_FILE_OK &&
+      rename(temp_filename, filename) != 0)
+  {
+    ret_code = SAVE_AUTOMATON_FILE_FILE_ERR;
+  }
+
+EXIT_LABEL:
+
+  if (automaton_file != NULL)
+  {
+    fclose(automaton_file);
+  }
+  if (ret_code != SAVE_AUTOMATON_FILE_OK && temp_filename != NULL)
+  {
+    remove(temp_filename);
+  }
+  free(temp_filename);
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: map_automaton_file                                               */
+/*                                                                            */
+/* Returns: One of MAP_AUTOMATON_FILE_RET_CODES.                              */
+/*                                                                            */
+/* Parameters: IN     filename - A file written by save_automaton_file.       */
+/*             OUT    mapped - Will be returned holding the mapped file.      */
+/*                                                                            */
+/* Operation: Map the whole file read only and check the header: the magic,   */
+/*            byte order, version, sizes and that every section lies inside   */
+/*            the file. Nothing else is read, so loading takes the same time  */
+/*            however big the automaton is and pages of the table are only    */
+/*            brought in as words use them. The transitions themselves aren't */
+/*            checked, so a damaged or hostile file can send a scan outside   */
+/*            the table. Call automaton_file_transitions_valid before using a */
+/*            file which isn't trusted.                                       */
+/******************************************************************************/
+int map_automaton_file(char *filename, MAPPED_AUTOMATON **mapped)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = MAP_AUTOMATON_FILE_OK;
+  int file_descriptor;
+  struct stat file_status;
+  const AUTOMATON_FILE_HEADER *header;
+  uint64_t transitions_size;
+  uint64_t matrix_size;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(filename != NULL);
+  assert(mapped != NULL);
+
+  *mapped = (MAPPED_AUTOMATON *) malloc(sizeof(MAPPED_AUTOMATON));
+  if (*mapped == NULL)
+  {
+    ret_code = MAP_AUTOMATON_FILE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  (*mapped)->mapping = MAP_FAILED;
+
+  file_descriptor = open(filename, O_RDONLY);
+  if (file_descriptor < 0)
+  {
+    ret_code = MAP_AUTOMATON_FILE_FILE_ERR;
+    goto EXIT_LABEL;
+  }
+  if (fstat(file_descriptor, &file_status) != 0 ||
+      (size_t) file_status.st_size < sizeof(AUTOMATON_FILE_HEADER))
+  {
+    close(file_descriptor);
+    ret_code = MAP_AUTOMATON_FILE_BAD_FORMAT;
+    goto EXIT_LABEL;
+  }
+  (*mapped)->mapping_size = (size_t) file_status.st_size;
+  (*mapped)->mapping = mmap(NULL,
+                            (*mapped)->mapping_size,
+                            PROT_READ,
+                            MAP_SHARED,
+                            file_descriptor,
+                            0);
+  close(file_descriptor);
+  if ((*mapped)->mapping == MAP_FAILED)
+  {
+    ret_code = MAP_AUTOMATON_FILE_FILE_ERR;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* Check the header.                                                        */
+  /****************************************************************************/
+  header = (const AUTOMATON_FILE_HEADER *) (*mapped)->mapping;
+  if (memcmp(header->magic, AUTOMATON_FILE_MAGIC, sizeof(header->magic)) != 0)
+  {
+    ret_code = MAP_AUTOMATON_FILE_BAD_FORMAT;
+    goto EXIT_LABEL;
+  }
+  if (header->endian_tag != AUTOMATON_FILE_ENDIAN_TAG)
+  {
+    ret_code = MAP_AUTOMATON_FILE_WRONG_ENDIAN;
+    goto EXIT_LABEL;
+  }
+  if (header->version != AUTOMATON_FILE_VERSION)
+  {
+    ret_code = MAP_AUTOMATON_FILE_WRONG_VERSION;
+    goto EXIT_LABEL;
+  }
+
+  matrix_size = (uint64_t) header->num_generators *
+                header->num_generators *
+                sizeof(int64_t);
+  transitions_size = (uint64_t) header->num_states *
+                     header->num_generators *
+                     sizeof(int32_t);
+  if (header->num_generators <= 0 ||
+      header->num_generators > MAX_GENERATORS ||
+      header->num_states <= 0 ||
+      header->num_states > INT32_MAX ||
+      header->start_state < 0 ||
+      header->start_state >= header->num_states ||
+      header->file_size != (*mapped)->mapping_size ||
+      header->matrix_offset % AUTOMATON_FILE_ALIGNMENT != 0 ||
+      header->matrix_offset < sizeof(AUTOMATON_FILE_HEADER) ||
+      header->matrix_offset + matrix_size > header->file_size ||
+      header->transitions_offset % AUTOMATON_FILE_ALIGNMENT != 0 ||
+      header->transitions_offset < header->matrix_offset + matrix_size ||
+      header->transitions_offset + transitions_size > header->file_size ||
+      header->minimal_roots_offset % AUTOMATON_FILE_ALIGNMENT != 0 ||
+      (header->minimal_roots_offset != 0 &&
+       (header->minimal_roots_offset <
+                           header->transitions_offset + transitions_size ||
+        header->num_minimal_roots >
+                           header->file_size / sizeof(double) ||
+        header->minimal_roots_offset +
+        header->num_minimal_roots * header->num_generators * sizeof(double) >
+                                                           header->file_size)))
+  {
+    ret_code = MAP_AUTOMATON_FILE_BAD_FORMAT;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* Point everything into the mapping.                                       */
+  /****************************************************************************/
+  (*mapped)->header = header;
+  (*mapped)->coxeter_matrix = (const int64_t *)
+                    ((const char *) (*mapped)->mapping + header->matrix_offset);
+  (*mapped)->minimal_roots = (header->minimal_roots_offset == 0) ? NULL :
+             (const double *)
+             ((const char *) (*mapped)->mapping + header->minimal_roots_offset);
+  (*mapped)->table.num_states = (long) header->num_states;
+  (*mapped)->table.num_generators = header->num_generators;
+  (*mapped)->table.start_state = header->start_state;
+  (*mapped)->table.transitions = (int32_t *)
+               ((char *) (*mapped)->mapping + header->transitions_offset);
+
+EXIT_LABEL:
+
+  if (ret_code != MAP_AUTOMATON_FILE_OK && *mapped != NULL)
+  {
+    unmap_automaton_file(*mapped);
+    *mapped = NULL;
+  }
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: unmap_automaton_file                                             */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     mapped - The mapped file to be released.                */
+/*                                                                            */
+/* Operation: Unmap the file and free the structure.                          */
+/******************************************************************************/
+void unmap_automaton_file(MAPPED_AUTOMATON *mapped)
+{
+  assert(mapped != NULL);
+
+  if (mapped->mapping != MAP_FAILED)
+  {
+    munmap(mapped->mapping, mapped->mapping_size);
+  }
+  free(mapped);
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: automaton_file_matches_group                                     */
+/*                                                                            */
+/* Returns: true if the mapped automaton was saved for the group and false    */
+/*          otherwise.                                                        */
+/*                                                                            */
+/* Parameters: IN     mapped - The mapped automaton file.                     */
+/*             IN     matrix_data - Precalculated information about the group.*/
+/*             IN     num_generators - The number of group generators.        */
+/*                                                                            */
+/* Operation: Compare the saved Coxeter matrix with the group's.              */
+/******************************************************************************/
+bool automaton_file_matches_group(MAPPED_AUTOMATON *mapped,
+                                  MATRIX_DATA *matrix_data,
+                                  int num_generators)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  bool result = true;
+  int ii;
+  int jj;
+
+  assert(mapped != NULL);
+  assert(matrix_data != NULL);
+
+  if (mapped->header->num_generators != num_generators)
+  {
+    result = false;
+    goto EXIT_LABEL;
+  }
+  for (ii = 0; ii < num_generators; ii++)
+  {
+    for (jj = 0; jj < num_generators; jj++)
+    {
+      if (mapped->coxeter_matrix[ii * num_generators + jj] !=
+                                           matrix_data->coxeter_matrix[ii][jj])
+      {
+        result = false;
+        goto EXIT_LABEL;
+      }
+    }
+  }
+
+EXIT_LABEL:
+
+  return(result);
+}
+
+/******************************************************************************/
+/* Function: automaton_file_transitions_valid                                 */
+/*                                                                            */
+/* Returns: true if every transition of the mapped automaton is a state of it */
+/*          or the reject state, and false otherwise.                         */
+/*                                                                            */
+/* Parameters: IN     mapped - The mapped automaton file.                     */
+/*                                                                            */
+/* Operation: Read the whole transition table once. This brings every page of */
+/*            it in, which map_automaton_file avoids, so it is only done when */
+/*            asked for.                                                      */
+/******************************************************************************/
+bool automaton_file_transitions_valid(MAPPED_AUTOMATON *mapped)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  bool result = true;
+  const int32_t *transitions;
+  long num_entries;
+  long ii;
+
+  assert(mapped != NULL);
+
+  transitions = mapped->table.transitions;
+  num_entries = mapped->table.num_states * mapped->table.num_generators;
+  for (ii = 0; ii < num_entries; ii++)
+  {
+    if (transitions[ii] < AUTOMATON_TABLE_REJECT_STATE ||
+        transitions[ii] >= mapped->table.num_states)
+    {
+      result = false;
+      goto EXIT_LABEL;
+    }
+  }
+
+EXIT_LABEL:
+
+  return(result);
+}
@@ -0,0 +1,89 @@
+/******************************************************************************/
+/* The first eight bytes of every automaton file.                             */
+/******************************************************************************/
+#define AUTOMATON_FILE_MAGIC "COXAUTM"
+
+/******************************************************************************/
+/* Written in the byte order of the machine which saved the file. A machine   */
+/* of the other byte order reads it back as 0x04030201.                       */
+/******************************************************************************/
+#define AUTOMATON_FILE_ENDIAN_TAG 0x01020304
+
+/******************************************************************************/
+/* The version of the file layout. Bump this whenever the header or the       */
+/* sections change.                                                           */
+/******************************************************************************/
+#define AUTOMATON_FILE_VERSION 1
+
+/******************************************************************************/
+/* Every section of the file starts on a multiple of this many bytes, so that */
+/* each array is aligned for its type and starts on a cache line once the     */
+/* file is mapped.                                                            */
+/******************************************************************************/
+#define AUTOMATON_FILE_ALIGNMENT 64
+
+/******************************************************************************/
+/* Group: SAVE_AUTOMATON_FILE_RET_CODES                                       */
+/*                                                                            */
+/* The return codes for functions save_automaton_file and                     */
+/* write_automaton_file_padding.                                              */
+/******************************************************************************/
+#define SAVE_AUTOMATON_FILE_OK       0
+#define SAVE_AUTOMATON_FILE_MEM_ERR  1
+#define SAVE_AUTOMATON_FILE_FILE_ERR 2
+
+/******************************************************************************/
+/* Group: MAP_AUTOMATON_FILE_RET_CODES                                        */
+/*                                                                            */
+/* The return codes for function map_automaton_file.                          */
+/******************************************************************************/
+#define MAP_AUTOMATON_FILE_OK            0
+#define MAP_AUTOMATON_FILE_MEM_ERR       1
+#define MAP_AUTOMATON_FILE_FILE_ERR      2
+#define MAP_AUTOMATON_FILE_BAD_FORMAT    3
+#define MAP_AUTOMATON_FILE_WRONG_ENDIAN  4
+#define MAP_AUTOMATON_FILE_WRONG_VERSION 5
+
+/******************************************************************************/
+/* This structure is the header at the start of an automaton file. It is      */
+/* followed by these sections, each starting at the given offset:             */
+/* matrix - The Coxeter matrix as num_generators * num_generators int64_t.    */
+/* transitions - The transition table as num_states * num_generators int32_t  */
+/*               laid out as in AUTOMATON_TABLE.                              */
+/* minimal roots - Optional. The coefficients of each minimal root as         */
+/*                 num_generators doubles, in the order of the minimal root   */
+/*                 table. The offset is 0 if they weren't saved.              */
+/* Every field has a fixed size so that the header can be used in place once  */
+/* the file is mapped.                                                        */
+/******************************************************************************/
+typedef struct automaton_file_header
+{
+  char magic[8];
+  uint32_t endian_tag;
+  uint32_t version;
+  int32_t num_generators;
+  int32_t start_state;
+  int64_t num_states;
+  uint64_t matrix_offset;
+  uint64_t transitions_offset;
+  uint64_t num_minimal_roots;
+  uint64_t minimal_roots_offset;
+  uint64_t file_size;
+} AUTOMATON_FILE_HEADER;
+
+/******************************************************************************/
+/* This structure is an automaton file mapped read only into memory. Every    */
+/* pointer points into the mapping, so nothing is copied and processes which  */
+/* map the same file share one copy of it in the page cache. The table can be */
+/* used like any other AUTOMATON_TABLE for checking words but must never be   */
+/* written to or passed to free_automaton_table.                              */
+/******************************************************************************/
+typedef struct mapped_automaton
+{
+  void *mapping;
+  size_t mapping_size;
+  const AUTOMATON_FILE_HEADER *header;
+  const int64_t *coxeter_matrix;
+  const double *minimal_roots;
+  AUTOMATON_TABLE table;
+} MAPPED_AUTOMATON;
@@ -36,11 +36,68 @@ int create_state(int num_generators, AUTOMATON_STATE **state)
     ret_code = CREATE_STATE_MEM_ERR;
     goto EXIT_LABEL;
   }
+  (*state)->transition_known = (bool *) calloc(num_generators, sizeof(bool));
+  if ((*state)->transition_known == NULL)
+  {
+    ret_code = CREATE_STATE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
   
   /****************************************************************************/
-  /* Set the root table to initially be NULL.                                 */
+  /* Set the root table to initially be NULL. The state is not numbered until */
+  /* the tree is compiled.                                                    */
   /****************************************************************************/
   (*state)->root_table = NULL;
+  (*state)->state_id = -1;
+  
+EXIT_LABEL:
+  
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: create_start_state                                               */
+/*                                                                            */
+/* Returns: One of CREATE_STATE_RET_CODES.                                    */
+/*                                                                            */
+/* Parameters: IN    num_generators - The number of generators used in the    */
+/*                                    group.                                  */
+/*             OUT   state - A pointer to the start state being created.      */
+/*                                                                            */
+/* Operation: Create a state and manually give it an empty root table, which  */
+/*            corresponds to the empty word.                                  */
+/******************************************************************************/
+int create_start_state(int num_generators, AUTOMATON_STATE **state)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = CREATE_STATE_OK;
+  int ret_val;
+  ROOT_TABLE *empty_root_table;
+  
+  /****************************************************************************/
+  /* Create the state itself.                                                 */
+  /****************************************************************************/
+  ret_val = create_state(num_generators, state);
+  if (ret_val != CREATE_STATE_OK)
+  {
+    ret_code = CREATE_STATE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  
+  /****************************************************************************/
+  /* Manually create a root table for the top of the tree.                    */
+  /****************************************************************************/
+  ret_val = init_root_table(&empty_root_table);
+  if (ret_val != INIT_ROOT_TABLE_OK)
+  {
+    printf("A memory allocation error occured creating root table for head of tree.\n");
+    free_state(*state);
+    ret_code = CREATE_STATE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  (*state)->root_table = empty_root_table;
   
 EXIT_LABEL:
   
@@ -65,6 +122,7 @@ void free_state(AUTOMATON_STATE *state)
   /* Free the array of next states pointers.                                  */
   /****************************************************************************/
   free(state->next_states);
+  free(state->transition_known);
   
   /****************************************************************************/
   /* Free the root table object associated with the state.                    */
@@ -313,7 +371,6 @@ int generate_state_tree(MATRIX_DATA *matrix_data,
   /* Local Variables.                                                         */
   /****************************************************************************/
   AUTOMATON_STATE *tree_start;
-  ROOT_TABLE *empty_root_table;
   int ret_code = GENERATE_STATE_TREE_OK;
   int ret_val;
   int ii;
@@ -321,44 +378,14 @@ int generate_state_tree(MATRIX_DATA *matrix_data,
   /****************************************************************************/
   /* Create the first element in the state tree.                              */
   /****************************************************************************/
-  ret_val = create_state(num_generators, &tree_start);
+  ret_val = create_start_state(num_generators, &tree_start);
   if (ret_val != CREATE_STATE_OK)
   {
-    if (ret_val == CREATE_STATE_MEM_ERR)
-    {
-      printf("There was a memory allocation error creating the state tree.\n");
-      ret_code = GENERATE_STATE_TREE_MEM_ERR;
-      goto EXIT_LABEL;
-    }
-    else
-    {
-      printf("There was an unhandled error creating the state tree.\n");
-    }
-  }
-  
-  /****************************************************************************/
-  /* Manually create a root table for the top of the tree.                    */
-  /****************************************************************************/
-  ret_val = init_root_table(&empty_root_table);
-  if (ret_val != INIT_ROOT_TABLE_OK)
-  {
-    if (ret_val == INIT_ROOT_TABLE_MEM_ERR)
-    {
-      printf("A memory allocation error occured creating root table for head of tree.\n");
-      ret_code = GENERATE_STATE_TREE_MEM_ERR;
-      goto EXIT_LABEL;
-    }
-    else
-    {
-      printf("An unhandled error occured initailising root table for the head of the tree.\n");
-    }
+    printf("There was a memory allocation error creating the state tree.\n");
+    ret_code = GENERATE_STATE_TREE_MEM_ERR;
+    goto EXIT_LABEL;
   }
   
-  /****************************************************************************/
-  /* Set the start of the tree to have the empty root table as its table.     */
-  /****************************************************************************/
-  tree_start->root_table = empty_root_table;
-  
   /****************************************************************************/
   /* Run through each of the generators filling in the branch of the tree     */
   /* starting from the simple root of that generator.                         */
@@ -415,14 +442,9 @@ EXIT_LABEL:
 /*             IN     generator - The generator which we are adding to the    */
 /*                                state that was inputted.                    */
 /*                                                                            */
-/* Operation: Check whether the generator already exists in the root list of  */
-/*            the state passed in. If it does then the new state is a fail    */
-/*            state.                                                          */
-/*            Create the new root list by applying the generator to the old   */
-/*            states list and then adding the generator as a simple root.     */
-/*            If this state already exists then point the current one at it   */
-/*            return. If not then point the current state at the new state    */
-/*            and repeat for all generators.                                  */
+/* Operation: Use find_next_automaton_state to point the current state at the */
+/*            state following the generator. If that state is new then repeat */
+/*            for all generators from the new state.                          */
 /******************************************************************************/
 int generate_next_automaton_state(MATRIX_DATA *matrix_data,
                                   int num_generators, 
@@ -436,11 +458,7 @@ int generate_next_automaton_state(MATRIX_DATA *matrix_data,
   /* Local Variables.                                                         */
   /****************************************************************************/
   AUTOMATON_STATE *new_state;
-  AUTOMATON_STATE *existing_state;
-  ROOT_TABLE *new_root_list = NULL;
-  ROOT *simple_root;
-  ROOT *existing_root;
-  ROOT_TABLE_ELEMENT *simple_root_element;
+  bool state_added;
   int ret_code = GENERATE_NEXT_AUTOMATON_STATE_OK;
   int ret_val;
   int ii;
@@ -454,22 +472,116 @@ int generate_next_automaton_state(MATRIX_DATA *matrix_data,
   assert(generator < num_generators);
   
   /****************************************************************************/
-  /* Create the new state.                                                    */
+  /* Find (or create) the state following the generator.                      */
   /****************************************************************************/
-  ret_val = create_state(num_generators, &new_state);
-  if (ret_val != CREATE_STATE_OK)
+  ret_val = find_next_automaton_state(matrix_data,
+                                      num_generators,
+                                      tree_state,
+                                      binary_tree,
+                                      generator,
+                                      &new_state,
+                                      &state_added);
+  if (ret_val != FIND_NEXT_AUTOMATON_STATE_OK)
   {
-    if (ret_val == CREATE_STATE_MEM_ERR)
-    {
-      printf("There was a memory allocation error creating the state tree.\n");
-      goto EXIT_LABEL;
-    }
-    else
+    ret_code = GENERATE_NEXT_AUTOMATON_STATE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  
+  /****************************************************************************/
+  /* If the state wasn't in the binary tree then it has now been added so for */
+  /* each of the generators recursively perform this function on the new      */
+  /* state.                                                                   */
+  /****************************************************************************/
+  if (state_added)
+  {
+    for (ii = 0; ii < num_generators; ii++)
     {
-      printf("There was an unhandled error creating the state tree.\n");
+      ret_val = generate_next_automaton_state(matrix_data,
+                                              num_generators, 
+                                              root_table, 
+                                              start,
+                                              new_state, 
+                                              binary_tree,
+                                              ii);
+      if (ret_val != GENERATE_NEXT_AUTOMATON_STATE_OK)
+      {
+        if (ret_val == GENERATE_NEXT_AUTOMATON_STATE_MEM_ERR)
+        {
+          ret_code = ret_val;
+          goto EXIT_LABEL;
+        }
+        else
+        {
+          printf("An unhandled error occured during creating automaton.\n");
+        }
+      }
     }
   }
   
+EXIT_LABEL:
+  
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: find_next_automaton_state                                        */
+/*                                                                            */
+/* Returns: One of FIND_NEXT_AUTOMATON_STATE_RET_CODES.                       */
+/*                                                                            */
+/* Parameters: IN     matrix_data - Precalculated information about the group.*/
+/*             IN     num_generators - The number of group generators.        */
+/*             IN/OUT tree_state - The current element in the tree. It will   */
+/*                                 be returned with a pointer to the next     */
+/*                                 state following the generator.             */
+/*             IN/OUT binary_tree - A binary tree of the states currently in  */
+/*                                  the automaton. Used for quick searching.  */
+/*             IN     generator - The generator which we are adding to the    */
+/*                                state that was inputted.                    */
+/*             OUT    next_state - The state following the generator. NULL    */
+/*                                 if this is a failure path.                 */
+/*             OUT    state_added - true if next_state was not already in the */
+/*                                  binary tree and has been added to it.     */
+/*                                                                            */
+/* Operation: Check whether the generator already exists in the root list of  */
+/*            the state passed in. If it does then the new state is a fail    */
+/*            state.                                                          */
+/*            Create the new root list by applying the generator to the old   */
+/*            states list and then adding the generator as a simple root.     */
+/*            If this state already exists then point the current one at it.  */
+/*            If not then add it to the binary tree and point the current     */
+/*            state at the new state.                                         */
+/*            Either way the transition is marked as known.                   */
+/******************************************************************************/
+int find_next_automaton_state(MATRIX_DATA *matrix_data,
+                              int num_generators,
+                              AUTOMATON_STATE *tree_state,
+                              BINARY_TREE_ELEMENT **binary_tree,
+                              int generator,
+                              AUTOMATON_STATE **next_state,
+                              bool *state_added)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  AUTOMATON_STATE *new_state;
+  AUTOMATON_STATE *existing_state;
+  ROOT_TABLE *new_root_list = NULL;
+  ROOT *simple_root;
+  ROOT *existing_root;
+  ROOT_TABLE_ELEMENT *simple_root_element;
+  int ret_code = FIND_NEXT_AUTOMATON_STATE_OK;
+  int ret_val;
+  
+  /****************************************************************************/
+  /* Check that the input variables are valid.                                */
+  /****************************************************************************/
+  assert(num_generators > 0);
+  assert(tree_state != NULL);
+  assert(generator < num_generators);
+  
+  (*next_state) = NULL;
+  (*state_added) = false;
+  
   /****************************************************************************/
   /* Retrieve the simple root object from the matrix data.                    */
   /****************************************************************************/
@@ -477,7 +589,7 @@ int generate_next_automaton_state(MATRIX_DATA *matrix_data,
   
   /****************************************************************************/
   /* Check whether the generator exists in the root list. If it does then     */
-  /* this is a failure path so set the accept state to false and stop the     */
+  /* this is a failure path so set the next state to NULL and stop the        */
   /* branch.                                                                  */
   /****************************************************************************/
   if (root_in_list(tree_state->root_table, 
@@ -486,120 +598,337 @@ int generate_next_automaton_state(MATRIX_DATA *matrix_data,
                    num_generators))
   {
     tree_state->next_states[generator] = NULL;
-    free_state(new_state);
+    tree_state->transition_known[generator] = true;
+    goto EXIT_LABEL;
   }
-  else
+  
+  /****************************************************************************/
+  /* Create the new state.                                                    */
+  /****************************************************************************/
+  ret_val = create_state(num_generators, &new_state);
+  if (ret_val != CREATE_STATE_OK)
   {
-    /**************************************************************************/
-    /* Apply the generator to each of the roots in the root list to create a  */
-    /* new list.                                                              */
-    /**************************************************************************/
-    cox_action_on_root_list(tree_state->root_table,
-                            &new_root_list,
-                            generator,
-                            num_generators,
-                            matrix_data);
-    
-    /**************************************************************************/
-    /* Create a root element to correspond to the simple root so that it can  */
-    /* be added to the list.                                                  */
-    /**************************************************************************/
-    init_root_table_element(&simple_root_element);
-    simple_root_element->root = simple_root;
-    
-    /**************************************************************************/
-    /* Add the simple root to the list.                                       */
-    /**************************************************************************/
-    ret_val = insert_in_table(&simple_root_element, 
-                              &new_root_list, 
-                              num_generators);
-    if (ret_val != INSERT_IN_TABLE_OK)
+    printf("There was a memory allocation error creating the state tree.\n");
+    ret_code = FIND_NEXT_AUTOMATON_STATE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  
+  /****************************************************************************/
+  /* Apply the generator to each of the roots in the root list to create a    */
+  /* new list.                                                                */
+  /****************************************************************************/
+  cox_action_on_root_list(tree_state->root_table,
+                          &new_root_list,
+                          generator,
+                          num_generators,
+                          matrix_data);
+  
+  /****************************************************************************/
+  /* Create a root element to correspond to the simple root so that it can be */
+  /* added to the list.                                                       */
+  /****************************************************************************/
+  init_root_table_element(&simple_root_element);
+  simple_root_element->root = simple_root;
+  
+  /****************************************************************************/
+  /* Add the simple root to the list.                                         */
+  /****************************************************************************/
+  ret_val = insert_in_table(&simple_root_element, 
+                            &new_root_list, 
+                            num_generators);
+  if (ret_val != INSERT_IN_TABLE_OK)
+  {
+    if (ret_val == INSERT_IN_TABLE_MEM_ERR)
     {
-      if (ret_val == INSERT_IN_TABLE_MEM_ERR)
-      {
-        printf("A memory occured error adding the simple root to the list.\n");
-        ret_code = GENERATE_NEXT_AUTOMATON_STATE_MEM_ERR;
-        goto EXIT_LABEL;
-      }
+      printf("A memory occured error adding the simple root to the list.\n");
+      free_state(new_state);
+      ret_code = FIND_NEXT_AUTOMATON_STATE_MEM_ERR;
+      goto EXIT_LABEL;
     }
-    
+  }
+  
+  /****************************************************************************/
+  /* Use the newly created root list as the root list for this state.         */
+  /****************************************************************************/
+  new_state->root_table = new_root_list;
+  
+  /****************************************************************************/
+  /* Attempt to add the new state to the binary tree.                         */
+  /****************************************************************************/
+  ret_val = add_state_to_binary_tree(binary_tree, 
+                                     new_state, 
+                                     &existing_state, 
+                                     num_generators);
+  if (ret_val == ADD_STATE_TO_BINARY_TREE_OK)
+  {
     /**************************************************************************/
-    /* Use the newly created root list as the root list for this state.       */
+    /* If the state wasn't in the binary tree then it has now been added and  */
+    /* we point the current one at it in the context of the state tree.       */
     /**************************************************************************/
-    new_state->root_table = new_root_list;
-    
+    tree_state->next_states[generator] = new_state;
+    (*state_added) = true;
+  }
+  else if (ret_val == ADD_STATE_TO_BINARY_TREE_EXISTS)
+  {
     /**************************************************************************/
-    /* Attempt to add the new state to the binary tree.                       */
+    /* If the state existed in the tree then it has been retrieved so point   */
+    /* the current one at it in the context of the tree.                      */
     /**************************************************************************/
-    ret_val = add_state_to_binary_tree(binary_tree, 
-                                       new_state, 
-                                       &existing_state, 
-                                       num_generators);
-    if (ret_val == ADD_STATE_TO_BINARY_TREE_OK)
-    {
-      /************************************************************************/
-      /* If the state wasn't in the binary tree then it has now been added    */
-      /* and we point the current one at it in the context of the state tree. */
-      /************************************************************************/
-      tree_state->next_states[generator] = new_state;
-      
-      /************************************************************************/
-      /* For each of the generators recursively perform this function on the  */
-      /* new state.                                                           */
-      /************************************************************************/
-      for (ii = 0; ii < num_generators; ii++)
-      {
-        ret_val = generate_next_automaton_state(matrix_data,
-                                                num_generators, 
-                                                root_table, 
-                                                start,
-                                                new_state, 
-                                                binary_tree,
-                                                ii);
-        if (ret_val != GENERATE_NEXT_AUTOMATON_STATE_OK)
-        {
-          if (ret_val == GENERATE_NEXT_AUTOMATON_STATE_MEM_ERR)
-          {
-            ret_code = ret_val;
-            goto EXIT_LABEL;
-          }
-          else
-          {
-            printf("An unhandled error occured during creating automaton.\n");
-          }
-        }
-      }
-    }
-    else if (ret_val == ADD_STATE_TO_BINARY_TREE_EXISTS)
-    {
-      /************************************************************************/
-      /* If the state existed in the tree then it has been retrieved so point */
-      /* the current one at it in the context of the tree.                    */
-      /************************************************************************/
-      tree_state->next_states[generator] = existing_state;
-      free_state(new_state);
-    }
-    else if (ret_val == ADD_STATE_TO_BINARY_TREE_MEM_ERR)
-    {
-      printf("A memory allocation error occured adding state to binary tree.\n");
-      free_state(new_state);
-      ret_code = GENERATE_NEXT_AUTOMATON_STATE_MEM_ERR;
-      goto EXIT_LABEL;
-    }
-    else if (ret_val == ADD_STATE_TO_BINARY_TREE_COMPARE_ERR)
+    tree_state->next_states[generator] = existing_state;
+    free_state(new_state);
+  }
+  else if (ret_val == ADD_STATE_TO_BINARY_TREE_MEM_ERR)
+  {
+    printf("A memory allocation error occured adding state to binary tree.\n");
+    free_state(new_state);
+    ret_code = FIND_NEXT_AUTOMATON_STATE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  else if (ret_val == ADD_STATE_TO_BINARY_TREE_COMPARE_ERR)
+  {
+    printf("An error occured comparing two states.\n");
+    free_state(new_state);
+    ret_code = FIND_NEXT_AUTOMATON_STATE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  else
+  {
+    printf("An unhandled error occured adding state to binary tree.\n");
+  }
+  
+  tree_state->transition_known[generator] = true;
+  (*next_state) = tree_state->next_states[generator];
+  
+EXIT_LABEL:
+  
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: init_lazy_automaton                                              */
+/*                                                                            */
+/* Returns: One of INIT_LAZY_AUTOMATON_RET_CODES.                             */
+/*                                                                            */
+/* Parameters: IN     matrix_data - Precalculated information about the group.*/
+/*             IN     num_generators - The number of group generators.        */
+/*             OUT    lazy - Will be returned holding just the start state.   */
+/*                                                                            */
+/* Operation: Create the start state with an empty root list. No other states */
+/*            are created until a word needs them.                            */
+/******************************************************************************/
+int init_lazy_automaton(MATRIX_DATA *matrix_data,
+                        int num_generators,
+                        LAZY_AUTOMATON **lazy)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = INIT_LAZY_AUTOMATON_OK;
+  int ret_val;
+  
+  /****************************************************************************/
+  /* Allocate the lazy automaton object itself.                               */
+  /****************************************************************************/
+  (*lazy) = (LAZY_AUTOMATON *) calloc(1, sizeof(LAZY_AUTOMATON));
+  if ((*lazy) == NULL)
+  {
+    ret_code = INIT_LAZY_AUTOMATON_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  (*lazy)->matrix_data = matrix_data;
+  (*lazy)->num_generators = num_generators;
+  (*lazy)->binary_tree = NULL;
+  
+  /****************************************************************************/
+  /* Create the start state in the same way as generate_state_tree does.      */
+  /****************************************************************************/
+  ret_val = create_start_state(num_generators, &((*lazy)->start));
+  if (ret_val != CREATE_STATE_OK)
+  {
+    free(*lazy);
+    (*lazy) = NULL;
+    ret_code = INIT_LAZY_AUTOMATON_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  (*lazy)->num_states = 1;
+  
+EXIT_LABEL:
+  
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: free_lazy_automaton                                              */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     lazy - The lazy automaton to be freed.                  */
+/*                                                                            */
+/* Operation: Free every state which has been created so far (these are all   */
+/*            in the binary tree apart from the start state) and then the     */
+/*            object itself.                                                  */
+/******************************************************************************/
+void free_lazy_automaton(LAZY_AUTOMATON *lazy)
+{
+  if (lazy->binary_tree != NULL)
+  {
+    free_state_tree(lazy->binary_tree);
+  }
+  free_state(lazy->start);
+  free(lazy);
+  
+  return;
+}
+
+/******************************************************************************/
+/* Function: lazy_next_state                                                  */
+/*                                                                            */
+/* Returns: One of LAZY_NEXT_STATE_RET_CODES.                                 */
+/*                                                                            */
+/* Parameters: IN/OUT lazy - The lazy automaton.                              */
+/*             IN/OUT state - The state being moved from.                     */
+/*             IN     generator - The generator being read.                   */
+/*             OUT    next_state - The state following the generator. NULL    */
+/*                                 if the word is no longer reduced.          */
+/*                                                                            */
+/* Operation: If the transition has been followed before then it is simply    */
+/*            looked up. Otherwise it is calculated with                      */
+/*            find_next_automaton_state, which shares the binary tree of      */
+/*            states with every other transition, and remembered.             */
+/******************************************************************************/
+int lazy_next_state(LAZY_AUTOMATON *lazy,
+                    AUTOMATON_STATE *state,
+                    int generator,
+                    AUTOMATON_STATE **next_state)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = LAZY_NEXT_STATE_OK;
+  int ret_val;
+  bool state_added;
+  
+  /****************************************************************************/
+  /* The common case is that the transition is already known.                 */
+  /****************************************************************************/
+  if (state->transition_known[generator])
+  {
+    (*next_state) = state->next_states[generator];
+    goto EXIT_LABEL;
+  }
+  
+  /****************************************************************************/
+  /* Otherwise work out the next state now.                                   */
+  /****************************************************************************/
+  ret_val = find_next_automaton_state(lazy->matrix_data,
+                                      lazy->num_generators,
+                                      state,
+                                      &(lazy->binary_tree),
+                                      generator,
+                                      next_state,
+                                      &state_added);
+  if (ret_val != FIND_NEXT_AUTOMATON_STATE_OK)
+  {
+    ret_code = LAZY_NEXT_STATE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  
+  if (state_added)
+  {
+    lazy->num_states++;
+  }
+  
+EXIT_LABEL:
+  
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: is_reduced_lazy                                                  */
+/*                                                                            */
+/* Returns: true if the word is reduced and false otherwise.                  */
+/*                                                                            */
+/* Parameters: IN/OUT lazy - The lazy automaton. Any transitions followed for */
+/*                           the first time are added to it.                  */
+/*             IN     word - A string consisting of a number of letters which */
+/*                           correspond to generators in the group.           */
+/*             OUT    fail_index - The index in the word that the word was no */
+/*                                 longer reduced. 0 if the word was reduced. */
+/*             IN     start_index - The first letter to be read.              */
+/*             IN     finish_index - One past the last letter to be read. If  */
+/*                                   this is less than start_index then the   */
+/*                                   word is read from right to left.         */
+/*                                                                            */
+/* Operation: The same as is_reduced but using lazy_next_state to move        */
+/*            between states.                                                 */
+/******************************************************************************/
+bool is_reduced_lazy(LAZY_AUTOMATON *lazy,
+                     char *word,
+                     int *fail_index,
+                     int start_index,
+                     int finish_index)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  bool reduced = true;
+  int ii = start_index;
+  int direction;
+  int ret_val;
+  AUTOMATON_STATE *curr;
+  
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(lazy != NULL);
+  assert(word != NULL);
+  
+  /****************************************************************************/
+  /* Work out which way through the word we are going.                        */
+  /****************************************************************************/
+  if (finish_index > start_index)
+  {
+    direction = SEARCH_FORWARDS;
+  }
+  else if (finish_index < start_index)
+  {
+    direction = SEARCH_BACKWARDS;
+  }
+  else
+  {
+    goto EXIT_LABEL;
+  }
+  
+  /****************************************************************************/
+  /* Loop through the word moving to the next state each time. A NULL state   */
+  /* means the word is not reduced.                                           */
+  /****************************************************************************/
+  curr = lazy->start;
+  for (ii = start_index; ii != finish_index; ii += direction)
+  {
+    ret_val = lazy_next_state(lazy, 
+                              curr, 
+                              (int) word[ii] - ASCII_LOWER_A, 
+                              &curr);
+    assert(ret_val == LAZY_NEXT_STATE_OK);
+    
+    if (curr == NULL)
     {
-      printf("An error occured comparing two states.\n");
-      free_state(new_state);
-      ret_code = GENERATE_NEXT_AUTOMATON_STATE_MEM_ERR;
+      reduced = false;
       goto EXIT_LABEL;
     }
-    else
-    {
-      printf("An unhandled error occured adding state to binary tree.\n");
-    }
   }
   
 EXIT_LABEL:
   
-  return(ret_code);
+  if (reduced == false)
+  {
+    *fail_index = ii;
+  }
+  else
+  {
+    *fail_index = 0;
+  }
+  
+  return(reduced);
 }
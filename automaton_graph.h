@@ -31,6 +31,30 @@
 #define GENERATE_NEXT_AUTOMATON_STATE_OK      0
 #define GENERATE_NEXT_AUTOMATON_STATE_MEM_ERR 1
 
+/******************************************************************************/
+/* Group: FIND_NEXT_AUTOMATON_STATE_RET_CODES                                 */
+/*                                                                            */
+/* The return codes for the function find_next_automaton_state.               */
+/******************************************************************************/
+#define FIND_NEXT_AUTOMATON_STATE_OK      0
+#define FIND_NEXT_AUTOMATON_STATE_MEM_ERR 1
+
+/******************************************************************************/
+/* Group: INIT_LAZY_AUTOMATON_RET_CODES                                       */
+/*                                                                            */
+/* The return codes for the function init_lazy_automaton.                     */
+/******************************************************************************/
+#define INIT_LAZY_AUTOMATON_OK      0
+#define INIT_LAZY_AUTOMATON_MEM_ERR 1
+
+/******************************************************************************/
+/* Group: LAZY_NEXT_STATE_RET_CODES                                           */
+/*                                                                            */
+/* The return codes for the function lazy_next_state.                         */
+/******************************************************************************/
+#define LAZY_NEXT_STATE_OK      0
+#define LAZY_NEXT_STATE_MEM_ERR 1
+
 /******************************************************************************/
 /* This structure refers  to a single state that the automaton can be in. It  */
 /* is either a reject state (in which case accept_state = false) or an accept */
@@ -39,10 +63,30 @@
 /* accept_state = false then next_states = NULL.                              */
 /* Each state corresponds to a set of roots from Delta' so the root list is a */
 /* list of pointers to those roots.                                           */
+/* The state id is -1 until the state tree is compiled into a flat table.     */
+/* transition_known[g] is true once next_states[g] has been worked out (a     */
+/* NULL next state is only a failure path once this is set).                  */
 /******************************************************************************/
 struct automaton_state
 {
   struct automaton_state **next_states;
+  bool *transition_known;
   struct root_table *root_table;
+  long state_id;
 };
 typedef struct automaton_state AUTOMATON_STATE;
+
+/******************************************************************************/
+/* This structure holds an automaton which is built on demand. Only the start */
+/* state exists to begin with, and each transition is calculated the first    */
+/* time a word follows it. New states are interned in the binary tree in the  */
+/* same way as when the whole automaton is generated up front.                */
+/******************************************************************************/
+typedef struct lazy_automaton
+{
+  struct matrix_data *matrix_data;
+  int num_generators;
+  AUTOMATON_STATE *start;
+  struct binary_tree_element *binary_tree;
+  long num_states;
+} LAZY_AUTOMATON;
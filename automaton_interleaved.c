@@ -0,0 +1,199 @@
+#include "cox_prot.h"
+
+/******************************************************************************/
+/* Function: fill_interleaved_lane                                            */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN/OUT scan - The scan.                                        */
+/*             IN     lane - The lane to give the next word to.               */
+/*                                                                            */
+/* Operation: Give the lane the next word which isn't empty, or leave it idle */
+/*            if there are none left. Empty words are reduced so they are     */
+/*            passed over here rather than taking up a lane.                  */
+/******************************************************************************/
+void fill_interleaved_lane(INTERLEAVED_SCAN *scan, int lane)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  long word;
+
+  if (scan->lane_word[lane] >= 0)
+  {
+    scan->num_active--;
+  }
+  while (scan->next_word < scan->num_words &&
+         scan->lengths[scan->next_word] == 0)
+  {
+    scan->fail_indices[scan->next_word] = 0;
+    scan->next_word++;
+  }
+
+  if (scan->next_word < scan->num_words)
+  {
+    word = scan->next_word;
+    scan->next_word++;
+    scan->lane_word[lane] = word;
+    scan->lane_next[lane] = scan->words[word];
+    scan->lane_end[lane] = scan->words[word] + scan->lengths[word];
+    scan->num_active++;
+  }
+  else
+  {
+    scan->lane_word[lane] = -1;
+    scan->lane_next[lane] = INTERLEAVED_SCAN_IDLE_WORD;
+    scan->lane_end[lane] = NULL;
+  }
+  scan->lane_offset[lane] = scan->table->start_state *
+                                                   scan->table->num_generators;
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: step_interleaved_scan                                            */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN/OUT scan - The scan.                                        */
+/*                                                                            */
+/* Operation: Read one letter in every lane. All of the transitions are       */
+/*            looked up before any of them are tested, so the loads don't     */
+/*            wait on each other. With AVX2 they are a single gather, as the  */
+/*            eight lanes fill one register. A lane whose word is rejected or */
+/*            finished records where and takes the next word.                 */
+/******************************************************************************/
+void step_interleaved_scan(INTERLEAVED_SCAN *scan)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  const int32_t *transitions = scan->table->transitions;
+  int num_generators = scan->table->num_generators;
+  int32_t letters[INTERLEAVED_SCAN_LANES];
+  int32_t next[INTERLEAVED_SCAN_LANES];
+  long word;
+  int lane;
+#ifdef __AVX2__
+  __m256i offsets;
+#endif
+
+  for (lane = 0; lane < INTERLEAVED_SCAN_LANES; lane++)
+  {
+    letters[lane] = (int32_t) (*(scan->lane_next[lane]) - ASCII_LOWER_A);
+  }
+
+#ifdef __AVX2__
+  offsets = _mm256_add_epi32(
+                _mm256_loadu_si256((const __m256i *) scan->lane_offset),
+                _mm256_loadu_si256((const __m256i *) letters));
+  _mm256_storeu_si256((__m256i *) next,
+                      _mm256_i32gather_epi32((const int *) transitions,
+                                             offsets,
+                                             sizeof(int32_t)));
+#else
+  for (lane = 0; lane < INTERLEAVED_SCAN_LANES; lane++)
+  {
+    next[lane] = transitions[scan->lane_offset[lane] + letters[lane]];
+  }
+#endif
+
+  for (lane = 0; lane < INTERLEAVED_SCAN_LANES; lane++)
+  {
+    word = scan->lane_word[lane];
+    if (word < 0)
+    {
+      continue;
+    }
+    if (next[lane] == AUTOMATON_TABLE_REJECT_STATE)
+    {
+      scan->fail_indices[word] = (int) (scan->lane_next[lane] -
+                                        scan->words[word]);
+      fill_interleaved_lane(scan, lane);
+    }
+    else if (++(scan->lane_next[lane]) == scan->lane_end[lane])
+    {
+      scan->fail_indices[word] = 0;
+      fill_interleaved_lane(scan, lane);
+    }
+    else
+    {
+      scan->lane_offset[lane] = next[lane] * num_generators;
+    }
+  }
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: check_words_interleaved                                          */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     table - The compiled automaton.                         */
+/*             IN     words - The words to check.                             */
+/*             IN     lengths - The length of each word.                      */
+/*             IN     num_words - The number of words.                        */
+/*             OUT    fail_indices - Will be returned holding, for each word, */
+/*                                   the index it was no longer reduced at,   */
+/*                                   or 0 if it is reduced.                   */
+/*                                                                            */
+/* Operation: The same as calling is_reduced_table on each word from left to  */
+/*            right, but reading INTERLEAVED_SCAN_LANES words at once so that */
+/*            the time taken is set by how many loads can be in flight rather */
+/*            than by the latency of each one. The lanes hold their offsets   */
+/*            in 32 bits, as the gather takes, so a table with more than      */
+/*            INT32_MAX entries is read one word at a time instead.           */
+/******************************************************************************/
+void check_words_interleaved(AUTOMATON_TABLE *table,
+                             char **words,
+                             int *lengths,
+                             long num_words,
+                             int *fail_indices)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  INTERLEAVED_SCAN scan;
+  long ii;
+  int lane;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(table != NULL);
+  assert(num_words == 0 ||
+         (words != NULL && lengths != NULL && fail_indices != NULL));
+
+  if (table->num_states > INT32_MAX / table->num_generators)
+  {
+    for (ii = 0; ii < num_words; ii++)
+    {
+      is_reduced_table(table, words[ii], &fail_indices[ii], 0, lengths[ii]);
+    }
+    goto EXIT_LABEL;
+  }
+
+  scan.table = table;
+  scan.words = words;
+  scan.lengths = lengths;
+  scan.fail_indices = fail_indices;
+  scan.num_words = num_words;
+  scan.next_word = 0;
+  scan.num_active = 0;
+  for (lane = 0; lane < INTERLEAVED_SCAN_LANES; lane++)
+  {
+    scan.lane_word[lane] = -1;
+    fill_interleaved_lane(&scan, lane);
+  }
+
+  while (scan.num_active > 0)
+  {
+    step_interleaved_scan(&scan);
+  }
+
+EXIT_LABEL:
+
+  return;
+}
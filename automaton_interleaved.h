@@ -0,0 +1,41 @@
+/******************************************************************************/
+/* The number of words an interleaved scan reads at once. Each word's next    */
+/* state doesn't depend on the others, so the loads for all of them can be in */
+/* flight together.                                                           */
+/******************************************************************************/
+#define INTERLEAVED_SCAN_LANES 8
+
+/******************************************************************************/
+/* The letters an idle lane reads. The first generator can always be read     */
+/* from the start state.                                                      */
+/******************************************************************************/
+#define INTERLEAVED_SCAN_IDLE_WORD "a"
+
+/******************************************************************************/
+/* This structure holds a scan of many words through the flat table, a few at */
+/* a time. Each lane reads one word and takes the next word as soon as it     */
+/* finishes, so the lanes stay full until the words run out.                  */
+/* words, lengths, fail_indices - The words being checked, their lengths and  */
+/*                                where each failed (0 if it is reduced).     */
+/* next_word - The next word to be given to a lane.                           */
+/* lane_word - The word each lane is reading, or -1 if it has none. An idle   */
+/*             lane reads INTERLEAVED_SCAN_IDLE_WORD from the start state so  */
+/*             that every lane can be stepped the same way.                   */
+/* lane_next - The next letter each lane reads.                               */
+/* lane_end - One past the last letter of each lane's word.                   */
+/* lane_offset - The offset of the row of the state each lane is in.          */
+/******************************************************************************/
+typedef struct interleaved_scan
+{
+  AUTOMATON_TABLE *table;
+  char **words;
+  int *lengths;
+  int *fail_indices;
+  long num_words;
+  long next_word;
+  int num_active;
+  long lane_word[INTERLEAVED_SCAN_LANES];
+  const char *lane_next[INTERLEAVED_SCAN_LANES];
+  const char *lane_end[INTERLEAVED_SCAN_LANES];
+  int32_t lane_offset[INTERLEAVED_SCAN_LANES];
+} INTERLEAVED_SCAN;
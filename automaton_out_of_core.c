@@ -0,0 +1,1087 @@
+#include "cox_prot.h"
+
+/******************************************************************************/
+/* Function: out_of_core_path                                                 */
+/*                                                                            */
+/* Returns: One of BUILD_AUTOMATON_OUT_OF_CORE_RET_CODES.                     */
+/*                                                                            */
+/* Parameters: IN     directory - The working directory.                      */
+/*             IN     name - The name of the file within the directory.       */
+/*             OUT    path - Will be returned holding the full path. Must be  */
+/*                           freed.                                           */
+/*                                                                            */
+/* Operation: Join the directory and name with a slash.                       */
+/******************************************************************************/
+int out_of_core_path(char *directory, char *name, char **path)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BUILD_AUTOMATON_OUT_OF_CORE_OK;
+  size_t length = strlen(directory) + strlen(name) + 2;
+
+  (*path) = (char *) malloc(length);
+  if ((*path) == NULL)
+  {
+    ret_code = BUILD_AUTOMATON_OUT_OF_CORE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  snprintf(*path, length, "%s/%s", directory, name);
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: init_out_of_core_build                                           */
+/*                                                                            */
+/* Returns: One of BUILD_AUTOMATON_OUT_OF_CORE_RET_CODES.                     */
+/*                                                                            */
+/* Parameters: IN     action_table - The action of the generators on the      */
+/*                                   minimal roots.                           */
+/*             IN     directory - The working directory.                      */
+/*             IN     memory_budget - The number of bytes which may be used   */
+/*                                    for sorting.                            */
+/*             IN     checkpoint_interval - The least number of seconds       */
+/*                                          between checkpoints, or           */
+/*                                          OUT_OF_CORE_NO_CHECKPOINTS.       */
+/*             OUT    build - Will be returned ready for the first level.     */
+/*                                                                            */
+/* Operation: Work out the names of all of the files and create the sort      */
+/*            which collects the transitions over the whole build.            */
+/******************************************************************************/
+int init_out_of_core_build(ROOT_ACTION_TABLE *action_table,
+                           char *directory,
+                           size_t memory_budget,
+                           long checkpoint_interval,
+                           OUT_OF_CORE_BUILD **build)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BUILD_AUTOMATON_OUT_OF_CORE_OK;
+  char *transitions_prefix = NULL;
+
+  (*build) = (OUT_OF_CORE_BUILD *) calloc(1, sizeof(OUT_OF_CORE_BUILD));
+  if ((*build) == NULL)
+  {
+    ret_code = BUILD_AUTOMATON_OUT_OF_CORE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  (*build)->action_table = action_table;
+  (*build)->memory_budget = memory_budget;
+  (*build)->record_size = sizeof(uint64_t) * (action_table->num_words + 1);
+  (*build)->transition_words = 1;
+  (*build)->checkpoint_interval = checkpoint_interval;
+  (*build)->checkpoint_level = -1;
+  (*build)->last_checkpoint = time(NULL);
+
+  if (out_of_core_path(directory,
+                       "",
+                       &((*build)->directory)) !=
+                                             BUILD_AUTOMATON_OUT_OF_CORE_OK ||
+      out_of_core_path(directory,
+                       "candidates",
+                       &((*build)->candidates_prefix)) !=
+                                             BUILD_AUTOMATON_OUT_OF_CORE_OK ||
+      out_of_core_path(directory,
+                       OUT_OF_CORE_TABLE_FILENAME,
+                       &((*build)->table_filename)) !=
+                                             BUILD_AUTOMATON_OUT_OF_CORE_OK ||
+      out_of_core_path(directory,
+                       OUT_OF_CORE_CHECKPOINT_FILENAME,
+                       &((*build)->checkpoint_filename)) !=
+                                             BUILD_AUTOMATON_OUT_OF_CORE_OK ||
+      out_of_core_path(directory,
+                       "transitions",
+                       &transitions_prefix) != BUILD_AUTOMATON_OUT_OF_CORE_OK)
+  {
+    free_out_of_core_build(*build);
+    (*build) = NULL;
+    ret_code = BUILD_AUTOMATON_OUT_OF_CORE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* The transitions sort gets half of the memory budget and the sort of the  */
+  /* candidate states in each level gets the other half.                      */
+  /****************************************************************************/
+  if (init_external_sort(transitions_prefix,
+                         2 * sizeof(uint64_t),
+                         compare_root_bitset_records,
+                         &((*build)->transition_words),
+                         memory_budget / 2,
+                         &((*build)->transitions)) != INIT_EXTERNAL_SORT_OK)
+  {
+    free_out_of_core_build(*build);
+    (*build) = NULL;
+    ret_code = BUILD_AUTOMATON_OUT_OF_CORE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+EXIT_LABEL:
+
+  free(transitions_prefix);
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: free_out_of_core_build                                           */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     build - The build to be freed.                          */
+/*                                                                            */
+/* Operation: Delete the working files (but not the finished table) and then  */
+/*            free the memory. If the build stopped part way through after a  */
+/*            checkpoint then the files the checkpoint needs are kept so that */
+/*            the build can be resumed.                                       */
+/******************************************************************************/
+void free_out_of_core_build(OUT_OF_CORE_BUILD *build)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  bool keep_checkpoint;
+
+  keep_checkpoint = (!build->finished && build->checkpoint_level >= 0);
+
+  if (build->directory != NULL)
+  {
+    if (build->level != build->checkpoint_level)
+    {
+      remove_out_of_core_level(build, build->level);
+    }
+    if (!keep_checkpoint && build->checkpoint_level >= 0)
+    {
+      remove_out_of_core_level(build, build->checkpoint_level);
+    }
+  }
+  if (!keep_checkpoint && build->checkpoint_filename != NULL)
+  {
+    remove(build->checkpoint_filename);
+  }
+  if (build->transitions != NULL)
+  {
+    /**************************************************************************/
+    /* The runs are numbered from 0 with no gaps when they have been kept.    */
+    /**************************************************************************/
+    if (!keep_checkpoint)
+    {
+      remove_stale_runs(build->transitions, 0);
+    }
+    build->transitions->keep_runs = keep_checkpoint;
+    free_external_sort(build->transitions);
+  }
+  free(build->directory);
+  free(build->candidates_prefix);
+  free(build->table_filename);
+  free(build->checkpoint_filename);
+  free(build);
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: out_of_core_level_path                                           */
+/*                                                                            */
+/* Returns: One of BUILD_AUTOMATON_OUT_OF_CORE_RET_CODES.                     */
+/*                                                                            */
+/* Parameters: IN     build - The build in progress.                          */
+/*             IN     name - Either "visited" or "frontier".                  */
+/*             IN     level - The level of the breadth first search.          */
+/*             OUT    path - Will be returned holding the full path. Must be  */
+/*                           freed.                                           */
+/*                                                                            */
+/* Operation: The files for each level are named <name>.<level> in the        */
+/*            working directory.                                              */
+/******************************************************************************/
+int out_of_core_level_path(OUT_OF_CORE_BUILD *build,
+                           char *name,
+                           long level,
+                           char **path)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BUILD_AUTOMATON_OUT_OF_CORE_OK;
+  size_t length = strlen(build->directory) + strlen(name) + 24;
+
+  (*path) = (char *) malloc(length);
+  if ((*path) == NULL)
+  {
+    ret_code = BUILD_AUTOMATON_OUT_OF_CORE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  snprintf(*path, length, "%s%s.%ld", build->directory, name, level);
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: open_out_of_core_level                                           */
+/*                                                                            */
+/* Returns: The open file or NULL if it couldn't be opened.                   */
+/*                                                                            */
+/* Parameters: IN     build - The build in progress.                          */
+/*             IN     name - Either "visited" or "frontier".                  */
+/*             IN     level - The level of the breadth first search.          */
+/*             IN     mode - The mode to pass to fopen.                       */
+/*                                                                            */
+/* Operation: Work out the name of the file and open it.                      */
+/******************************************************************************/
+FILE *open_out_of_core_level(OUT_OF_CORE_BUILD *build,
+                             char *name,
+                             long level,
+                             char *mode)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  FILE *level_file = NULL;
+  char *path;
+
+  if (out_of_core_level_path(build,
+                             name,
+                             level,
+                             &path) == BUILD_AUTOMATON_OUT_OF_CORE_OK)
+  {
+    level_file = fopen(path, mode);
+    free(path);
+  }
+
+  return(level_file);
+}
+
+/******************************************************************************/
+/* Function: remove_out_of_core_level                                         */
+/*                                                                            */
+/* Returns: true if either file existed and was removed.                      */
+/*                                                                            */
+/* Parameters: IN     build - The build in progress.                          */
+/*             IN     level - The level of the breadth first search.          */
+/*                                                                            */
+/* Operation: Delete the visited and frontier files for the level.            */
+/******************************************************************************/
+bool remove_out_of_core_level(OUT_OF_CORE_BUILD *build, long level)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  bool removed = false;
+  char *path;
+
+  if (out_of_core_level_path(build,
+                             "visited",
+                             level,
+                             &path) == BUILD_AUTOMATON_OUT_OF_CORE_OK)
+  {
+    removed = (remove(path) == 0) || removed;
+    free(path);
+  }
+  if (out_of_core_level_path(build,
+                             "frontier",
+                             level,
+                             &path) == BUILD_AUTOMATON_OUT_OF_CORE_OK)
+  {
+    removed = (remove(path) == 0) || removed;
+    free(path);
+  }
+
+  return(removed);
+}
+
+/******************************************************************************/
+/* Function: write_start_state                                                */
+/*                                                                            */
+/* Returns: One of BUILD_AUTOMATON_OUT_OF_CORE_RET_CODES.                     */
+/*                                                                            */
+/* Parameters: IN/OUT build - The build being started.                        */
+/*                                                                            */
+/* Operation: The start state is the empty set of roots and has id 0. It is   */
+/*            the only state visited so far and the whole of the frontier.    */
+/******************************************************************************/
+int write_start_state(OUT_OF_CORE_BUILD *build)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BUILD_AUTOMATON_OUT_OF_CORE_OK;
+  uint64_t *start_record;
+  FILE *visited_file = NULL;
+  FILE *frontier_file = NULL;
+
+  start_record = (uint64_t *) calloc(1, build->record_size);
+  if (start_record == NULL)
+  {
+    ret_code = BUILD_AUTOMATON_OUT_OF_CORE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  visited_file = open_out_of_core_level(build, "visited", 0, "wb");
+  frontier_file = open_out_of_core_level(build, "frontier", 0, "wb");
+  if (visited_file == NULL ||
+      frontier_file == NULL ||
+      fwrite(start_record, build->record_size, 1, visited_file) != 1 ||
+      fwrite(start_record, build->record_size, 1, frontier_file) != 1)
+  {
+    printf("Unable to write the start state to the working directory.\n");
+    ret_code = BUILD_AUTOMATON_OUT_OF_CORE_FILE_ERR;
+    goto EXIT_LABEL;
+  }
+
+  build->level = 0;
+  build->num_states = 1;
+  build->frontier_size = 1;
+
+EXIT_LABEL:
+
+  if (visited_file != NULL && fclose(visited_file) != 0)
+  {
+    ret_code = BUILD_AUTOMATON_OUT_OF_CORE_FILE_ERR;
+  }
+  if (frontier_file != NULL && fclose(frontier_file) != 0)
+  {
+    ret_code = BUILD_AUTOMATON_OUT_OF_CORE_FILE_ERR;
+  }
+  free(start_record);
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: expand_out_of_core_level                                         */
+/*                                                                            */
+/* Returns: One of BUILD_AUTOMATON_OUT_OF_CORE_RET_CODES.                     */
+/*                                                                            */
+/* Parameters: IN/OUT build - The build in progress.                          */
+/*                                                                            */
+/* Operation: Read the frontier and apply every generator to every state in   */
+/*            it, sorting the resulting candidate states by bitset. Then walk */
+/*            the sorted candidates alongside the (also sorted) visited file. */
+/*            A candidate already in the visited file takes that id. The rest */
+/*            are new states and are numbered in bitset order, so the new     */
+/*            frontier comes out in id order. The visited file is rewritten   */
+/*            with the new states merged in and a transition is recorded for  */
+/*            every candidate.                                                */
+/******************************************************************************/
+int expand_out_of_core_level(OUT_OF_CORE_BUILD *build)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BUILD_AUTOMATON_OUT_OF_CORE_OK;
+  ROOT_ACTION_TABLE *action_table = build->action_table;
+  int num_words = action_table->num_words;
+  int num_generators = action_table->num_generators;
+  size_t record_size = build->record_size;
+  uint64_t *state_record = NULL;
+  uint64_t *candidate_record = NULL;
+  uint64_t *visited_record = NULL;
+  uint64_t *last_record = NULL;
+  uint64_t transition_record[2];
+  uint64_t next_state_id = 0;
+  EXTERNAL_SORT *candidates = NULL;
+  FILE *frontier_file = NULL;
+  FILE *visited_file = NULL;
+  FILE *new_frontier_file = NULL;
+  FILE *new_visited_file = NULL;
+  bool have_visited;
+  bool have_last = false;
+  long new_frontier_size = 0;
+  int ii;
+
+  /****************************************************************************/
+  /* Allocate the working records.                                            */
+  /****************************************************************************/
+  state_record = (uint64_t *) malloc(record_size);
+  candidate_record = (uint64_t *) malloc(record_size);
+  visited_record = (uint64_t *) malloc(record_size);
+  last_record = (uint64_t *) malloc(record_size);
+  if (state_record == NULL ||
+      candidate_record == NULL ||
+      visited_record == NULL ||
+      last_record == NULL)
+  {
+    ret_code = BUILD_AUTOMATON_OUT_OF_CORE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  if (init_external_sort(build->candidates_prefix,
+                         record_size,
+                         compare_root_bitset_records,
+                         &num_words,
+                         build->memory_budget / 2,
+                         &candidates) != INIT_EXTERNAL_SORT_OK)
+  {
+    ret_code = BUILD_AUTOMATON_OUT_OF_CORE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* A level which was interrupted may have left runs behind.                 */
+  /****************************************************************************/
+  remove_stale_runs(candidates, 0);
+
+  /****************************************************************************/
+  /* Apply each generator to each state in the frontier. The last word of a   */
+  /* candidate record says which transition it came from.                     */
+  /****************************************************************************/
+  frontier_file = open_out_of_core_level(build, "frontier", build->level, "rb");
+  if (frontier_file == NULL)
+  {
+    ret_code = BUILD_AUTOMATON_OUT_OF_CORE_FILE_ERR;
+    goto EXIT_LABEL;
+  }
+  while (fread(state_record, record_size, 1, frontier_file) == 1)
+  {
+    for (ii = 0; ii < num_generators; ii++)
+    {
+      if (root_bitset_next_state(action_table,
+                                 state_record,
+                                 ii,
+                                 candidate_record))
+      {
+        candidate_record[num_words] = state_record[num_words] *
+                                                     num_generators + ii;
+        if (external_sort_add(candidates,
+                              candidate_record) != EXTERNAL_SORT_OK)
+        {
+          ret_code = BUILD_AUTOMATON_OUT_OF_CORE_FILE_ERR;
+          goto EXIT_LABEL;
+        }
+      }
+    }
+  }
+  fclose(frontier_file);
+  frontier_file = NULL;
+
+  if (external_sort_finish(candidates) != EXTERNAL_SORT_OK)
+  {
+    ret_code = BUILD_AUTOMATON_OUT_OF_CORE_FILE_ERR;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* Open the visited file and the files for the next level.                  */
+  /****************************************************************************/
+  visited_file = open_out_of_core_level(build, "visited", build->level, "rb");
+  new_visited_file = open_out_of_core_level(build,
+                                            "visited",
+                                            build->level + 1,
+                                            "wb");
+  new_frontier_file = open_out_of_core_level(build,
+                                             "frontier",
+                                             build->level + 1,
+                                             "wb");
+  if (visited_file == NULL ||
+      new_visited_file == NULL ||
+      new_frontier_file == NULL)
+  {
+    ret_code = BUILD_AUTOMATON_OUT_OF_CORE_FILE_ERR;
+    goto EXIT_LABEL;
+  }
+  have_visited = (fread(visited_record, record_size, 1, visited_file) == 1);
+
+  /****************************************************************************/
+  /* Walk through the candidates in order. Candidates with the same bitset    */
+  /* are next to each other so only the first of them needs looking up.       */
+  /****************************************************************************/
+  while (external_sort_next(candidates, candidate_record))
+  {
+    if (!have_last ||
+        compare_root_bitsets(candidate_record,
+                             last_record,
+                             num_words) != COMPARE_STATES_EQUAL)
+    {
+      /************************************************************************/
+      /* Copy across every visited state which comes before this candidate.   */
+      /************************************************************************/
+      while (have_visited &&
+             compare_root_bitsets(visited_record,
+                                  candidate_record,
+                                  num_words) == COMPARE_STATES_SMALLER)
+      {
+        if (fwrite(visited_record, record_size, 1, new_visited_file) != 1)
+        {
+          ret_code = BUILD_AUTOMATON_OUT_OF_CORE_FILE_ERR;
+          goto EXIT_LABEL;
+        }
+        have_visited = (fread(visited_record,
+                              record_size,
+                              1,
+                              visited_file) == 1);
+      }
+
+      if (have_visited &&
+          compare_root_bitsets(visited_record,
+                               candidate_record,
+                               num_words) == COMPARE_STATES_EQUAL)
+      {
+        next_state_id = visited_record[num_words];
+      }
+      else
+      {
+        /**********************************************************************/
+        /* This is a new state. State ids have to fit in the table.           */
+        /**********************************************************************/
+        if (build->num_states >= INT32_MAX)
+        {
+          printf("The automaton has too many states to be stored.\n");
+          ret_code = BUILD_AUTOMATON_OUT_OF_CORE_TOO_MANY_STATES;
+          goto EXIT_LABEL;
+        }
+        next_state_id = (uint64_t) build->num_states;
+        build->num_states++;
+        new_frontier_size++;
+
+        memcpy(last_record, candidate_record, record_size);
+        last_record[num_words] = next_state_id;
+        if (fwrite(last_record, record_size, 1, new_visited_file) != 1 ||
+            fwrite(last_record, record_size, 1, new_frontier_file) != 1)
+        {
+          ret_code = BUILD_AUTOMATON_OUT_OF_CORE_FILE_ERR;
+          goto EXIT_LABEL;
+        }
+      }
+
+      memcpy(last_record, candidate_record, record_size);
+      have_last = true;
+    }
+
+    /**************************************************************************/
+    /* Record the transition.                                                 */
+    /**************************************************************************/
+    transition_record[0] = candidate_record[num_words];
+    transition_record[1] = next_state_id;
+    if (external_sort_add(build->transitions,
+                          transition_record) != EXTERNAL_SORT_OK)
+    {
+      ret_code = BUILD_AUTOMATON_OUT_OF_CORE_FILE_ERR;
+      goto EXIT_LABEL;
+    }
+  }
+
+  /****************************************************************************/
+  /* Copy across the rest of the visited states.                              */
+  /****************************************************************************/
+  while (have_visited)
+  {
+    if (fwrite(visited_record, record_size, 1, new_visited_file) != 1)
+    {
+      ret_code = BUILD_AUTOMATON_OUT_OF_CORE_FILE_ERR;
+      goto EXIT_LABEL;
+    }
+    have_visited = (fread(visited_record, record_size, 1, visited_file) == 1);
+  }
+
+EXIT_LABEL:
+
+  if (frontier_file != NULL)
+  {
+    fclose(frontier_file);
+  }
+  if (visited_file != NULL)
+  {
+    fclose(visited_file);
+  }
+  if (new_visited_file != NULL && fclose(new_visited_file) != 0)
+  {
+    ret_code = BUILD_AUTOMATON_OUT_OF_CORE_FILE_ERR;
+  }
+  if (new_frontier_file != NULL && fclose(new_frontier_file) != 0)
+  {
+    ret_code = BUILD_AUTOMATON_OUT_OF_CORE_FILE_ERR;
+  }
+
+  /****************************************************************************/
+  /* Once the new files are safely written move on to the next level. The     */
+  /* files for the old one are no longer needed unless they belong to the     */
+  /* last checkpoint.                                                         */
+  /****************************************************************************/
+  if (ret_code == BUILD_AUTOMATON_OUT_OF_CORE_OK)
+  {
+    if (build->level != build->checkpoint_level)
+    {
+      remove_out_of_core_level(build, build->level);
+    }
+    build->level++;
+    build->frontier_size = new_frontier_size;
+  }
+
+  if (candidates != NULL)
+  {
+    free_external_sort(candidates);
+  }
+  free(state_record);
+  free(candidate_record);
+  free(visited_record);
+  free(last_record);
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: write_out_of_core_table                                          */
+/*                                                                            */
+/* Returns: One of BUILD_AUTOMATON_OUT_OF_CORE_RET_CODES.                     */
+/*                                                                            */
+/* Parameters: IN/OUT build - A build whose frontier is empty.                */
+/*                                                                            */
+/* Operation: Merge the transition runs and write them out as the rows of the */
+/*            table. Transitions which were never recorded lead to the reject */
+/*            state. The file starts with the number of states (64 bits), the */
+/*            number of generators and the start state (32 bits each).        */
+/******************************************************************************/
+int write_out_of_core_table(OUT_OF_CORE_BUILD *build)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BUILD_AUTOMATON_OUT_OF_CORE_OK;
+  FILE *table_file = NULL;
+  uint64_t transition_record[2];
+  uint64_t next_transition = 0;
+  uint64_t num_transitions;
+  int64_t num_states = build->num_states;
+  int32_t num_generators = build->action_table->num_generators;
+  int32_t start_state = 0;
+  int32_t reject_state = AUTOMATON_TABLE_REJECT_STATE;
+  int32_t next_state;
+
+  num_transitions = (uint64_t) num_states * num_generators;
+
+  if (external_sort_finish(build->transitions) != EXTERNAL_SORT_OK)
+  {
+    ret_code = BUILD_AUTOMATON_OUT_OF_CORE_FILE_ERR;
+    goto EXIT_LABEL;
+  }
+
+  table_file = fopen(build->table_filename, "wb");
+  if (table_file == NULL ||
+      fwrite(&num_states, sizeof(num_states), 1, table_file) != 1 ||
+      fwrite(&num_generators, sizeof(num_generators), 1, table_file) != 1 ||
+      fwrite(&start_state, sizeof(start_state), 1, table_file) != 1)
+  {
+    printf("Unable to write the automaton table %s.\n",
+           build->table_filename);
+    ret_code = BUILD_AUTOMATON_OUT_OF_CORE_FILE_ERR;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* The transitions come out in table order with gaps for rejects.           */
+  /****************************************************************************/
+  while (external_sort_next(build->transitions, transition_record))
+  {
+    while (next_transition < transition_record[0])
+    {
+      if (fwrite(&reject_state, sizeof(reject_state), 1, table_file) != 1)
+      {
+        ret_code = BUILD_AUTOMATON_OUT_OF_CORE_FILE_ERR;
+        goto EXIT_LABEL;
+      }
+      next_transition++;
+    }
+    next_state = (int32_t) transition_record[1];
+    if (fwrite(&next_state, sizeof(next_state), 1, table_file) != 1)
+    {
+      ret_code = BUILD_AUTOMATON_OUT_OF_CORE_FILE_ERR;
+      goto EXIT_LABEL;
+    }
+    next_transition++;
+  }
+  while (next_transition < num_transitions)
+  {
+    if (fwrite(&reject_state, sizeof(reject_state), 1, table_file) != 1)
+    {
+      ret_code = BUILD_AUTOMATON_OUT_OF_CORE_FILE_ERR;
+      goto EXIT_LABEL;
+    }
+    next_transition++;
+  }
+
+EXIT_LABEL:
+
+  if (table_file != NULL && fclose(table_file) != 0)
+  {
+    ret_code = BUILD_AUTOMATON_OUT_OF_CORE_FILE_ERR;
+  }
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: write_out_of_core_checkpoint                                     */
+/*                                                                            */
+/* Returns: One of BUILD_AUTOMATON_OUT_OF_CORE_RET_CODES.                     */
+/*                                                                            */
+/* Parameters: IN/OUT build - The build in progress, between two levels.      */
+/*                                                                            */
+/* Operation: Flush the buffered transitions to a run so that everything      */
+/*            found so far is on disk. Then write the checkpoint to a         */
+/*            temporary file and rename it over the old one, so that a crash  */
+/*            part way through leaves the old checkpoint intact. Finally the  */
+/*            files for the old checkpoint's level can be deleted.            */
+/*            The checkpoint file is a single line holding the version, the   */
+/*            number of generators and roots (to check that a resume is for   */
+/*            the same group), the level, the number of states, the size of   */
+/*            the frontier and the range of transition runs.                  */
+/******************************************************************************/
+int write_out_of_core_checkpoint(OUT_OF_CORE_BUILD *build)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BUILD_AUTOMATON_OUT_OF_CORE_OK;
+  FILE *checkpoint_file = NULL;
+  char *temp_filename = NULL;
+  long old_checkpoint_level;
+
+  if (external_sort_flush(build->transitions) != EXTERNAL_SORT_OK)
+  {
+    ret_code = BUILD_AUTOMATON_OUT_OF_CORE_FILE_ERR;
+    goto EXIT_LABEL;
+  }
+
+  temp_filename = (char *) malloc(strlen(build->checkpoint_filename) + 5);
+  if (temp_filename == NULL)
+  {
+    ret_code = BUILD_AUTOMATON_OUT_OF_CORE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  sprintf(temp_filename, "%s.tmp", build->checkpoint_filename);
+
+  checkpoint_file = fopen(temp_filename, "w");
+  if (checkpoint_file == NULL)
+  {
+    ret_code = BUILD_AUTOMATON_OUT_OF_CORE_FILE_ERR;
+    goto EXIT_LABEL;
+  }
+  fprintf(checkpoint_file,
+          "%d %d %ld %ld %ld %ld %ld %ld\n",
+          OUT_OF_CORE_CHECKPOINT_VERSION,
+          build->action_table->num_generators,
+          build->action_table->num_roots,
+          build->level,
+          build->num_states,
+          build->frontier_size,
+          build->transitions->first_run,
+          build->transitions->next_run);
+  if (fclose(checkpoint_file) != 0 ||
+      rename(temp_filename, build->checkpoint_filename) != 0)
+  {
+    printf("Unable to write the checkpoint %s.\n", build->checkpoint_filename);
+    ret_code = BUILD_AUTOMATON_OUT_OF_CORE_FILE_ERR;
+    goto EXIT_LABEL;
+  }
+
+  old_checkpoint_level = build->checkpoint_level;
+  build->checkpoint_level = build->level;
+  build->last_checkpoint = time(NULL);
+  if (old_checkpoint_level >= 0 && old_checkpoint_level != build->level)
+  {
+    remove_out_of_core_level(build, old_checkpoint_level);
+  }
+
+EXIT_LABEL:
+
+  free(temp_filename);
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: read_out_of_core_checkpoint                                      */
+/*                                                                            */
+/* Returns: One of BUILD_AUTOMATON_OUT_OF_CORE_RET_CODES.                     */
+/*                                                                            */
+/* Parameters: IN/OUT build - A newly initialised build.                      */
+/*                                                                            */
+/* Operation: Read the checkpoint and check it was written for the same       */
+/*            group. Then put the build back into the state it was in when    */
+/*            the checkpoint was written. Files for any other level, and any  */
+/*            transition runs written after the checkpoint, are deleted.      */
+/******************************************************************************/
+int read_out_of_core_checkpoint(OUT_OF_CORE_BUILD *build)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BUILD_AUTOMATON_OUT_OF_CORE_OK;
+  FILE *checkpoint_file;
+  int version;
+  int num_generators;
+  long num_roots;
+  long level;
+  long num_states;
+  long frontier_size;
+  long first_run;
+  long next_run;
+
+  checkpoint_file = fopen(build->checkpoint_filename, "r");
+  if (checkpoint_file == NULL)
+  {
+    printf("There is no checkpoint to resume from.\n");
+    ret_code = BUILD_AUTOMATON_OUT_OF_CORE_NO_CHECKPOINT;
+    goto EXIT_LABEL;
+  }
+  if (fscanf(checkpoint_file,
+             "%d %d %ld %ld %ld %ld %ld %ld",
+             &version,
+             &num_generators,
+             &num_roots,
+             &level,
+             &num_states,
+             &frontier_size,
+             &first_run,
+             &next_run) != 8 ||
+      version != OUT_OF_CORE_CHECKPOINT_VERSION ||
+      num_generators != build->action_table->num_generators ||
+      num_roots != build->action_table->num_roots ||
+      level < 0 ||
+      num_states <= 0 ||
+      frontier_size < 0 ||
+      first_run < 0 ||
+      next_run < first_run)
+  {
+    printf("The checkpoint is not valid for this group.\n");
+    ret_code = BUILD_AUTOMATON_OUT_OF_CORE_NO_CHECKPOINT;
+    fclose(checkpoint_file);
+    goto EXIT_LABEL;
+  }
+  fclose(checkpoint_file);
+
+  /****************************************************************************/
+  /* Restore the build and clear away anything from after the checkpoint.     */
+  /****************************************************************************/
+  build->level = level;
+  build->checkpoint_level = level;
+  build->num_states = num_states;
+  build->frontier_size = frontier_size;
+  restore_external_sort(build->transitions, first_run, next_run);
+  for (level = 0; level < build->level; level++)
+  {
+    remove_out_of_core_level(build, level);
+  }
+  level = build->level + 1;
+  while (remove_out_of_core_level(build, level))
+  {
+    level++;
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: build_automaton_out_of_core                                      */
+/*                                                                            */
+/* Returns: One of BUILD_AUTOMATON_OUT_OF_CORE_RET_CODES.                     */
+/*                                                                            */
+/* Parameters: IN     action_table - The action of the generators on the      */
+/*                                   minimal roots.                           */
+/*             IN     directory - An existing directory to hold the working   */
+/*                                files and the finished table.               */
+/*             IN     memory_budget - The number of bytes which may be used   */
+/*                                    for sorting.                            */
+/*             IN     checkpoint_interval - The least number of seconds       */
+/*                                          between checkpoints, or           */
+/*                                          OUT_OF_CORE_NO_CHECKPOINTS.       */
+/*             IN     resume - Carry on from the checkpoint in the directory  */
+/*                             rather than starting again.                    */
+/*             OUT    num_states - The number of states in the automaton.     */
+/*                                                                            */
+/* Operation: Build the automaton breadth first, one level at a time, with    */
+/*            every state held on disk as a bitset of roots. Memory use is    */
+/*            set by the budget rather than by the size of the automaton.     */
+/*            After each level a checkpoint is written if enough time has     */
+/*            passed since the last one. Since states are numbered in the     */
+/*            same order whether or not the build was resumed, the result is  */
+/*            always the same.                                                */
+/*            The finished table is written to OUT_OF_CORE_TABLE_FILENAME in  */
+/*            the directory and can be read with load_automaton_table_file.   */
+/******************************************************************************/
+int build_automaton_out_of_core(ROOT_ACTION_TABLE *action_table,
+                                char *directory,
+                                size_t memory_budget,
+                                long checkpoint_interval,
+                                bool resume,
+                                long *num_states)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code;
+  OUT_OF_CORE_BUILD *build = NULL;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(action_table != NULL);
+  assert(directory != NULL);
+
+  ret_code = init_out_of_core_build(action_table,
+                                    directory,
+                                    memory_budget,
+                                    checkpoint_interval,
+                                    &build);
+  if (ret_code != BUILD_AUTOMATON_OUT_OF_CORE_OK)
+  {
+    goto EXIT_LABEL;
+  }
+
+  if (resume)
+  {
+    ret_code = read_out_of_core_checkpoint(build);
+    if (ret_code == BUILD_AUTOMATON_OUT_OF_CORE_OK)
+    {
+      printf("Resuming the build at level %ld with %ld states.\n",
+             build->level,
+             build->num_states);
+    }
+  }
+  else
+  {
+    ret_code = write_start_state(build);
+  }
+  if (ret_code != BUILD_AUTOMATON_OUT_OF_CORE_OK)
+  {
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* Keep expanding until a level finds no new states.                        */
+  /****************************************************************************/
+  while (build->frontier_size > 0)
+  {
+    ret_code = expand_out_of_core_level(build);
+    if (ret_code != BUILD_AUTOMATON_OUT_OF_CORE_OK)
+    {
+      goto EXIT_LABEL;
+    }
+
+    if (build->checkpoint_interval != OUT_OF_CORE_NO_CHECKPOINTS &&
+        build->frontier_size > 0 &&
+        time(NULL) - build->last_checkpoint >= build->checkpoint_interval)
+    {
+      ret_code = write_out_of_core_checkpoint(build);
+      if (ret_code != BUILD_AUTOMATON_OUT_OF_CORE_OK)
+      {
+        goto EXIT_LABEL;
+      }
+    }
+  }
+
+  /****************************************************************************/
+  /* Checkpoint the last level too, and keep the transition runs while they   */
+  /* are merged, so that a crash while writing the table can be resumed.      */
+  /****************************************************************************/
+  if (build->checkpoint_interval != OUT_OF_CORE_NO_CHECKPOINTS)
+  {
+    ret_code = write_out_of_core_checkpoint(build);
+    if (ret_code != BUILD_AUTOMATON_OUT_OF_CORE_OK)
+    {
+      goto EXIT_LABEL;
+    }
+    build->transitions->keep_runs = true;
+  }
+
+  ret_code = write_out_of_core_table(build);
+  if (ret_code != BUILD_AUTOMATON_OUT_OF_CORE_OK)
+  {
+    goto EXIT_LABEL;
+  }
+  build->finished = true;
+  (*num_states) = build->num_states;
+
+EXIT_LABEL:
+
+  if (build != NULL)
+  {
+    free_out_of_core_build(build);
+  }
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: load_automaton_table_file                                        */
+/*                                                                            */
+/* Returns: One of LOAD_AUTOMATON_TABLE_FILE_RET_CODES.                       */
+/*                                                                            */
+/* Parameters: IN     filename - A table written by the out of core build.    */
+/*             OUT    table - Will be returned holding the table.             */
+/*                                                                            */
+/* Operation: Read the header, allocate the table and read the transitions.   */
+/******************************************************************************/
+int load_automaton_table_file(char *filename, AUTOMATON_TABLE **table)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = LOAD_AUTOMATON_TABLE_FILE_OK;
+  FILE *table_file;
+  int64_t num_states;
+  int32_t num_generators;
+  int32_t start_state;
+  size_t num_transitions;
+
+  (*table) = NULL;
+
+  table_file = fopen(filename, "rb");
+  if (table_file == NULL)
+  {
+    ret_code = LOAD_AUTOMATON_TABLE_FILE_FILE_ERR;
+    goto EXIT_LABEL;
+  }
+
+  if (fread(&num_states, sizeof(num_states), 1, table_file) != 1 ||
+      fread(&num_generators, sizeof(num_generators), 1, table_file) != 1 ||
+      fread(&start_state, sizeof(start_state), 1, table_file) != 1 ||
+      num_states <= 0 ||
+      num_states > INT32_MAX ||
+      num_generators <= 0 ||
+      num_generators > MAX_GENERATORS ||
+      start_state < 0 ||
+      start_state >= num_states)
+  {
+    ret_code = LOAD_AUTOMATON_TABLE_FILE_FILE_ERR;
+    goto EXIT_LABEL;
+  }
+
+  if (init_automaton_table(num_generators,
+                           (long) num_states,
+                           table) != INIT_AUTOMATON_TABLE_OK)
+  {
+    ret_code = LOAD_AUTOMATON_TABLE_FILE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  (*table)->start_state = start_state;
+
+  num_transitions = (size_t) num_states * num_generators;
+  if (fread((*table)->transitions,
+            sizeof(int32_t),
+            num_transitions,
+            table_file) != num_transitions)
+  {
+    free_automaton_table(*table);
+    (*table) = NULL;
+    ret_code = LOAD_AUTOMATON_TABLE_FILE_FILE_ERR;
+    goto EXIT_LABEL;
+  }
+
+EXIT_LABEL:
+
+  if (table_file != NULL)
+  {
+    fclose(table_file);
+  }
+
+  return(ret_code);
+}
@@ -0,0 +1,73 @@
+/******************************************************************************/
+/* The name of the file, inside the working directory, which the out of core  */
+/* construction writes the finished transition table to.                      */
+/******************************************************************************/
+#define OUT_OF_CORE_TABLE_FILENAME "automaton.tbl"
+
+/******************************************************************************/
+/* The name of the checkpoint file inside the working directory, and the      */
+/* version written at the start of it.                                        */
+/******************************************************************************/
+#define OUT_OF_CORE_CHECKPOINT_FILENAME "checkpoint"
+#define OUT_OF_CORE_CHECKPOINT_VERSION  1
+
+/******************************************************************************/
+/* The checkpoint interval to pass to build_automaton_out_of_core if no       */
+/* checkpoints should be written.                                             */
+/******************************************************************************/
+#define OUT_OF_CORE_NO_CHECKPOINTS -1
+
+/******************************************************************************/
+/* Group: BUILD_AUTOMATON_OUT_OF_CORE_RET_CODES                               */
+/*                                                                            */
+/* The return codes for function build_automaton_out_of_core.                 */
+/******************************************************************************/
+#define BUILD_AUTOMATON_OUT_OF_CORE_OK              0
+#define BUILD_AUTOMATON_OUT_OF_CORE_MEM_ERR         1
+#define BUILD_AUTOMATON_OUT_OF_CORE_FILE_ERR        2
+#define BUILD_AUTOMATON_OUT_OF_CORE_TOO_MANY_STATES 3
+#define BUILD_AUTOMATON_OUT_OF_CORE_NO_CHECKPOINT   4
+
+/******************************************************************************/
+/* Group: LOAD_AUTOMATON_TABLE_FILE_RET_CODES                                 */
+/*                                                                            */
+/* The return codes for function load_automaton_table_file.                   */
+/******************************************************************************/
+#define LOAD_AUTOMATON_TABLE_FILE_OK       0
+#define LOAD_AUTOMATON_TABLE_FILE_MEM_ERR  1
+#define LOAD_AUTOMATON_TABLE_FILE_FILE_ERR 2
+
+/******************************************************************************/
+/* This structure holds the files used while building the automaton out of    */
+/* core. Each state is stored on disk as a record made up of its root bitset  */
+/* followed by its state id. The files for each level of the breadth first    */
+/* search are named <name>.<level> in the working directory.                  */
+/* visited - Every state found so far, sorted by bitset.                      */
+/* frontier - The states found in the last level, in state id order.          */
+/* transitions - Sorts (state id * num_generators + generator, next state id) */
+/*               records into the order of the final table. These are         */
+/*               compared as bitsets of transition_words words.               */
+/*                                                                            */
+/* A checkpoint records the level, the state counts and which transition runs */
+/* exist. The files for the checkpointed level are kept until the next        */
+/* checkpoint so that the build can be resumed from it.                       */
+/******************************************************************************/
+typedef struct out_of_core_build
+{
+  ROOT_ACTION_TABLE *action_table;
+  size_t memory_budget;
+  size_t record_size;
+  int transition_words;
+  char *directory;
+  char *candidates_prefix;
+  char *table_filename;
+  char *checkpoint_filename;
+  long level;
+  long num_states;
+  long frontier_size;
+  long checkpoint_interval;
+  long checkpoint_level;
+  time_t last_checkpoint;
+  bool finished;
+  EXTERNAL_SORT *transitions;
+} OUT_OF_CORE_BUILD;
@@ -0,0 +1,517 @@
+#include "cox_prot.h"
+
+/******************************************************************************/
+/* Function: bandwidth_state_order                                            */
+/*                                                                            */
+/* Returns: One of RENUMBER_AUTOMATON_TABLE_RET_CODES.                        */
+/*                                                                            */
+/* Parameters: IN     table - The automaton whose states are to be ordered.   */
+/*             OUT    new_ids - An array with one entry per state which is    */
+/*                              filled in with the new id of the state.       */
+/*                                                                            */
+/* Operation: Cuthill-McKee ordering. Number the states breadth first from    */
+/*            the start state, so each level of the automaton is contiguous   */
+/*            and a transition usually lands a short way down the table. The  */
+/*            new states found from each state are numbered in increasing     */
+/*            order of how many transitions they have, which keeps the rows   */
+/*            with many successors towards the end of their level. Any states */
+/*            which can't be reached go last in their old order.              */
+/******************************************************************************/
+int bandwidth_state_order(AUTOMATON_TABLE *table, long *new_ids)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = RENUMBER_AUTOMATON_TABLE_OK;
+  int num_generators = table->num_generators;
+  long *order = NULL;
+  long head = 0;
+  long tail = 0;
+  int32_t neighbours[MAX_GENERATORS];
+  int degrees[MAX_GENERATORS];
+  int num_neighbours;
+  int32_t next;
+  int degree;
+  long ii;
+  int gg;
+  int hh;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(table != NULL);
+  assert(new_ids != NULL);
+
+  order = (long *) malloc(table->num_states * sizeof(long));
+  if (order == NULL)
+  {
+    ret_code = RENUMBER_AUTOMATON_TABLE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  for (ii = 0; ii < table->num_states; ii++)
+  {
+    new_ids[ii] = -1;
+  }
+
+  new_ids[table->start_state] = tail;
+  order[tail++] = table->start_state;
+  while (head < tail)
+  {
+    /**************************************************************************/
+    /* Gather the successors of the next state which haven't been numbered    */
+    /* yet, insertion sorting them by their number of transitions. A state    */
+    /* reached on two generators is only gathered once as it is marked as     */
+    /* soon as it is seen.                                                    */
+    /**************************************************************************/
+    num_neighbours = 0;
+    for (gg = 0; gg < num_generators; gg++)
+    {
+      next = table->transitions[order[head] * num_generators + gg];
+      if (next == AUTOMATON_TABLE_REJECT_STATE || new_ids[next] != -1)
+      {
+        continue;
+      }
+      new_ids[next] = 0;
+
+      degree = 0;
+      for (hh = 0; hh < num_generators; hh++)
+      {
+        if (table->transitions[next * num_generators + hh] !=
+                                                  AUTOMATON_TABLE_REJECT_STATE)
+        {
+          degree++;
+        }
+      }
+
+      for (hh = num_neighbours; hh > 0 && degrees[hh - 1] > degree; hh--)
+      {
+        neighbours[hh] = neighbours[hh - 1];
+        degrees[hh] = degrees[hh - 1];
+      }
+      neighbours[hh] = next;
+      degrees[hh] = degree;
+      num_neighbours++;
+    }
+
+    for (hh = 0; hh < num_neighbours; hh++)
+    {
+      new_ids[neighbours[hh]] = tail;
+      order[tail++] = neighbours[hh];
+    }
+    head++;
+  }
+
+  for (ii = 0; ii < table->num_states; ii++)
+  {
+    if (new_ids[ii] == -1)
+    {
+      new_ids[ii] = tail++;
+    }
+  }
+
+EXIT_LABEL:
+
+  free(order);
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: compare_state_visits                                             */
+/*                                                                            */
+/* Returns: One of COMPARE_STATES_GREATER, COMPARE_STATES_EQUAL or            */
+/*          COMPARE_STATES_SMALLER.                                           */
+/*                                                                            */
+/* Parameters: IN     first - The first STATE_VISITS record.                  */
+/*             IN     second - The second STATE_VISITS record.                */
+/*             IN     context - Not used.                                     */
+/*                                                                            */
+/* Operation: The state with more visits sorts first. Ties go to the state    */
+/*            with the lower old id so that the order is always the same.     */
+/******************************************************************************/
+int compare_state_visits(const void *first, const void *second, void *context)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  const STATE_VISITS *first_visits = (const STATE_VISITS *) first;
+  const STATE_VISITS *second_visits = (const STATE_VISITS *) second;
+  int ret_val = COMPARE_STATES_EQUAL;
+
+  (void) context;
+
+  if (first_visits->visits > second_visits->visits)
+  {
+    ret_val = COMPARE_STATES_SMALLER;
+  }
+  else if (first_visits->visits < second_visits->visits)
+  {
+    ret_val = COMPARE_STATES_GREATER;
+  }
+  else if (first_visits->state < second_visits->state)
+  {
+    ret_val = COMPARE_STATES_SMALLER;
+  }
+  else if (first_visits->state > second_visits->state)
+  {
+    ret_val = COMPARE_STATES_GREATER;
+  }
+
+  return(ret_val);
+}
+
+/******************************************************************************/
+/* Function: frequency_state_order                                            */
+/*                                                                            */
+/* Returns: One of RENUMBER_AUTOMATON_TABLE_RET_CODES.                        */
+/*                                                                            */
+/* Parameters: IN     table - The automaton whose states are to be ordered.   */
+/*             IN     words - The sample words.                               */
+/*             IN     num_words - The number of sample words.                 */
+/*             IN     direction - SEARCH_FORWARDS to read each word from the  */
+/*                                left or SEARCH_BACKWARDS to read it from    */
+/*                                the right.                                  */
+/*             OUT    new_ids - An array with one entry per state which is    */
+/*                              filled in with the new id of the state.       */
+/*                                                                            */
+/* Operation: Run each sample word through the automaton, stopping where it   */
+/*            is rejected as word reduction does, and count the visits to     */
+/*            each state. Then number the states from most to least visited.  */
+/******************************************************************************/
+int frequency_state_order(AUTOMATON_TABLE *table,
+                          char **words,
+                          long num_words,
+                          int direction,
+                          long *new_ids)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = RENUMBER_AUTOMATON_TABLE_OK;
+  STATE_VISITS *visits = NULL;
+  STATE_VISITS swap_record;
+  int32_t curr;
+  int length;
+  int start_index;
+  int finish_index;
+  long ii;
+  int jj;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(table != NULL);
+  assert(words != NULL || num_words == 0);
+  assert(new_ids != NULL);
+
+  visits = (STATE_VISITS *) malloc(table->num_states * sizeof(STATE_VISITS));
+  if (visits == NULL)
+  {
+    ret_code = RENUMBER_AUTOMATON_TABLE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  for (ii = 0; ii < table->num_states; ii++)
+  {
+    visits[ii].visits = 0;
+    visits[ii].state = ii;
+  }
+
+  for (ii = 0; ii < num_words; ii++)
+  {
+    length = strlen(words[ii]);
+    start_index = (direction == SEARCH_FORWARDS) ? 0 : length - 1;
+    finish_index = (direction == SEARCH_FORWARDS) ? length : -1;
+    curr = table->start_state;
+    visits[curr].visits++;
+    for (jj = start_index; jj != finish_index; jj += direction)
+    {
+      curr = table->transitions[curr * table->num_generators +
+                                (int) words[ii][jj] - ASCII_LOWER_A];
+      if (curr == AUTOMATON_TABLE_REJECT_STATE)
+      {
+        break;
+      }
+      visits[curr].visits++;
+    }
+  }
+
+  sort_records((char *) visits,
+               table->num_states,
+               sizeof(STATE_VISITS),
+               compare_state_visits,
+               NULL,
+               (char *) &swap_record);
+  for (ii = 0; ii < table->num_states; ii++)
+  {
+    new_ids[visits[ii].state] = ii;
+  }
+
+EXIT_LABEL:
+
+  free(visits);
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: renumber_automaton_table                                         */
+/*                                                                            */
+/* Returns: One of RENUMBER_AUTOMATON_TABLE_RET_CODES.                        */
+/*                                                                            */
+/* Parameters: IN/OUT table - The automaton to be renumbered.                 */
+/*             IN     new_ids - The new id of each state. Must be a           */
+/*                              permutation of 0 to num_states - 1.           */
+/*                                                                            */
+/* Operation: Write each row into its new place in a fresh transition table,  */
+/*            renumbering the states it leads to, and replace the old table.  */
+/******************************************************************************/
+int renumber_automaton_table(AUTOMATON_TABLE *table, long *new_ids)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = RENUMBER_AUTOMATON_TABLE_OK;
+  int num_generators = table->num_generators;
+  int32_t *transitions;
+  int32_t next;
+  long ii;
+  int gg;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(table != NULL);
+  assert(new_ids != NULL);
+
+  transitions = (int32_t *) malloc(table->num_states *
+                                   num_generators *
+                                   sizeof(int32_t));
+  if (transitions == NULL)
+  {
+    ret_code = RENUMBER_AUTOMATON_TABLE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  for (ii = 0; ii < table->num_states; ii++)
+  {
+    for (gg = 0; gg < num_generators; gg++)
+    {
+      next = table->transitions[ii * num_generators + gg];
+      if (next != AUTOMATON_TABLE_REJECT_STATE)
+      {
+        next = (int32_t) new_ids[next];
+      }
+      transitions[new_ids[ii] * num_generators + gg] = next;
+    }
+  }
+
+  free(table->transitions);
+  table->transitions = transitions;
+  table->start_state = (int32_t) new_ids[table->start_state];
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: load_sample_words                                                */
+/*                                                                            */
+/* Returns: One of LOAD_SAMPLE_WORDS_RET_CODES.                               */
+/*                                                                            */
+/* Parameters: IN     filename - The file holding the words, one per line.    */
+/*             IN     num_generators - The number of group generators.        */
+/*             OUT    words - Will be returned holding the words.             */
+/*             OUT    num_words - The number of words read.                   */
+/*                                                                            */
+/* Operation: Read the file a line at a time. Blank lines are skipped and any */
+/*            other line must be a word of at most MAX_WORD_LEN letters of    */
+/*            the group, written out in full.                                 */
+/******************************************************************************/
+int load_sample_words(char *filename,
+                      int num_generators,
+                      char ***words,
+                      long *num_words)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = LOAD_SAMPLE_WORDS_OK;
+  FILE *sample_file;
+  char line[MAX_WORD_LEN + 2];
+  long capacity = 0;
+  char **new_words;
+  int length;
+  int ii;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(filename != NULL);
+  assert(words != NULL);
+  assert(num_words != NULL);
+
+  *words = NULL;
+  *num_words = 0;
+  sample_file = fopen(filename, "r");
+  if (sample_file == NULL)
+  {
+    ret_code = LOAD_SAMPLE_WORDS_FILE_ERR;
+    goto EXIT_LABEL;
+  }
+
+  while (fgets(line, sizeof(line), sample_file) != NULL)
+  {
+    length = strlen(line);
+    if (length > 0 && line[length - 1] == '\n')
+    {
+      line[--length] = '\0';
+    }
+    else if (!feof(sample_file))
+    {
+      ret_code = LOAD_SAMPLE_WORDS_INVALID;
+      goto EXIT_LABEL;
+    }
+    if (length == 0)
+    {
+      continue;
+    }
+    for (ii = 0; ii < length; ii++)
+    {
+      if (line[ii] < ASCII_LOWER_A ||
+          line[ii] >= ASCII_LOWER_A + num_generators)
+      {
+        ret_code = LOAD_SAMPLE_WORDS_INVALID;
+        goto EXIT_LABEL;
+      }
+    }
+
+    if (*num_words == capacity)
+    {
+      capacity = (capacity == 0) ? 1024 : capacity * 2;
+      new_words = (char **) realloc(*words, capacity * sizeof(char *));
+      if (new_words == NULL)
+      {
+        ret_code = LOAD_SAMPLE_WORDS_MEM_ERR;
+        goto EXIT_LABEL;
+      }
+      *words = new_words;
+    }
+    (*words)[*num_words] = (char *) malloc(length + 1);
+    if ((*words)[*num_words] == NULL)
+    {
+      ret_code = LOAD_SAMPLE_WORDS_MEM_ERR;
+      goto EXIT_LABEL;
+    }
+    strncpy((*words)[*num_words], line, length + 1);
+    (*num_words)++;
+  }
+
+EXIT_LABEL:
+
+  if (sample_file != NULL)
+  {
+    fclose(sample_file);
+  }
+  if (ret_code != LOAD_SAMPLE_WORDS_OK)
+  {
+    free_sample_words(*words, *num_words);
+    *words = NULL;
+    *num_words = 0;
+  }
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: free_sample_words                                                */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     words - The words to be freed. May be NULL.             */
+/*             IN     num_words - The number of words.                        */
+/*                                                                            */
+/* Operation: Free each word and then the array.                              */
+/******************************************************************************/
+void free_sample_words(char **words, long num_words)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  long ii;
+
+  for (ii = 0; ii < num_words; ii++)
+  {
+    free(words[ii]);
+  }
+  free(words);
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: reorder_automaton_table                                          */
+/*                                                                            */
+/* Returns: One of RENUMBER_AUTOMATON_TABLE_RET_CODES.                        */
+/*                                                                            */
+/* Parameters: IN/OUT table - The automaton to be renumbered.                 */
+/*             IN     renumber_mode - One of RENUMBER_MODES.                  */
+/*             IN     words - The sample words for RENUMBER_FREQUENCY.        */
+/*             IN     num_words - The number of sample words.                 */
+/*             IN     direction - The way the automaton reads words. See      */
+/*                                frequency_state_order.                      */
+/*                                                                            */
+/* Operation: Work out the new order of the states and rewrite the table.     */
+/******************************************************************************/
+int reorder_automaton_table(AUTOMATON_TABLE *table,
+                            int renumber_mode,
+                            char **words,
+                            long num_words,
+                            int direction)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = RENUMBER_AUTOMATON_TABLE_OK;
+  long *new_ids = NULL;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(table != NULL);
+
+  if (renumber_mode == RENUMBER_NONE)
+  {
+    goto EXIT_LABEL;
+  }
+
+  new_ids = (long *) malloc(table->num_states * sizeof(long));
+  if (new_ids == NULL)
+  {
+    ret_code = RENUMBER_AUTOMATON_TABLE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  if (renumber_mode == RENUMBER_BANDWIDTH)
+  {
+    ret_code = bandwidth_state_order(table, new_ids);
+  }
+  else
+  {
+    ret_code = frequency_state_order(table,
+                                     words,
+                                     num_words,
+                                     direction,
+                                     new_ids);
+  }
+  if (ret_code == RENUMBER_AUTOMATON_TABLE_OK)
+  {
+    ret_code = renumber_automaton_table(table, new_ids);
+  }
+
+EXIT_LABEL:
+
+  free(new_ids);
+
+  return(ret_code);
+}
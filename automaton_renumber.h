@@ -0,0 +1,44 @@
+/******************************************************************************/
+/* Group: RENUMBER_AUTOMATON_TABLE_RET_CODES                                  */
+/*                                                                            */
+/* The return codes for functions bandwidth_state_order,                      */
+/* frequency_state_order, renumber_automaton_table and                        */
+/* reorder_automaton_table.                                                   */
+/******************************************************************************/
+#define RENUMBER_AUTOMATON_TABLE_OK      0
+#define RENUMBER_AUTOMATON_TABLE_MEM_ERR 1
+
+/******************************************************************************/
+/* Group: LOAD_SAMPLE_WORDS_RET_CODES                                         */
+/*                                                                            */
+/* The return codes for function load_sample_words.                           */
+/******************************************************************************/
+#define LOAD_SAMPLE_WORDS_OK       0
+#define LOAD_SAMPLE_WORDS_MEM_ERR  1
+#define LOAD_SAMPLE_WORDS_FILE_ERR 2
+#define LOAD_SAMPLE_WORDS_INVALID  3
+
+/******************************************************************************/
+/* Group: RENUMBER_MODES                                                      */
+/*                                                                            */
+/* The ways the states of the compiled automaton can be renumbered.           */
+/* RENUMBER_NONE - Keep the order the states were built in.                   */
+/* RENUMBER_BANDWIDTH - Number the states level by level out from the start   */
+/*                      state (Cuthill-McKee) so that most transitions go to  */
+/*                      a nearby row.                                         */
+/* RENUMBER_FREQUENCY - Number the states most visited by a sample of words   */
+/*                      first so that the hot rows share cache lines.         */
+/******************************************************************************/
+#define RENUMBER_NONE      0
+#define RENUMBER_BANDWIDTH 1
+#define RENUMBER_FREQUENCY 2
+
+/******************************************************************************/
+/* This structure is one record of the sort used to rank states by how often  */
+/* they were visited.                                                         */
+/******************************************************************************/
+typedef struct state_visits
+{
+  uint64_t visits;
+  int64_t state;
+} STATE_VISITS;
@@ -0,0 +1,1138 @@
+#include "cox_prot.h"
+
+/******************************************************************************/
+/* Function: root_bitset_shard                                                */
+/*                                                                            */
+/* Returns: The shard which owns the state.                                   */
+/*                                                                            */
+/* Parameters: IN     bitset - The bitset of roots for the state.             */
+/*             IN     num_words - The number of words in the bitset.          */
+/*             IN     num_shards - The number of shards.                      */
+/*                                                                            */
+/* Operation: Use the top half of the hash. Each worker's index uses the      */
+/*            bottom bits, which would otherwise be the same for every state  */
+/*            in the shard.                                                   */
+/******************************************************************************/
+int root_bitset_shard(const uint64_t *bitset, int num_words, int num_shards)
+{
+  return((int) ((hash_root_bitset(bitset, num_words) >> 32) %
+                                                      (uint64_t) num_shards));
+}
+
+/******************************************************************************/
+/* Function: init_shard_worker                                                */
+/*                                                                            */
+/* Returns: One of BUILD_AUTOMATON_SHARDED_RET_CODES.                         */
+/*                                                                            */
+/* Parameters: IN     action_table - The action of the generators on the      */
+/*                                   minimal roots.                           */
+/*             IN     shard - The shard this worker owns.                     */
+/*             IN     num_shards - The number of workers in the build.        */
+/*             IN     from_coordinator - The pipe the coordinator writes to.  */
+/*             IN     to_coordinator - The pipe the coordinator reads from.   */
+/*             OUT    worker - Will be returned ready for the first level.    */
+/*                                                                            */
+/* Operation: Allocate the index and the buffers. The worker which owns the   */
+/*            start state (the empty bitset) puts it in its frontier with id  */
+/*            0.                                                              */
+/******************************************************************************/
+int init_shard_worker(ROOT_ACTION_TABLE *action_table,
+                      int shard,
+                      int num_shards,
+                      FILE *from_coordinator,
+                      FILE *to_coordinator,
+                      SHARD_WORKER **worker)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BUILD_AUTOMATON_SHARDED_OK;
+  int num_words = action_table->num_words;
+  size_t state_size = sizeof(uint64_t) * (num_words + 1);
+  uint64_t *start_record;
+
+  (*worker) = (SHARD_WORKER *) calloc(1, sizeof(SHARD_WORKER));
+  if ((*worker) == NULL)
+  {
+    ret_code = BUILD_AUTOMATON_SHARDED_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  (*worker)->action_table = action_table;
+  (*worker)->shard = shard;
+  (*worker)->num_shards = num_shards;
+  (*worker)->from_coordinator = from_coordinator;
+  (*worker)->to_coordinator = to_coordinator;
+  (*worker)->swap_record = (char *) malloc(state_size);
+
+  if ((*worker)->swap_record == NULL ||
+      init_root_bitset_index(num_words,
+                             &((*worker)->index)) != ROOT_BITSET_INDEX_OK ||
+      init_record_buffer(state_size,
+                         &((*worker)->frontier)) != RECORD_BUFFER_OK ||
+      init_record_buffer(state_size,
+                         &((*worker)->candidates)) != RECORD_BUFFER_OK ||
+      init_record_buffer(state_size,
+                         &((*worker)->new_states)) != RECORD_BUFFER_OK ||
+      init_record_buffer(sizeof(uint64_t),
+                         &((*worker)->state_ids)) != RECORD_BUFFER_OK ||
+      init_record_buffer(2 * sizeof(uint64_t),
+                         &((*worker)->transitions)) != RECORD_BUFFER_OK)
+  {
+    free_shard_worker(*worker);
+    (*worker) = NULL;
+    ret_code = BUILD_AUTOMATON_SHARDED_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* Add the start state if this worker owns it.                              */
+  /****************************************************************************/
+  start_record = (uint64_t *) (*worker)->swap_record;
+  memset(start_record, 0, state_size);
+  if (root_bitset_shard(start_record, num_words, num_shards) == shard)
+  {
+    if (set_in_root_bitset_index((*worker)->index,
+                                 start_record,
+                                 0) != ROOT_BITSET_INDEX_OK ||
+        append_record((*worker)->frontier, start_record) != RECORD_BUFFER_OK)
+    {
+      free_shard_worker(*worker);
+      (*worker) = NULL;
+      ret_code = BUILD_AUTOMATON_SHARDED_MEM_ERR;
+      goto EXIT_LABEL;
+    }
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: free_shard_worker                                                */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     worker - The worker to be freed.                        */
+/*                                                                            */
+/* Operation: Free the index, the buffers and then the worker itself. The     */
+/*            pipes belong to the caller.                                     */
+/******************************************************************************/
+void free_shard_worker(SHARD_WORKER *worker)
+{
+  if (worker->index != NULL)
+  {
+    free_root_bitset_index(worker->index);
+  }
+  if (worker->frontier != NULL)
+  {
+    free_record_buffer(worker->frontier);
+  }
+  if (worker->candidates != NULL)
+  {
+    free_record_buffer(worker->candidates);
+  }
+  if (worker->new_states != NULL)
+  {
+    free_record_buffer(worker->new_states);
+  }
+  if (worker->state_ids != NULL)
+  {
+    free_record_buffer(worker->state_ids);
+  }
+  if (worker->transitions != NULL)
+  {
+    free_record_buffer(worker->transitions);
+  }
+  free(worker->swap_record);
+  free(worker);
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: send_shard_candidates                                            */
+/*                                                                            */
+/* Returns: One of BUILD_AUTOMATON_SHARDED_RET_CODES.                         */
+/*                                                                            */
+/* Parameters: IN/OUT worker - The worker.                                    */
+/*                                                                            */
+/* Operation: Apply each generator to each state in the frontier and send     */
+/*            every state reached to the coordinator. The last word of each   */
+/*            candidate says which transition it came from.                   */
+/******************************************************************************/
+int send_shard_candidates(SHARD_WORKER *worker)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BUILD_AUTOMATON_SHARDED_OK;
+  ROOT_ACTION_TABLE *action_table = worker->action_table;
+  int num_words = action_table->num_words;
+  int num_generators = action_table->num_generators;
+  RECORD_BUFFER *candidates = worker->candidates;
+  uint64_t *state_record;
+  uint64_t *candidate_record;
+  long ii;
+  int jj;
+
+  candidates->num_records = 0;
+  for (ii = 0; ii < worker->frontier->num_records; ii++)
+  {
+    for (jj = 0; jj < num_generators; jj++)
+    {
+      /************************************************************************/
+      /* Build the candidate in place on the end of the buffer and only keep  */
+      /* it if the transition doesn't fail.                                   */
+      /************************************************************************/
+      if (reserve_record_buffer(candidates,
+                                candidates->num_records + 1) !=
+                                                              RECORD_BUFFER_OK)
+      {
+        ret_code = BUILD_AUTOMATON_SHARDED_MEM_ERR;
+        goto EXIT_LABEL;
+      }
+      state_record = (uint64_t *) (worker->frontier->records +
+                                   ii * worker->frontier->record_size);
+      candidate_record = (uint64_t *) (candidates->records +
+                                       candidates->num_records *
+                                       candidates->record_size);
+      if (root_bitset_next_state(action_table,
+                                 state_record,
+                                 jj,
+                                 candidate_record))
+      {
+        candidate_record[num_words] = state_record[num_words] *
+                                                     num_generators + jj;
+        candidates->num_records++;
+      }
+    }
+  }
+
+  if (write_record_message(worker->to_coordinator,
+                           candidates) != RECORD_MESSAGE_OK)
+  {
+    ret_code = BUILD_AUTOMATON_SHARDED_WORKER_ERR;
+    goto EXIT_LABEL;
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: send_shard_new_states                                            */
+/*                                                                            */
+/* Returns: One of BUILD_AUTOMATON_SHARDED_RET_CODES.                         */
+/*                                                                            */
+/* Parameters: IN/OUT worker - The worker, whose candidates have just been    */
+/*                             received from the coordinator.                 */
+/*                                                                            */
+/* Operation: Look up each candidate in the index. Those which haven't been   */
+/*            seen before are added as pending and collected as new states,   */
+/*            which are then sorted and sent to the coordinator to be given   */
+/*            ids.                                                            */
+/******************************************************************************/
+int send_shard_new_states(SHARD_WORKER *worker)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BUILD_AUTOMATON_SHARDED_OK;
+  int num_words = worker->action_table->num_words;
+  RECORD_BUFFER *candidates = worker->candidates;
+  RECORD_BUFFER *new_states = worker->new_states;
+  uint64_t *candidate_record;
+  uint64_t *new_record;
+  int64_t state_id;
+  long ii;
+
+  new_states->num_records = 0;
+  for (ii = 0; ii < candidates->num_records; ii++)
+  {
+    candidate_record = (uint64_t *) (candidates->records +
+                                     ii * candidates->record_size);
+    if (!find_in_root_bitset_index(worker->index,
+                                   candidate_record,
+                                   &state_id))
+    {
+      if (set_in_root_bitset_index(worker->index,
+                                   candidate_record,
+                                   SHARD_PENDING_STATE) !=
+                                                        ROOT_BITSET_INDEX_OK ||
+          append_record(new_states, candidate_record) != RECORD_BUFFER_OK)
+      {
+        ret_code = BUILD_AUTOMATON_SHARDED_MEM_ERR;
+        goto EXIT_LABEL;
+      }
+      new_record = (uint64_t *) (new_states->records +
+                                 (new_states->num_records - 1) *
+                                 new_states->record_size);
+      new_record[num_words] = 0;
+    }
+  }
+
+  sort_records(new_states->records,
+               new_states->num_records,
+               new_states->record_size,
+               compare_root_bitset_records,
+               &num_words,
+               worker->swap_record);
+
+  if (write_record_message(worker->to_coordinator,
+                           new_states) != RECORD_MESSAGE_OK)
+  {
+    ret_code = BUILD_AUTOMATON_SHARDED_WORKER_ERR;
+    goto EXIT_LABEL;
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: send_shard_transitions                                           */
+/*                                                                            */
+/* Returns: One of BUILD_AUTOMATON_SHARDED_RET_CODES.                         */
+/*                                                                            */
+/* Parameters: IN/OUT worker - The worker, which has sent its new states.     */
+/*                                                                            */
+/* Operation: Read the ids of the new states and record them in the index.    */
+/*            The new states become the next frontier. Every candidate now    */
+/*            has an id so send its transition to the coordinator.            */
+/******************************************************************************/
+int send_shard_transitions(SHARD_WORKER *worker)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BUILD_AUTOMATON_SHARDED_OK;
+  int num_words = worker->action_table->num_words;
+  RECORD_BUFFER *candidates = worker->candidates;
+  RECORD_BUFFER *new_states = worker->new_states;
+  RECORD_BUFFER *swap_buffer;
+  uint64_t *candidate_record;
+  uint64_t *new_record;
+  uint64_t transition_record[2];
+  int64_t state_id;
+  long ii;
+
+  if (read_record_message(worker->from_coordinator,
+                          worker->state_ids) != RECORD_MESSAGE_OK ||
+      worker->state_ids->num_records != new_states->num_records)
+  {
+    ret_code = BUILD_AUTOMATON_SHARDED_WORKER_ERR;
+    goto EXIT_LABEL;
+  }
+
+  for (ii = 0; ii < new_states->num_records; ii++)
+  {
+    new_record = (uint64_t *) (new_states->records +
+                               ii * new_states->record_size);
+    new_record[num_words] = ((uint64_t *) worker->state_ids->records)[ii];
+    if (set_in_root_bitset_index(worker->index,
+                                 new_record,
+                                 (int64_t) new_record[num_words]) !=
+                                                          ROOT_BITSET_INDEX_OK)
+    {
+      ret_code = BUILD_AUTOMATON_SHARDED_MEM_ERR;
+      goto EXIT_LABEL;
+    }
+  }
+  swap_buffer = worker->frontier;
+  worker->frontier = worker->new_states;
+  worker->new_states = swap_buffer;
+
+  worker->transitions->num_records = 0;
+  for (ii = 0; ii < candidates->num_records; ii++)
+  {
+    candidate_record = (uint64_t *) (candidates->records +
+                                     ii * candidates->record_size);
+    find_in_root_bitset_index(worker->index, candidate_record, &state_id);
+    assert(state_id >= 0);
+    transition_record[0] = candidate_record[num_words];
+    transition_record[1] = (uint64_t) state_id;
+    if (append_record(worker->transitions,
+                      transition_record) != RECORD_BUFFER_OK)
+    {
+      ret_code = BUILD_AUTOMATON_SHARDED_MEM_ERR;
+      goto EXIT_LABEL;
+    }
+  }
+
+  if (write_record_message(worker->to_coordinator,
+                           worker->transitions) != RECORD_MESSAGE_OK)
+  {
+    ret_code = BUILD_AUTOMATON_SHARDED_WORKER_ERR;
+    goto EXIT_LABEL;
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: run_shard_worker                                                 */
+/*                                                                            */
+/* Returns: One of BUILD_AUTOMATON_SHARDED_RET_CODES.                         */
+/*                                                                            */
+/* Parameters: IN/OUT worker - The worker.                                    */
+/*                                                                            */
+/* Operation: Take part in one level of the breadth first search after        */
+/*            another until the coordinator closes the pipe instead of        */
+/*            sending the candidates for the next level.                      */
+/******************************************************************************/
+int run_shard_worker(SHARD_WORKER *worker)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BUILD_AUTOMATON_SHARDED_OK;
+  int message_ret_code;
+
+  while (true)
+  {
+    ret_code = send_shard_candidates(worker);
+    if (ret_code != BUILD_AUTOMATON_SHARDED_OK)
+    {
+      goto EXIT_LABEL;
+    }
+
+    message_ret_code = read_record_message(worker->from_coordinator,
+                                           worker->candidates);
+    if (message_ret_code == RECORD_MESSAGE_CLOSED)
+    {
+      break;
+    }
+    if (message_ret_code != RECORD_MESSAGE_OK)
+    {
+      ret_code = BUILD_AUTOMATON_SHARDED_WORKER_ERR;
+      goto EXIT_LABEL;
+    }
+
+    ret_code = send_shard_new_states(worker);
+    if (ret_code != BUILD_AUTOMATON_SHARDED_OK)
+    {
+      goto EXIT_LABEL;
+    }
+
+    ret_code = send_shard_transitions(worker);
+    if (ret_code != BUILD_AUTOMATON_SHARDED_OK)
+    {
+      goto EXIT_LABEL;
+    }
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: init_sharded_build                                               */
+/*                                                                            */
+/* Returns: One of BUILD_AUTOMATON_SHARDED_RET_CODES.                         */
+/*                                                                            */
+/* Parameters: IN     action_table - The action of the generators on the      */
+/*                                   minimal roots.                           */
+/*             IN     num_workers - The number of worker processes.           */
+/*             OUT    build - Will be returned holding a table with just the  */
+/*                            start state, and no workers started.            */
+/*                                                                            */
+/* Operation: Allocate the per worker arrays and buffers and the table.       */
+/******************************************************************************/
+int init_sharded_build(ROOT_ACTION_TABLE *action_table,
+                       int num_workers,
+                       SHARDED_BUILD **build)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BUILD_AUTOMATON_SHARDED_OK;
+  size_t state_size = sizeof(uint64_t) * (action_table->num_words + 1);
+  int ii;
+
+  (*build) = (SHARDED_BUILD *) calloc(1, sizeof(SHARDED_BUILD));
+  if ((*build) == NULL)
+  {
+    ret_code = BUILD_AUTOMATON_SHARDED_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  (*build)->action_table = action_table;
+  (*build)->num_workers = num_workers;
+  (*build)->pids = (pid_t *) calloc(num_workers, sizeof(pid_t));
+  (*build)->to_workers = (FILE **) calloc(num_workers, sizeof(FILE *));
+  (*build)->from_workers = (FILE **) calloc(num_workers, sizeof(FILE *));
+  (*build)->routed = (RECORD_BUFFER **) calloc(num_workers,
+                                               sizeof(RECORD_BUFFER *));
+  (*build)->new_states = (RECORD_BUFFER **) calloc(num_workers,
+                                                   sizeof(RECORD_BUFFER *));
+  (*build)->state_ids = (RECORD_BUFFER **) calloc(num_workers,
+                                                  sizeof(RECORD_BUFFER *));
+  (*build)->merge_positions = (long *) calloc(num_workers, sizeof(long));
+  if ((*build)->pids == NULL ||
+      (*build)->to_workers == NULL ||
+      (*build)->from_workers == NULL ||
+      (*build)->routed == NULL ||
+      (*build)->new_states == NULL ||
+      (*build)->state_ids == NULL ||
+      (*build)->merge_positions == NULL ||
+      init_record_buffer(state_size,
+                         &((*build)->received_states)) != RECORD_BUFFER_OK ||
+      init_record_buffer(2 * sizeof(uint64_t),
+                         &((*build)->received_transitions)) !=
+                                                            RECORD_BUFFER_OK ||
+      init_automaton_table(action_table->num_generators,
+                           1,
+                           &((*build)->table)) != INIT_AUTOMATON_TABLE_OK)
+  {
+    free_sharded_build(*build);
+    (*build) = NULL;
+    ret_code = BUILD_AUTOMATON_SHARDED_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  (*build)->table_capacity = 1;
+
+  for (ii = 0; ii < num_workers; ii++)
+  {
+    if (init_record_buffer(state_size,
+                           &((*build)->routed[ii])) != RECORD_BUFFER_OK ||
+        init_record_buffer(state_size,
+                           &((*build)->new_states[ii])) != RECORD_BUFFER_OK ||
+        init_record_buffer(sizeof(uint64_t),
+                           &((*build)->state_ids[ii])) != RECORD_BUFFER_OK)
+    {
+      free_sharded_build(*build);
+      (*build) = NULL;
+      ret_code = BUILD_AUTOMATON_SHARDED_MEM_ERR;
+      goto EXIT_LABEL;
+    }
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: free_sharded_build                                               */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     build - The build to be freed.                          */
+/*                                                                            */
+/* Operation: Stop any workers which are still running and free the memory.   */
+/*            The table is freed too unless it has been taken by setting it   */
+/*            to NULL.                                                        */
+/******************************************************************************/
+void free_sharded_build(SHARDED_BUILD *build)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ii;
+
+  if (build->pids != NULL &&
+      build->to_workers != NULL &&
+      build->from_workers != NULL)
+  {
+    stop_shard_workers(build);
+  }
+
+  for (ii = 0; ii < build->num_workers; ii++)
+  {
+    if (build->routed != NULL && build->routed[ii] != NULL)
+    {
+      free_record_buffer(build->routed[ii]);
+    }
+    if (build->new_states != NULL && build->new_states[ii] != NULL)
+    {
+      free_record_buffer(build->new_states[ii]);
+    }
+    if (build->state_ids != NULL && build->state_ids[ii] != NULL)
+    {
+      free_record_buffer(build->state_ids[ii]);
+    }
+  }
+  if (build->received_states != NULL)
+  {
+    free_record_buffer(build->received_states);
+  }
+  if (build->received_transitions != NULL)
+  {
+    free_record_buffer(build->received_transitions);
+  }
+  if (build->table != NULL)
+  {
+    free_automaton_table(build->table);
+  }
+  free(build->pids);
+  free(build->to_workers);
+  free(build->from_workers);
+  free(build->routed);
+  free(build->new_states);
+  free(build->state_ids);
+  free(build->merge_positions);
+  free(build);
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: start_shard_workers                                              */
+/*                                                                            */
+/* Returns: One of BUILD_AUTOMATON_SHARDED_RET_CODES.                         */
+/*                                                                            */
+/* Parameters: IN/OUT build - The build, with no workers started.             */
+/*                                                                            */
+/* Operation: For each worker create a pipe in each direction and fork. The   */
+/*            child closes the coordinator's ends of the pipes (including     */
+/*            those of the workers started before it, so that each worker     */
+/*            sees the end of its own pipe when the coordinator closes it),   */
+/*            runs the worker and exits without returning.                    */
+/******************************************************************************/
+int start_shard_workers(SHARDED_BUILD *build)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BUILD_AUTOMATON_SHARDED_OK;
+  int to_worker_pipe[2];
+  int from_worker_pipe[2];
+  FILE *from_coordinator;
+  FILE *to_coordinator;
+  SHARD_WORKER *worker;
+  int worker_ret_code;
+  int ii;
+  int jj;
+
+  /****************************************************************************/
+  /* Anything still waiting to be printed would otherwise be printed by every */
+  /* child as well.                                                           */
+  /****************************************************************************/
+  fflush(stdout);
+
+  for (ii = 0; ii < build->num_workers; ii++)
+  {
+    if (pipe(to_worker_pipe) != 0)
+    {
+      ret_code = BUILD_AUTOMATON_SHARDED_WORKER_ERR;
+      goto EXIT_LABEL;
+    }
+    if (pipe(from_worker_pipe) != 0)
+    {
+      close(to_worker_pipe[0]);
+      close(to_worker_pipe[1]);
+      ret_code = BUILD_AUTOMATON_SHARDED_WORKER_ERR;
+      goto EXIT_LABEL;
+    }
+
+    build->pids[ii] = fork();
+    if (build->pids[ii] == 0)
+    {
+      /************************************************************************/
+      /* This is the worker.                                                  */
+      /************************************************************************/
+      for (jj = 0; jj < ii; jj++)
+      {
+        close(fileno(build->to_workers[jj]));
+        close(fileno(build->from_workers[jj]));
+      }
+      close(to_worker_pipe[1]);
+      close(from_worker_pipe[0]);
+
+      from_coordinator = fdopen(to_worker_pipe[0], "rb");
+      to_coordinator = fdopen(from_worker_pipe[1], "wb");
+      worker_ret_code = BUILD_AUTOMATON_SHARDED_WORKER_ERR;
+      if (from_coordinator != NULL &&
+          to_coordinator != NULL &&
+          init_shard_worker(build->action_table,
+                            ii,
+                            build->num_workers,
+                            from_coordinator,
+                            to_coordinator,
+                            &worker) == BUILD_AUTOMATON_SHARDED_OK)
+      {
+        worker_ret_code = run_shard_worker(worker);
+        free_shard_worker(worker);
+      }
+      _exit(worker_ret_code == BUILD_AUTOMATON_SHARDED_OK ? 0 : 1);
+    }
+
+    /**************************************************************************/
+    /* This is the coordinator.                                               */
+    /**************************************************************************/
+    close(to_worker_pipe[0]);
+    close(from_worker_pipe[1]);
+    if (build->pids[ii] < 0)
+    {
+      build->pids[ii] = 0;
+      close(to_worker_pipe[1]);
+      close(from_worker_pipe[0]);
+      ret_code = BUILD_AUTOMATON_SHARDED_WORKER_ERR;
+      goto EXIT_LABEL;
+    }
+    build->to_workers[ii] = fdopen(to_worker_pipe[1], "wb");
+    build->from_workers[ii] = fdopen(from_worker_pipe[0], "rb");
+    if (build->to_workers[ii] == NULL || build->from_workers[ii] == NULL)
+    {
+      ret_code = BUILD_AUTOMATON_SHARDED_WORKER_ERR;
+      goto EXIT_LABEL;
+    }
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: stop_shard_workers                                               */
+/*                                                                            */
+/* Returns: One of BUILD_AUTOMATON_SHARDED_RET_CODES.                         */
+/*                                                                            */
+/* Parameters: IN/OUT build - The build.                                      */
+/*                                                                            */
+/* Operation: Close the pipes, which tells each worker to finish, and wait    */
+/*            for the workers to exit. Any worker which didn't exit cleanly   */
+/*            is an error.                                                    */
+/******************************************************************************/
+int stop_shard_workers(SHARDED_BUILD *build)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BUILD_AUTOMATON_SHARDED_OK;
+  int status;
+  int ii;
+
+  for (ii = 0; ii < build->num_workers; ii++)
+  {
+    if (build->to_workers[ii] != NULL)
+    {
+      fclose(build->to_workers[ii]);
+      build->to_workers[ii] = NULL;
+    }
+    if (build->from_workers[ii] != NULL)
+    {
+      fclose(build->from_workers[ii]);
+      build->from_workers[ii] = NULL;
+    }
+  }
+
+  for (ii = 0; ii < build->num_workers; ii++)
+  {
+    if (build->pids[ii] > 0)
+    {
+      if (waitpid(build->pids[ii], &status, 0) != build->pids[ii] ||
+          !WIFEXITED(status) ||
+          WEXITSTATUS(status) != 0)
+      {
+        ret_code = BUILD_AUTOMATON_SHARDED_WORKER_ERR;
+      }
+      build->pids[ii] = 0;
+    }
+  }
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: route_shard_candidates                                           */
+/*                                                                            */
+/* Returns: One of BUILD_AUTOMATON_SHARDED_RET_CODES.                         */
+/*                                                                            */
+/* Parameters: IN/OUT build - The build.                                      */
+/*             OUT    num_candidates - The number of candidates found by all  */
+/*                                     of the workers in this level.          */
+/*                                                                            */
+/* Operation: Read the candidates from every worker and sort them by the      */
+/*            shard which owns them. Unless there were none at all send each  */
+/*            worker its candidates. Everything is read before anything is    */
+/*            sent since a worker doesn't read until it has finished writing. */
+/******************************************************************************/
+int route_shard_candidates(SHARDED_BUILD *build, long *num_candidates)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BUILD_AUTOMATON_SHARDED_OK;
+  int num_words = build->action_table->num_words;
+  RECORD_BUFFER *received = build->received_states;
+  uint64_t *candidate_record;
+  int shard;
+  long ii;
+  int jj;
+
+  (*num_candidates) = 0;
+  for (jj = 0; jj < build->num_workers; jj++)
+  {
+    build->routed[jj]->num_records = 0;
+  }
+
+  for (jj = 0; jj < build->num_workers; jj++)
+  {
+    if (read_record_message(build->from_workers[jj],
+                            received) != RECORD_MESSAGE_OK)
+    {
+      ret_code = BUILD_AUTOMATON_SHARDED_WORKER_ERR;
+      goto EXIT_LABEL;
+    }
+    for (ii = 0; ii < received->num_records; ii++)
+    {
+      candidate_record = (uint64_t *) (received->records +
+                                       ii * received->record_size);
+      shard = root_bitset_shard(candidate_record,
+                                num_words,
+                                build->num_workers);
+      if (append_record(build->routed[shard],
+                        candidate_record) != RECORD_BUFFER_OK)
+      {
+        ret_code = BUILD_AUTOMATON_SHARDED_MEM_ERR;
+        goto EXIT_LABEL;
+      }
+    }
+    (*num_candidates) += received->num_records;
+  }
+
+  if ((*num_candidates) == 0)
+  {
+    goto EXIT_LABEL;
+  }
+
+  for (jj = 0; jj < build->num_workers; jj++)
+  {
+    if (write_record_message(build->to_workers[jj],
+                             build->routed[jj]) != RECORD_MESSAGE_OK)
+    {
+      ret_code = BUILD_AUTOMATON_SHARDED_WORKER_ERR;
+      goto EXIT_LABEL;
+    }
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: grow_sharded_table                                               */
+/*                                                                            */
+/* Returns: One of BUILD_AUTOMATON_SHARDED_RET_CODES.                         */
+/*                                                                            */
+/* Parameters: IN/OUT build - The build.                                      */
+/*             IN     num_states - The number of rows the table must have.    */
+/*                                                                            */
+/* Operation: Double the rows allocated until there are enough, with every    */
+/*            new transition set to the reject state.                         */
+/******************************************************************************/
+int grow_sharded_table(SHARDED_BUILD *build, long num_states)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BUILD_AUTOMATON_SHARDED_OK;
+  int num_generators = build->table->num_generators;
+  long new_capacity = build->table_capacity;
+  int32_t *new_transitions;
+  long ii;
+
+  if (num_states > build->table_capacity)
+  {
+    while (new_capacity < num_states)
+    {
+      new_capacity *= 2;
+    }
+    new_transitions = (int32_t *) realloc(build->table->transitions,
+                                          sizeof(int32_t) *
+                                          new_capacity *
+                                          num_generators);
+    if (new_transitions == NULL)
+    {
+      ret_code = BUILD_AUTOMATON_SHARDED_MEM_ERR;
+      goto EXIT_LABEL;
+    }
+    for (ii = build->table_capacity * num_generators;
+         ii < new_capacity * num_generators;
+         ii++)
+    {
+      new_transitions[ii] = AUTOMATON_TABLE_REJECT_STATE;
+    }
+    build->table->transitions = new_transitions;
+    build->table_capacity = new_capacity;
+  }
+  build->table->num_states = num_states;
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: number_shard_states                                              */
+/*                                                                            */
+/* Returns: One of BUILD_AUTOMATON_SHARDED_RET_CODES.                         */
+/*                                                                            */
+/* Parameters: IN/OUT build - The build, whose workers are sending their new  */
+/*                            states.                                         */
+/*                                                                            */
+/* Operation: Read the sorted new states from every worker and merge them,    */
+/*            giving each the next id in turn. The new states of a level are  */
+/*            therefore numbered in bitset order, just as in the out of core  */
+/*            build, however many workers there are. Then send each worker    */
+/*            the ids of its states.                                          */
+/******************************************************************************/
+int number_shard_states(SHARDED_BUILD *build)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BUILD_AUTOMATON_SHARDED_OK;
+  int num_words = build->action_table->num_words;
+  long num_states = build->table->num_states;
+  RECORD_BUFFER *new_states;
+  uint64_t *state_record;
+  uint64_t *best_record;
+  uint64_t state_id;
+  int best_worker;
+  int jj;
+
+  for (jj = 0; jj < build->num_workers; jj++)
+  {
+    if (read_record_message(build->from_workers[jj],
+                            build->new_states[jj]) != RECORD_MESSAGE_OK)
+    {
+      ret_code = BUILD_AUTOMATON_SHARDED_WORKER_ERR;
+      goto EXIT_LABEL;
+    }
+    build->merge_positions[jj] = 0;
+    build->state_ids[jj]->num_records = 0;
+  }
+
+  /****************************************************************************/
+  /* No state is owned by two workers so there are never any ties.            */
+  /****************************************************************************/
+  while (true)
+  {
+    best_worker = -1;
+    best_record = NULL;
+    for (jj = 0; jj < build->num_workers; jj++)
+    {
+      new_states = build->new_states[jj];
+      if (build->merge_positions[jj] < new_states->num_records)
+      {
+        state_record = (uint64_t *) (new_states->records +
+                                     build->merge_positions[jj] *
+                                     new_states->record_size);
+        if (best_record == NULL ||
+            compare_root_bitsets(state_record,
+                                 best_record,
+                                 num_words) == COMPARE_STATES_SMALLER)
+        {
+          best_worker = jj;
+          best_record = state_record;
+        }
+      }
+    }
+    if (best_worker < 0)
+    {
+      break;
+    }
+
+    /**************************************************************************/
+    /* State ids have to fit in the table.                                    */
+    /**************************************************************************/
+    if (num_states >= INT32_MAX)
+    {
+      printf("The automaton has too many states to be stored.\n");
+      ret_code = BUILD_AUTOMATON_SHARDED_TOO_MANY_STATES;
+      goto EXIT_LABEL;
+    }
+    state_id = (uint64_t) num_states;
+    num_states++;
+    if (append_record(build->state_ids[best_worker],
+                      &state_id) != RECORD_BUFFER_OK)
+    {
+      ret_code = BUILD_AUTOMATON_SHARDED_MEM_ERR;
+      goto EXIT_LABEL;
+    }
+    build->merge_positions[best_worker]++;
+  }
+
+  ret_code = grow_sharded_table(build, num_states);
+  if (ret_code != BUILD_AUTOMATON_SHARDED_OK)
+  {
+    goto EXIT_LABEL;
+  }
+
+  for (jj = 0; jj < build->num_workers; jj++)
+  {
+    if (write_record_message(build->to_workers[jj],
+                             build->state_ids[jj]) != RECORD_MESSAGE_OK)
+    {
+      ret_code = BUILD_AUTOMATON_SHARDED_WORKER_ERR;
+      goto EXIT_LABEL;
+    }
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: collect_shard_transitions                                        */
+/*                                                                            */
+/* Returns: One of BUILD_AUTOMATON_SHARDED_RET_CODES.                         */
+/*                                                                            */
+/* Parameters: IN/OUT build - The build, whose workers are sending their      */
+/*                            transitions.                                    */
+/*                                                                            */
+/* Operation: Read the transitions from every worker into the table.          */
+/******************************************************************************/
+int collect_shard_transitions(SHARDED_BUILD *build)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BUILD_AUTOMATON_SHARDED_OK;
+  RECORD_BUFFER *received = build->received_transitions;
+  long num_transitions = build->table->num_states *
+                                              build->table->num_generators;
+  uint64_t *transition_record;
+  long ii;
+  int jj;
+
+  for (jj = 0; jj < build->num_workers; jj++)
+  {
+    if (read_record_message(build->from_workers[jj],
+                            received) != RECORD_MESSAGE_OK)
+    {
+      ret_code = BUILD_AUTOMATON_SHARDED_WORKER_ERR;
+      goto EXIT_LABEL;
+    }
+    for (ii = 0; ii < received->num_records; ii++)
+    {
+      transition_record = (uint64_t *) (received->records +
+                                        ii * received->record_size);
+      if (transition_record[0] >= (uint64_t) num_transitions ||
+          transition_record[1] >= (uint64_t) build->table->num_states)
+      {
+        ret_code = BUILD_AUTOMATON_SHARDED_WORKER_ERR;
+        goto EXIT_LABEL;
+      }
+      build->table->transitions[transition_record[0]] =
+                                              (int32_t) transition_record[1];
+    }
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: build_automaton_sharded                                          */
+/*                                                                            */
+/* Returns: One of BUILD_AUTOMATON_SHARDED_RET_CODES.                         */
+/*                                                                            */
+/* Parameters: IN     action_table - The action of the generators on the      */
+/*                                   minimal roots.                           */
+/*             IN     num_workers - The number of worker processes to use.    */
+/*             OUT    table - Will be returned holding the automaton.         */
+/*                                                                            */
+/* Operation: Build the automaton breadth first with the states split across  */
+/*            worker processes by a hash of their root bitsets. In each level */
+/*            every worker expands its own frontier, the coordinator passes   */
+/*            each state reached to the worker owning it, the workers pick    */
+/*            out the states they haven't seen, the coordinator numbers these */
+/*            and finally the workers report the transitions. The states are  */
+/*            numbered exactly as in build_automaton_out_of_core, so the      */
+/*            table is the same whatever the number of workers.               */
+/******************************************************************************/
+int build_automaton_sharded(ROOT_ACTION_TABLE *action_table,
+                            int num_workers,
+                            AUTOMATON_TABLE **table)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code;
+  SHARDED_BUILD *build = NULL;
+  long num_candidates;
+  void (*old_handler)(int);
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(action_table != NULL);
+  assert(num_workers > 0 && num_workers <= MAX_SHARD_WORKERS);
+
+  /****************************************************************************/
+  /* A worker which dies should show up as an error writing to it rather than */
+  /* killing the coordinator.                                                 */
+  /****************************************************************************/
+  old_handler = signal(SIGPIPE, SIG_IGN);
+
+  ret_code = init_sharded_build(action_table, num_workers, &build);
+  if (ret_code != BUILD_AUTOMATON_SHARDED_OK)
+  {
+    goto EXIT_LABEL;
+  }
+
+  ret_code = start_shard_workers(build);
+  if (ret_code != BUILD_AUTOMATON_SHARDED_OK)
+  {
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* Keep going until no worker has anything left in its frontier.            */
+  /****************************************************************************/
+  while (true)
+  {
+    ret_code = route_shard_candidates(build, &num_candidates);
+    if (ret_code != BUILD_AUTOMATON_SHARDED_OK || num_candidates == 0)
+    {
+      break;
+    }
+
+    ret_code = number_shard_states(build);
+    if (ret_code != BUILD_AUTOMATON_SHARDED_OK)
+    {
+      break;
+    }
+
+    ret_code = collect_shard_transitions(build);
+    if (ret_code != BUILD_AUTOMATON_SHARDED_OK)
+    {
+      break;
+    }
+  }
+  if (ret_code != BUILD_AUTOMATON_SHARDED_OK)
+  {
+    goto EXIT_LABEL;
+  }
+
+  ret_code = stop_shard_workers(build);
+  if (ret_code != BUILD_AUTOMATON_SHARDED_OK)
+  {
+    goto EXIT_LABEL;
+  }
+
+  (*table) = build->table;
+  build->table = NULL;
+
+EXIT_LABEL:
+
+  if (build != NULL)
+  {
+    free_sharded_build(build);
+  }
+  signal(SIGPIPE, old_handler);
+
+  return(ret_code);
+}
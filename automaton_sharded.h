@@ -0,0 +1,79 @@
+/******************************************************************************/
+/* The most worker processes which a sharded build may be split across.       */
+/******************************************************************************/
+#define MAX_SHARD_WORKERS 64
+
+/******************************************************************************/
+/* The value a worker stores in its index for a state it has found but which  */
+/* the coordinator hasn't yet given an id.                                    */
+/******************************************************************************/
+#define SHARD_PENDING_STATE -2
+
+/******************************************************************************/
+/* Group: BUILD_AUTOMATON_SHARDED_RET_CODES                                   */
+/*                                                                            */
+/* The return codes for function build_automaton_sharded and for the          */
+/* functions run by the coordinator and the workers.                          */
+/******************************************************************************/
+#define BUILD_AUTOMATON_SHARDED_OK              0
+#define BUILD_AUTOMATON_SHARDED_MEM_ERR         1
+#define BUILD_AUTOMATON_SHARDED_WORKER_ERR      2
+#define BUILD_AUTOMATON_SHARDED_TOO_MANY_STATES 3
+
+/******************************************************************************/
+/* This structure holds one worker of a sharded build. The worker owns every  */
+/* state whose bitset hashes to its shard and knows the id of each of them.   */
+/* index - Maps the bitset of each owned state to its id (or to               */
+/*         SHARD_PENDING_STATE).                                              */
+/* frontier - The owned states found in the last level as (bitset, id).       */
+/* candidates - The states reached from any frontier which hash to this       */
+/*              shard, as (bitset, state id * num_generators + generator).    */
+/* new_states - The owned states first found in this level, as (bitset, id)   */
+/*              in bitset order. The ids are filled in by the coordinator.    */
+/* state_ids - The ids sent back by the coordinator.                          */
+/* transitions - (state id * num_generators + generator, next state id) for   */
+/*               each candidate.                                              */
+/******************************************************************************/
+typedef struct shard_worker
+{
+  ROOT_ACTION_TABLE *action_table;
+  int shard;
+  int num_shards;
+  FILE *from_coordinator;
+  FILE *to_coordinator;
+  ROOT_BITSET_INDEX *index;
+  RECORD_BUFFER *frontier;
+  RECORD_BUFFER *candidates;
+  RECORD_BUFFER *new_states;
+  RECORD_BUFFER *state_ids;
+  RECORD_BUFFER *transitions;
+  char *swap_record;
+} SHARD_WORKER;
+
+/******************************************************************************/
+/* This structure holds the coordinator of a sharded build, which routes      */
+/* candidate states to the worker owning them, numbers the new states of each */
+/* level and collects the transition table.                                   */
+/* routed[w] - The candidates to be sent to worker w.                         */
+/* new_states[w] - The new states found by worker w in bitset order.          */
+/* state_ids[w] - The ids given to the new states of worker w.                */
+/* received_states - The last candidates read from a worker.                  */
+/* received_transitions - The last transitions read from a worker.            */
+/* table_capacity - The number of rows allocated in the table.                */
+/******************************************************************************/
+typedef struct sharded_build
+{
+  ROOT_ACTION_TABLE *action_table;
+  int num_workers;
+  pid_t *pids;
+  FILE **to_workers;
+  FILE **from_workers;
+  RECORD_BUFFER **routed;
+  RECORD_BUFFER **new_states;
+  RECORD_BUFFER **state_ids;
+  RECORD_BUFFER *received_states;
+  RECORD_BUFFER *received_transitions;
+  long *merge_positions;
+  AUTOMATON_TABLE *table;
+  long table_capacity;
+} SHARDED_BUILD;
@@ -0,0 +1,229 @@
+#include "cox_prot.h"
+
+/******************************************************************************/
+/* Function: init_sink_automaton                                              */
+/*                                                                            */
+/* Returns: One of INIT_SINK_AUTOMATON_RET_CODES.                             */
+/*                                                                            */
+/* Parameters: IN     table - The compiled automaton.                         */
+/*             OUT    sink - Will be returned holding the automaton with the  */
+/*                           sink state added.                                */
+/*                                                                            */
+/* Operation: Copy the table with one more row for the sink, turning each     */
+/*            state into the offset of its row and each transition to the     */
+/*            reject state into one to the sink.                              */
+/******************************************************************************/
+int init_sink_automaton(AUTOMATON_TABLE *table, SINK_AUTOMATON **sink)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = INIT_SINK_AUTOMATON_OK;
+  int num_generators = table->num_generators;
+  int32_t target;
+  long ii;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(table != NULL);
+  assert(sink != NULL);
+
+  *sink = NULL;
+  if ((table->num_states + 1) * num_generators > INT32_MAX)
+  {
+    ret_code = INIT_SINK_AUTOMATON_TOO_MANY_STATES;
+    goto EXIT_LABEL;
+  }
+
+  *sink = (SINK_AUTOMATON *) malloc(sizeof(SINK_AUTOMATON));
+  if (*sink == NULL)
+  {
+    ret_code = INIT_SINK_AUTOMATON_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  (*sink)->num_states = table->num_states + 1;
+  (*sink)->num_generators = num_generators;
+  (*sink)->start_offset = table->start_state * num_generators;
+  (*sink)->sink_offset = (int32_t) (table->num_states * num_generators);
+  (*sink)->transitions = (int32_t *) malloc(sizeof(int32_t) *
+                                            (*sink)->num_states *
+                                            num_generators);
+  if ((*sink)->transitions == NULL)
+  {
+    free(*sink);
+    *sink = NULL;
+    ret_code = INIT_SINK_AUTOMATON_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  for (ii = 0; ii < table->num_states * num_generators; ii++)
+  {
+    target = table->transitions[ii];
+    (*sink)->transitions[ii] = (target == AUTOMATON_TABLE_REJECT_STATE) ?
+                                  (*sink)->sink_offset :
+                                  target * num_generators;
+  }
+  for (ii = 0; ii < num_generators; ii++)
+  {
+    (*sink)->transitions[(*sink)->sink_offset + ii] = (*sink)->sink_offset;
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: free_sink_automaton                                              */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     sink - The automaton to be freed.                       */
+/*                                                                            */
+/* Operation: Free the transitions and then the structure itself.             */
+/******************************************************************************/
+void free_sink_automaton(SINK_AUTOMATON *sink)
+{
+  assert(sink != NULL);
+
+  free(sink->transitions);
+  free(sink);
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: is_reduced_sink                                                  */
+/*                                                                            */
+/* Returns: true if the word is reduced and false otherwise.                  */
+/*                                                                            */
+/* Parameters: IN     sink - The automaton with a sink state.                 */
+/*             IN     word - A string consisting of a number of letters which */
+/*                           correspond to generators in the group.           */
+/*             OUT    fail_index - The index in the word that the word was no */
+/*                                 longer reduced. 0 if the word was reduced. */
+/*             IN     start_index - The first letter to be read.              */
+/*             IN     finish_index - One past the last letter to be read. If  */
+/*                                   this is less than start_index then the   */
+/*                                   word is read from right to left.         */
+/*                                                                            */
+/* Operation: The same as is_reduced_table. The word is read                  */
+/*            SINK_SCAN_BLOCK_LENGTH letters at a time with no test between   */
+/*            them, as the sink can't be left, and the state is only checked  */
+/*            at the end of each block. The letters after the last whole      */
+/*            block are read the same way. Only if a block ends in the sink   */
+/*            is it read again from the state it started in, a letter at a    */
+/*            time, to find the letter the word failed at.                    */
+/******************************************************************************/
+bool is_reduced_sink(SINK_AUTOMATON *sink,
+                     char *word,
+                     int *fail_index,
+                     int start_index,
+                     int finish_index)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  bool reduced = true;
+  const int32_t *transitions = sink->transitions;
+  int32_t sink_offset = sink->sink_offset;
+  int32_t curr;
+  int32_t block_start;
+  int direction;
+  int remaining;
+  int ii = start_index;
+  int jj;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(sink != NULL);
+  assert(word != NULL);
+
+  /****************************************************************************/
+  /* Work out which way through the word we are going.                        */
+  /****************************************************************************/
+  if (finish_index > start_index)
+  {
+    direction = SEARCH_FORWARDS;
+    remaining = finish_index - start_index;
+  }
+  else if (finish_index < start_index)
+  {
+    direction = SEARCH_BACKWARDS;
+    remaining = start_index - finish_index;
+  }
+  else
+  {
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* Read whole blocks, checking for the sink once per block.                 */
+  /****************************************************************************/
+  curr = sink->start_offset;
+  block_start = curr;
+  while (remaining >= SINK_SCAN_BLOCK_LENGTH)
+  {
+    block_start = curr;
+    curr = transitions[curr + word[ii] - ASCII_LOWER_A];
+    curr = transitions[curr + word[ii + direction] - ASCII_LOWER_A];
+    curr = transitions[curr + word[ii + 2 * direction] - ASCII_LOWER_A];
+    curr = transitions[curr + word[ii + 3 * direction] - ASCII_LOWER_A];
+    curr = transitions[curr + word[ii + 4 * direction] - ASCII_LOWER_A];
+    curr = transitions[curr + word[ii + 5 * direction] - ASCII_LOWER_A];
+    curr = transitions[curr + word[ii + 6 * direction] - ASCII_LOWER_A];
+    curr = transitions[curr + word[ii + 7 * direction] - ASCII_LOWER_A];
+    if (curr == sink_offset)
+    {
+      break;
+    }
+    ii += SINK_SCAN_BLOCK_LENGTH * direction;
+    remaining -= SINK_SCAN_BLOCK_LENGTH;
+  }
+
+  /****************************************************************************/
+  /* Read the letters after the last whole block, again with one check.       */
+  /****************************************************************************/
+  if (curr != sink_offset)
+  {
+    block_start = curr;
+    for (jj = 0; jj < remaining; jj++)
+    {
+      curr = transitions[curr + word[ii + jj * direction] - ASCII_LOWER_A];
+    }
+  }
+
+  /****************************************************************************/
+  /* The word isn't reduced, so read the block that ended in the sink again   */
+  /* one letter at a time to find where it failed.                            */
+  /****************************************************************************/
+  if (curr == sink_offset)
+  {
+    reduced = false;
+    curr = block_start;
+    while (true)
+    {
+      curr = transitions[curr + word[ii] - ASCII_LOWER_A];
+      if (curr == sink_offset)
+      {
+        goto EXIT_LABEL;
+      }
+      ii += direction;
+    }
+  }
+
+EXIT_LABEL:
+
+  if (reduced == false)
+  {
+    *fail_index = ii;
+  }
+  else
+  {
+    *fail_index = 0;
+  }
+
+  return(reduced);
+}
@@ -0,0 +1,33 @@
+/******************************************************************************/
+/* Group: INIT_SINK_AUTOMATON_RET_CODES                                       */
+/*                                                                            */
+/* The return codes for function init_sink_automaton.                         */
+/******************************************************************************/
+#define INIT_SINK_AUTOMATON_OK              0
+#define INIT_SINK_AUTOMATON_MEM_ERR         1
+#define INIT_SINK_AUTOMATON_TOO_MANY_STATES 2
+
+/******************************************************************************/
+/* The number of letters read between checks for the sink state.              */
+/******************************************************************************/
+#define SINK_SCAN_BLOCK_LENGTH 8
+
+/******************************************************************************/
+/* This structure is a copy of AUTOMATON_TABLE laid out for scanning without  */
+/* a branch per letter.                                                       */
+/* Sink state: An extra state is added after the others and every            */
+/*       transition to the reject state goes to it instead. Every transition  */
+/*       out of it leads back to it, so once a word stops being reduced the   */
+/*       scan stays in the sink and only needs to look for it now and again.  */
+/* Row offsets: States are held as the offset of their row, state *           */
+/*       num_generators, so that reading a letter is one add and one load     */
+/*       with no multiply on the chain of dependent loads.                    */
+/******************************************************************************/
+typedef struct sink_automaton
+{
+  long num_states;
+  int num_generators;
+  int32_t start_offset;
+  int32_t sink_offset;
+  int32_t *transitions;
+} SINK_AUTOMATON;
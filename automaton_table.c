@@ -0,0 +1,1121 @@
+#include "cox_prot.h"
+
+/******************************************************************************/
+/* Function: init_automaton_table                                             */
+/*                                                                            */
+/* Returns: One of INIT_AUTOMATON_TABLE_RET_CODES.                            */
+/*                                                                            */
+/* Parameters: IN     num_generators - The number of group generators.        */
+/*             IN     num_states - The number of states in the automaton.     */
+/*             OUT    table - Will be returned with all necessary memory      */
+/*                            allocated.                                      */
+/*                                                                            */
+/* Operation: Allocate the table object and then the array of transitions.    */
+/*            Every transition is initially set to the reject state.          */
+/******************************************************************************/
+int init_automaton_table(int num_generators,
+                         long num_states,
+                         AUTOMATON_TABLE **table)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = INIT_AUTOMATON_TABLE_OK;
+  long ii;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(num_generators > 0);
+  assert(num_states > 0);
+
+  /****************************************************************************/
+  /* Allocate the memory for the table object itself.                         */
+  /****************************************************************************/
+  (*table) = (AUTOMATON_TABLE *) calloc(1, sizeof(AUTOMATON_TABLE));
+  if ((*table) == NULL)
+  {
+    ret_code = INIT_AUTOMATON_TABLE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* Allocate the memory for the transitions. There is one row per state and  */
+  /* one column per generator.                                                */
+  /****************************************************************************/
+  (*table)->transitions = (int32_t *) malloc(sizeof(int32_t) *
+                                             num_states *
+                                             num_generators);
+  if ((*table)->transitions == NULL)
+  {
+    free(*table);
+    (*table) = NULL;
+    ret_code = INIT_AUTOMATON_TABLE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  for (ii = 0; ii < num_states * num_generators; ii++)
+  {
+    (*table)->transitions[ii] = AUTOMATON_TABLE_REJECT_STATE;
+  }
+
+  (*table)->num_states = num_states;
+  (*table)->num_generators = num_generators;
+  (*table)->start_state = 0;
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: free_automaton_table                                             */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     table - The table to be freed.                          */
+/*                                                                            */
+/* Operation: Free the array of transitions and then the table itself.        */
+/******************************************************************************/
+void free_automaton_table(AUTOMATON_TABLE *table)
+{
+  free(table->transitions);
+  free(table);
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: compile_state_tree                                               */
+/*                                                                            */
+/* Returns: One of COMPILE_STATE_TREE_RET_CODES.                              */
+/*                                                                            */
+/* Parameters: IN     start - The first state in the state tree.              */
+/*             IN     num_generators - The number of group generators.        */
+/*             OUT    table - The flat transition table for the state tree.   */
+/*                                                                            */
+/* Operation: Walk the state tree depth first in the same order in which      */
+/*            generate_next_automaton_state created it, numbering each state  */
+/*            the first time it is found. The start state is always state 0.  */
+/*            Then fill in one row of the table for each numbered state.      */
+/******************************************************************************/
+int compile_state_tree(AUTOMATON_STATE *start,
+                       int num_generators,
+                       AUTOMATON_TABLE **table)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = COMPILE_STATE_TREE_OK;
+  int ret_val;
+  long num_states = 0;
+  long max_states = 64;
+  long stack_depth = 0;
+  long ii;
+  int jj;
+  int generator;
+  AUTOMATON_STATE **states = NULL;
+  AUTOMATON_STATE **stack_states = NULL;
+  int *stack_generators = NULL;
+  AUTOMATON_STATE **new_states;
+  AUTOMATON_STATE **new_stack_states;
+  int *new_stack_generators;
+  AUTOMATON_STATE *curr;
+  AUTOMATON_STATE *next;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(start != NULL);
+  assert(num_generators > 0);
+
+  /****************************************************************************/
+  /* Allocate the arrays used to hold the numbered states and the stack used  */
+  /* to walk the tree. These are grown as necessary.                          */
+  /****************************************************************************/
+  states = (AUTOMATON_STATE **) malloc(sizeof(AUTOMATON_STATE *) * max_states);
+  stack_states = (AUTOMATON_STATE **)
+                                 malloc(sizeof(AUTOMATON_STATE *) * max_states);
+  stack_generators = (int *) malloc(sizeof(int) * max_states);
+  if (states == NULL || stack_states == NULL || stack_generators == NULL)
+  {
+    ret_code = COMPILE_STATE_TREE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* The start state is numbered first and is the bottom of the stack.        */
+  /****************************************************************************/
+  start->state_id = num_states;
+  states[num_states++] = start;
+  stack_states[stack_depth] = start;
+  stack_generators[stack_depth] = 0;
+  stack_depth++;
+
+  /****************************************************************************/
+  /* Each stack frame holds a state and the next generator to follow from it. */
+  /* When a state which has not been numbered is found it is numbered and     */
+  /* pushed so that its branch is followed before its siblings.               */
+  /****************************************************************************/
+  while (stack_depth > 0)
+  {
+    curr = stack_states[stack_depth - 1];
+    generator = stack_generators[stack_depth - 1];
+
+    if (generator == num_generators)
+    {
+      stack_depth--;
+      continue;
+    }
+    stack_generators[stack_depth - 1]++;
+
+    next = curr->next_states[generator];
+    if (next == NULL || next->state_id != -1)
+    {
+      continue;
+    }
+
+    /**************************************************************************/
+    /* Grow the arrays if they are full. The stack can never be deeper than   */
+    /* the number of states so they grow together.                            */
+    /**************************************************************************/
+    if (num_states == max_states)
+    {
+      max_states *= 2;
+      new_states = (AUTOMATON_STATE **)
+                      realloc(states, sizeof(AUTOMATON_STATE *) * max_states);
+      if (new_states == NULL)
+      {
+        ret_code = COMPILE_STATE_TREE_MEM_ERR;
+        goto EXIT_LABEL;
+      }
+      states = new_states;
+
+      new_stack_states = (AUTOMATON_STATE **)
+                 realloc(stack_states, sizeof(AUTOMATON_STATE *) * max_states);
+      if (new_stack_states == NULL)
+      {
+        ret_code = COMPILE_STATE_TREE_MEM_ERR;
+        goto EXIT_LABEL;
+      }
+      stack_states = new_stack_states;
+
+      new_stack_generators = (int *) realloc(stack_generators,
+                                             sizeof(int) * max_states);
+      if (new_stack_generators == NULL)
+      {
+        ret_code = COMPILE_STATE_TREE_MEM_ERR;
+        goto EXIT_LABEL;
+      }
+      stack_generators = new_stack_generators;
+    }
+
+    next->state_id = num_states;
+    states[num_states++] = next;
+    stack_states[stack_depth] = next;
+    stack_generators[stack_depth] = 0;
+    stack_depth++;
+  }
+
+  /****************************************************************************/
+  /* Now that the number of states is known create the table and fill in a    */
+  /* row for each state. A NULL next state is the reject state.               */
+  /****************************************************************************/
+  ret_val = init_automaton_table(num_generators, num_states, table);
+  if (ret_val != INIT_AUTOMATON_TABLE_OK)
+  {
+    ret_code = COMPILE_STATE_TREE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  for (ii = 0; ii < num_states; ii++)
+  {
+    for (jj = 0; jj < num_generators; jj++)
+    {
+      next = states[ii]->next_states[jj];
+      if (next != NULL)
+      {
+        (*table)->transitions[ii * num_generators + jj] =
+                                                      (int32_t) next->state_id;
+      }
+    }
+  }
+  (*table)->start_state = (int32_t) start->state_id;
+
+EXIT_LABEL:
+
+  free(states);
+  free(stack_states);
+  free(stack_generators);
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: minimise_automaton_table                                         */
+/*                                                                            */
+/* Returns: One of MINIMISE_AUTOMATON_TABLE_RET_CODES.                        */
+/*                                                                            */
+/* Parameters: IN     table - The automaton to be minimised.                  */
+/*             OUT    minimal_table - The minimal automaton accepting the     */
+/*                                    same language as table.                 */
+/*             OUT    state_map - An array with one entry per state in table  */
+/*                                giving the state in minimal_table that it   */
+/*                                was merged into. May be NULL if the mapping */
+/*                                is not wanted. The caller must free it.     */
+/*                                                                            */
+/* Operation: Hopcroft partition refinement. The reject state is added as an  */
+/*            explicit non-accepting state so that the automaton is complete. */
+/*            The states start in two blocks, accepting and reject, and a     */
+/*            block is split whenever some of its states move into a          */
+/*            splitter block on a generator and some do not. Only the smaller */
+/*            half of a split is added to the list of splitters unless the    */
+/*            block being split was already waiting to be used, which gives   */
+/*            the O(n log n) running time.                                    */
+/*            The blocks which remain are the states of the minimal automaton */
+/*            and are numbered in order of their lowest original state so     */
+/*            that the start state stays as state 0.                          */
+/******************************************************************************/
+int minimise_automaton_table(AUTOMATON_TABLE *table,
+                             AUTOMATON_TABLE **minimal_table,
+                             long **state_map)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = MINIMISE_AUTOMATON_TABLE_OK;
+  int ret_val;
+  int num_generators = table->num_generators;
+  long num_states = table->num_states + 1;
+  long reject = table->num_states;
+  long num_blocks;
+  long num_minimal_states;
+  long worklist_size = 0;
+  long num_predecessors;
+  long num_touched;
+  long ii;
+  long jj;
+  long state;
+  long target;
+  long position;
+  long swap_state;
+  long block;
+  long new_block;
+  long smaller_block;
+  long splitter;
+  int generator;
+  int gg;
+  long *inverse_offsets = NULL;
+  long *inverse_sources = NULL;
+  long *elements = NULL;
+  long *locations = NULL;
+  long *block_of = NULL;
+  long *block_first = NULL;
+  long *block_end = NULL;
+  long *marked = NULL;
+  long *touched = NULL;
+  long *predecessors = NULL;
+  long *worklist_blocks = NULL;
+  int *worklist_generators = NULL;
+  char *in_worklist = NULL;
+  long *minimal_ids = NULL;
+  long *map = NULL;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(table != NULL);
+  assert(minimal_table != NULL);
+
+  /****************************************************************************/
+  /* Allocate all of the working memory in one go.                            */
+  /****************************************************************************/
+  inverse_offsets = (long *) calloc(num_states * num_generators + 1,
+                                    sizeof(long));
+  inverse_sources = (long *) malloc(sizeof(long) * num_states * num_generators);
+  elements = (long *) malloc(sizeof(long) * num_states);
+  locations = (long *) malloc(sizeof(long) * num_states);
+  block_of = (long *) malloc(sizeof(long) * num_states);
+  block_first = (long *) malloc(sizeof(long) * num_states);
+  block_end = (long *) malloc(sizeof(long) * num_states);
+  marked = (long *) calloc(num_states, sizeof(long));
+  touched = (long *) malloc(sizeof(long) * num_states);
+  predecessors = (long *) malloc(sizeof(long) * num_states);
+  worklist_blocks = (long *) malloc(sizeof(long) * num_states * num_generators);
+  worklist_generators = (int *) malloc(sizeof(int) *
+                                       num_states *
+                                       num_generators);
+  in_worklist = (char *) calloc(num_states * num_generators, sizeof(char));
+  minimal_ids = (long *) malloc(sizeof(long) * num_states);
+  map = (long *) malloc(sizeof(long) * table->num_states);
+  if (inverse_offsets == NULL || inverse_sources == NULL ||
+      elements == NULL || locations == NULL || block_of == NULL ||
+      block_first == NULL || block_end == NULL || marked == NULL ||
+      touched == NULL || predecessors == NULL || worklist_blocks == NULL ||
+      worklist_generators == NULL || in_worklist == NULL ||
+      minimal_ids == NULL || map == NULL)
+  {
+    ret_code = MINIMISE_AUTOMATON_TABLE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* Build the inverse transitions. For generator g and state t the states    */
+  /* which move to t on g are held in inverse_sources between                 */
+  /* inverse_offsets[g * num_states + t] and the following offset. The reject */
+  /* state moves to itself on every generator.                                */
+  /****************************************************************************/
+  for (state = 0; state < num_states; state++)
+  {
+    for (gg = 0; gg < num_generators; gg++)
+    {
+      if (state == reject)
+      {
+        target = reject;
+      }
+      else
+      {
+        target = table->transitions[state * num_generators + gg];
+        if (target == AUTOMATON_TABLE_REJECT_STATE)
+        {
+          target = reject;
+        }
+      }
+      inverse_offsets[gg * num_states + target + 1]++;
+    }
+  }
+  for (ii = 0; ii < num_states * num_generators; ii++)
+  {
+    inverse_offsets[ii + 1] += inverse_offsets[ii];
+  }
+  /****************************************************************************/
+  /* Place the sources now that the offsets are known. The marked array is    */
+  /* not needed until the refinement starts so use it to count how many       */
+  /* sources have been placed for each target so far.                         */
+  /****************************************************************************/
+  for (gg = 0; gg < num_generators; gg++)
+  {
+    for (state = 0; state < num_states; state++)
+    {
+      marked[state] = 0;
+    }
+    for (state = 0; state < num_states; state++)
+    {
+      if (state == reject)
+      {
+        target = reject;
+      }
+      else
+      {
+        target = table->transitions[state * num_generators + gg];
+        if (target == AUTOMATON_TABLE_REJECT_STATE)
+        {
+          target = reject;
+        }
+      }
+      inverse_sources[inverse_offsets[gg * num_states + target] +
+                      marked[target]] = state;
+      marked[target]++;
+    }
+  }
+  for (state = 0; state < num_states; state++)
+  {
+    marked[state] = 0;
+  }
+
+  /****************************************************************************/
+  /* The initial partition. Block 0 holds every accepting state and block 1   */
+  /* holds the reject state. The states of a block are held contiguously in   */
+  /* the elements array between block_first and block_end.                    */
+  /****************************************************************************/
+  for (state = 0; state < num_states; state++)
+  {
+    elements[state] = state;
+    locations[state] = state;
+    block_of[state] = (state == reject) ? 1 : 0;
+  }
+  block_first[0] = 0;
+  block_end[0] = reject;
+  block_first[1] = reject;
+  block_end[1] = num_states;
+  num_blocks = 2;
+
+  /****************************************************************************/
+  /* It is enough to start with the smaller of the two blocks as a splitter   */
+  /* for every generator.                                                     */
+  /****************************************************************************/
+  smaller_block = (block_end[0] - block_first[0] <
+                   block_end[1] - block_first[1]) ? 0 : 1;
+  for (gg = 0; gg < num_generators; gg++)
+  {
+    worklist_blocks[worklist_size] = smaller_block;
+    worklist_generators[worklist_size] = gg;
+    worklist_size++;
+    in_worklist[smaller_block * num_generators + gg] = 1;
+  }
+
+  /****************************************************************************/
+  /* Refine the partition until there are no splitters left.                  */
+  /****************************************************************************/
+  while (worklist_size > 0)
+  {
+    worklist_size--;
+    splitter = worklist_blocks[worklist_size];
+    generator = worklist_generators[worklist_size];
+    in_worklist[splitter * num_generators + generator] = 0;
+
+    /**************************************************************************/
+    /* Collect every state which moves into the splitter on the generator.    */
+    /* Each state has exactly one successor on a generator so there are no    */
+    /* duplicates. This is done before any marking as the splitter itself may */
+    /* be split below.                                                        */
+    /**************************************************************************/
+    num_predecessors = 0;
+    for (ii = block_first[splitter]; ii < block_end[splitter]; ii++)
+    {
+      target = elements[ii];
+      for (jj = inverse_offsets[generator * num_states + target];
+           jj < inverse_offsets[generator * num_states + target + 1];
+           jj++)
+      {
+        predecessors[num_predecessors++] = inverse_sources[jj];
+      }
+    }
+
+    /**************************************************************************/
+    /* Mark each predecessor by moving it to the front of its block. Remember */
+    /* which blocks have been touched.                                        */
+    /**************************************************************************/
+    num_touched = 0;
+    for (ii = 0; ii < num_predecessors; ii++)
+    {
+      state = predecessors[ii];
+      block = block_of[state];
+      if (marked[block] == 0)
+      {
+        touched[num_touched++] = block;
+      }
+
+      position = block_first[block] + marked[block];
+      swap_state = elements[position];
+      elements[position] = state;
+      elements[locations[state]] = swap_state;
+      locations[swap_state] = locations[state];
+      locations[state] = position;
+      marked[block]++;
+    }
+
+    /**************************************************************************/
+    /* Split each touched block into its marked and unmarked parts unless all */
+    /* of the block was marked.                                               */
+    /**************************************************************************/
+    for (ii = 0; ii < num_touched; ii++)
+    {
+      block = touched[ii];
+      if (marked[block] == block_end[block] - block_first[block])
+      {
+        marked[block] = 0;
+        continue;
+      }
+
+      new_block = num_blocks++;
+      block_first[new_block] = block_first[block];
+      block_end[new_block] = block_first[block] + marked[block];
+      block_first[block] = block_end[new_block];
+      marked[block] = 0;
+      for (jj = block_first[new_block]; jj < block_end[new_block]; jj++)
+      {
+        block_of[elements[jj]] = new_block;
+      }
+
+      /************************************************************************/
+      /* If the old block was waiting to be used as a splitter then both      */
+      /* halves must be used. Otherwise only the smaller half is needed.      */
+      /************************************************************************/
+      if (block_end[new_block] - block_first[new_block] <
+                                          block_end[block] - block_first[block])
+      {
+        smaller_block = new_block;
+      }
+      else
+      {
+        smaller_block = block;
+      }
+      for (gg = 0; gg < num_generators; gg++)
+      {
+        if (in_worklist[block * num_generators + gg])
+        {
+          splitter = new_block;
+        }
+        else
+        {
+          splitter = smaller_block;
+        }
+        worklist_blocks[worklist_size] = splitter;
+        worklist_generators[worklist_size] = gg;
+        worklist_size++;
+        in_worklist[splitter * num_generators + gg] = 1;
+      }
+    }
+  }
+
+  /****************************************************************************/
+  /* Number the blocks which contain accepting states in order of the lowest  */
+  /* original state they contain.                                             */
+  /****************************************************************************/
+  for (block = 0; block < num_blocks; block++)
+  {
+    minimal_ids[block] = -1;
+  }
+  num_minimal_states = 0;
+  for (state = 0; state < table->num_states; state++)
+  {
+    block = block_of[state];
+    if (minimal_ids[block] == -1)
+    {
+      minimal_ids[block] = num_minimal_states++;
+    }
+    map[state] = minimal_ids[block];
+  }
+
+  /****************************************************************************/
+  /* Create the minimal table. Any state in a block can be used to fill in    */
+  /* the row for that block as they all behave identically.                   */
+  /****************************************************************************/
+  ret_val = init_automaton_table(num_generators,
+                                 num_minimal_states,
+                                 minimal_table);
+  if (ret_val != INIT_AUTOMATON_TABLE_OK)
+  {
+    ret_code = MINIMISE_AUTOMATON_TABLE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  for (state = 0; state < table->num_states; state++)
+  {
+    for (gg = 0; gg < num_generators; gg++)
+    {
+      target = table->transitions[state * num_generators + gg];
+      if (target != AUTOMATON_TABLE_REJECT_STATE)
+      {
+        target = map[target];
+      }
+      (*minimal_table)->transitions[map[state] * num_generators + gg] =
+                                                              (int32_t) target;
+    }
+  }
+  (*minimal_table)->start_state = (int32_t) map[table->start_state];
+
+  /****************************************************************************/
+  /* Hand the state mapping back to the caller if it was asked for.           */
+  /****************************************************************************/
+  if (state_map != NULL)
+  {
+    (*state_map) = map;
+    map = NULL;
+  }
+
+EXIT_LABEL:
+
+  free(inverse_offsets);
+  free(inverse_sources);
+  free(elements);
+  free(locations);
+  free(block_of);
+  free(block_first);
+  free(block_end);
+  free(marked);
+  free(touched);
+  free(predecessors);
+  free(worklist_blocks);
+  free(worklist_generators);
+  free(in_worklist);
+  free(minimal_ids);
+  free(map);
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: compile_root_action_subset                                       */
+/*                                                                            */
+/* Returns: One of COMPILE_ROOT_ACTION_TABLE_RET_CODES.                       */
+/*                                                                            */
+/* Parameters: IN     action_table - The action of the generators on the      */
+/*                                   minimal roots.                           */
+/*             IN     start_roots - The bitset of roots for the start state.  */
+/*                                  NULL for the empty set.                   */
+/*             IN     num_subset_generators - The number of generators the    */
+/*                                            automaton reads.                */
+/*             IN     subset_generators - The generators the automaton reads. */
+/*                                        Column i of the table is for        */
+/*                                        generator subset_generators[i].     */
+/*                                        NULL for every generator in order.  */
+/*             OUT    table - Will be returned holding the automaton.         */
+/*                                                                            */
+/* Operation: Build the automaton in memory breadth first with each state     */
+/*            held as a bitset of roots. States are numbered in the order     */
+/*            they are found. This follows whatever roots the action table    */
+/*            adds on each generator, so it builds the ShortLex automaton if  */
+/*            add_shortlex_roots has been called.                             */
+/******************************************************************************/
+int compile_root_action_subset(ROOT_ACTION_TABLE *action_table,
+                               uint64_t *start_roots,
+                               int num_subset_generators,
+                               int *subset_generators,
+                               AUTOMATON_TABLE **table)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = COMPILE_ROOT_ACTION_TABLE_OK;
+  int num_generators = num_subset_generators;
+  int num_words = action_table->num_words;
+  uint64_t *next_set = NULL;
+  uint64_t *current_set;
+  int32_t *row = NULL;
+  RECORD_BUFFER *sets = NULL;
+  RECORD_BUFFER *rows = NULL;
+  ROOT_BITSET_INDEX *index = NULL;
+  int64_t next_state;
+  long current;
+  int generator;
+  int gg;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(action_table != NULL);
+  assert(num_subset_generators > 0);
+  assert(table != NULL);
+
+  /****************************************************************************/
+  /* Allocate the working memory.                                             */
+  /****************************************************************************/
+  next_set = (uint64_t *) calloc(num_words, sizeof(uint64_t));
+  row = (int32_t *) malloc(sizeof(int32_t) * num_generators);
+  if (next_set == NULL || row == NULL ||
+      init_record_buffer(sizeof(uint64_t) * num_words,
+                         &sets) != RECORD_BUFFER_OK ||
+      init_record_buffer(sizeof(int32_t) * num_generators,
+                         &rows) != RECORD_BUFFER_OK ||
+      init_root_bitset_index(num_words, &index) != ROOT_BITSET_INDEX_OK)
+  {
+    ret_code = COMPILE_ROOT_ACTION_TABLE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* Add the start state.                                                     */
+  /****************************************************************************/
+  if (start_roots != NULL)
+  {
+    memcpy(next_set, start_roots, sizeof(uint64_t) * num_words);
+  }
+  if (append_record(sets, next_set) != RECORD_BUFFER_OK ||
+      set_in_root_bitset_index(index, next_set, 0) != ROOT_BITSET_INDEX_OK)
+  {
+    ret_code = COMPILE_ROOT_ACTION_TABLE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* Work through the states in the order they are found, adding any new      */
+  /* state reached to the end. Adding a state may move the array so find the  */
+  /* current state afresh each time.                                          */
+  /****************************************************************************/
+  for (current = 0; current < sets->num_records; current++)
+  {
+    for (gg = 0; gg < num_generators; gg++)
+    {
+      current_set = (uint64_t *) (sets->records + current * sets->record_size);
+      generator = (subset_generators != NULL) ? subset_generators[gg] : gg;
+      if (!root_bitset_next_state(action_table,
+                                  current_set,
+                                  generator,
+                                  next_set))
+      {
+        row[gg] = AUTOMATON_TABLE_REJECT_STATE;
+      }
+      else if (find_in_root_bitset_index(index, next_set, &next_state))
+      {
+        row[gg] = (int32_t) next_state;
+      }
+      else
+      {
+        if (sets->num_records >= INT32_MAX)
+        {
+          ret_code = COMPILE_ROOT_ACTION_TABLE_TOO_MANY_STATES;
+          goto EXIT_LABEL;
+        }
+        row[gg] = (int32_t) sets->num_records;
+        if (set_in_root_bitset_index(index,
+                                     next_set,
+                                     sets->num_records) !=
+                                                        ROOT_BITSET_INDEX_OK ||
+            append_record(sets, next_set) != RECORD_BUFFER_OK)
+        {
+          ret_code = COMPILE_ROOT_ACTION_TABLE_MEM_ERR;
+          goto EXIT_LABEL;
+        }
+      }
+    }
+    if (append_record(rows, row) != RECORD_BUFFER_OK)
+    {
+      ret_code = COMPILE_ROOT_ACTION_TABLE_MEM_ERR;
+      goto EXIT_LABEL;
+    }
+  }
+
+  /****************************************************************************/
+  /* Copy the rows into a table of the right size.                            */
+  /****************************************************************************/
+  if (init_automaton_table(num_generators,
+                           rows->num_records,
+                           table) != INIT_AUTOMATON_TABLE_OK)
+  {
+    ret_code = COMPILE_ROOT_ACTION_TABLE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  memcpy((*table)->transitions,
+         rows->records,
+         rows->record_size * rows->num_records);
+
+EXIT_LABEL:
+
+  free(next_set);
+  free(row);
+  if (sets != NULL)
+  {
+    free_record_buffer(sets);
+  }
+  if (rows != NULL)
+  {
+    free_record_buffer(rows);
+  }
+  if (index != NULL)
+  {
+    free_root_bitset_index(index);
+  }
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: compile_root_action_table                                        */
+/*                                                                            */
+/* Returns: One of COMPILE_ROOT_ACTION_TABLE_RET_CODES.                       */
+/*                                                                            */
+/* Parameters: IN     action_table - The action of the generators on the      */
+/*                                   minimal roots.                           */
+/*             IN     start_roots - The bitset of roots for the start state.  */
+/*                                  NULL for the empty set.                   */
+/*             OUT    table - Will be returned holding the automaton.         */
+/*                                                                            */
+/* Operation: Build the automaton reading every generator.                    */
+/******************************************************************************/
+int compile_root_action_table(ROOT_ACTION_TABLE *action_table,
+                              uint64_t *start_roots,
+                              AUTOMATON_TABLE **table)
+{
+  return(compile_root_action_subset(action_table,
+                                    start_roots,
+                                    action_table->num_generators,
+                                    NULL,
+                                    table));
+}
+
+/******************************************************************************/
+/* Function: compile_coset_automaton                                          */
+/*                                                                            */
+/* Returns: One of COMPILE_ROOT_ACTION_TABLE_RET_CODES.                       */
+/*                                                                            */
+/* Parameters: IN     action_table - The action of the generators on the      */
+/*                                   minimal roots.                           */
+/*             IN     subset - The letters of the generators in J.            */
+/*             OUT    table - Will be returned holding the automaton.         */
+/*                                                                            */
+/* Operation: An element w is the shortest in its coset w W_J exactly when no */
+/*            generator in J is a right descent of w. Read from right to      */
+/*            left, a reduced word for such a w must never reach a point      */
+/*            where a generator t in J followed by the letters read so far is */
+/*            not reduced. That fails when alpha_t is carried to the simple   */
+/*            root of the next letter, just as alpha_s is for a letter s      */
+/*            which was read, so the start state is simply the set of simple  */
+/*            roots for J.                                                    */
+/*            The automaton accepts the reduced words of the minimal coset    */
+/*            representatives read from right to left. Read from left to      */
+/*            right it accepts the reduced words of the shortest elements of  */
+/*            the cosets W_J w. Either way the words of each length are in    */
+/*            one to one correspondence with the reduced words of the         */
+/*            representatives of that length.                                 */
+/*            If add_shortlex_roots has been called on the action table then  */
+/*            only the ShortLex normal form of each element of the cosets     */
+/*            W_J w is accepted, so there is one word per representative and  */
+/*            count_accepted_words counts the representatives themselves.     */
+/******************************************************************************/
+int compile_coset_automaton(ROOT_ACTION_TABLE *action_table,
+                            char *subset,
+                            AUTOMATON_TABLE **table)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = COMPILE_ROOT_ACTION_TABLE_OK;
+  uint64_t *start_roots = NULL;
+  long root_id;
+  int generator;
+  int ii;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(action_table != NULL);
+  assert(subset != NULL);
+
+  start_roots = (uint64_t *) calloc(action_table->num_words, sizeof(uint64_t));
+  if (start_roots == NULL)
+  {
+    ret_code = COMPILE_ROOT_ACTION_TABLE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  for (ii = 0; subset[ii] != '\0'; ii++)
+  {
+    generator = (int) subset[ii] - ASCII_LOWER_A;
+    assert(generator >= 0 && generator < action_table->num_generators);
+    root_id = action_table->simple_root_ids[generator];
+    start_roots[root_id / ROOT_BITSET_WORD_BITS] |=
+                            ((uint64_t) 1) << (root_id % ROOT_BITSET_WORD_BITS);
+  }
+
+  ret_code = compile_root_action_table(action_table, start_roots, table);
+
+EXIT_LABEL:
+
+  free(start_roots);
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: count_accepted_words                                             */
+/*                                                                            */
+/* Returns: One of COUNT_ACCEPTED_WORDS_RET_CODES.                            */
+/*                                                                            */
+/* Parameters: IN     table - The automaton.                                  */
+/*             IN     max_length - The longest words to count.                */
+/*             OUT    counts - An array of max_length + 1 entries. Entry n is */
+/*                             returned holding the number of words of length */
+/*                             n which the automaton accepts.                 */
+/*                                                                            */
+/* Operation: Keep the number of accepted words of the current length which   */
+/*            end in each state, and push these along every transition to get */
+/*            the numbers for the next length. For the ShortLex automaton     */
+/*            these are the numbers of group elements of each length.         */
+/*            The counts are not checked for overflow.                        */
+/******************************************************************************/
+int count_accepted_words(AUTOMATON_TABLE *table,
+                         int max_length,
+                         uint64_t *counts)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = COUNT_ACCEPTED_WORDS_OK;
+  int num_generators = table->num_generators;
+  uint64_t *current_counts = NULL;
+  uint64_t *next_counts = NULL;
+  uint64_t *swap_counts;
+  int32_t target;
+  long state;
+  int length;
+  int gg;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(table != NULL);
+  assert(max_length >= 0);
+  assert(counts != NULL);
+
+  current_counts = (uint64_t *) calloc(table->num_states, sizeof(uint64_t));
+  next_counts = (uint64_t *) calloc(table->num_states, sizeof(uint64_t));
+  if (current_counts == NULL || next_counts == NULL)
+  {
+    ret_code = COUNT_ACCEPTED_WORDS_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* Only the empty word has length 0.                                        */
+  /****************************************************************************/
+  current_counts[table->start_state] = 1;
+  counts[0] = 1;
+
+  for (length = 1; length <= max_length; length++)
+  {
+    memset(next_counts, 0, sizeof(uint64_t) * table->num_states);
+    counts[length] = 0;
+    for (state = 0; state < table->num_states; state++)
+    {
+      if (current_counts[state] == 0)
+      {
+        continue;
+      }
+      for (gg = 0; gg < num_generators; gg++)
+      {
+        target = table->transitions[state * num_generators + gg];
+        if (target != AUTOMATON_TABLE_REJECT_STATE)
+        {
+          next_counts[target] += current_counts[state];
+          counts[length] += current_counts[state];
+        }
+      }
+    }
+    swap_counts = current_counts;
+    current_counts = next_counts;
+    next_counts = swap_counts;
+  }
+
+EXIT_LABEL:
+
+  free(current_counts);
+  free(next_counts);
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: is_reduced_table                                                 */
+/*                                                                            */
+/* Returns: true if the word is reduced and false otherwise.                  */
+/*                                                                            */
+/* Parameters: IN     table - The compiled automaton.                         */
+/*             IN     word - A string consisting of a number of letters which */
+/*                           correspond to generators in the group.           */
+/*             OUT    fail_index - The index in the word that the word was no */
+/*                                 longer reduced. 0 if the word was reduced. */
+/*             IN     start_index - The first letter to be read.              */
+/*             IN     finish_index - One past the last letter to be read. If  */
+/*                                   this is less than start_index then the   */
+/*                                   word is read from right to left.         */
+/*                                                                            */
+/* Operation: The same as is_reduced but moving between rows of the flat      */
+/*            table rather than following pointers between states.            */
+/******************************************************************************/
+bool is_reduced_table(AUTOMATON_TABLE *table,
+                      char *word,
+                      int *fail_index,
+                      int start_index,
+                      int finish_index)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  bool reduced = true;
+  int ii = start_index;
+  int direction;
+  int generator_index;
+  int32_t curr;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(table != NULL);
+  assert(word != NULL);
+
+  /****************************************************************************/
+  /* Work out which way through the word we are going.                        */
+  /****************************************************************************/
+  if (finish_index > start_index)
+  {
+    direction = SEARCH_FORWARDS;
+  }
+  else if (finish_index < start_index)
+  {
+    direction = SEARCH_BACKWARDS;
+  }
+  else
+  {
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* Loop through the word moving to the row for the next state each time. If */
+  /* the reject state is reached then the word is not reduced.                */
+  /****************************************************************************/
+  curr = table->start_state;
+  for (ii = start_index; ii != finish_index; ii += direction)
+  {
+    generator_index = (int) word[ii] - ASCII_LOWER_A;
+    curr = table->transitions[(long) curr * table->num_generators +
+                                                              generator_index];
+    if (curr == AUTOMATON_TABLE_REJECT_STATE)
+    {
+      reduced = false;
+      goto EXIT_LABEL;
+    }
+  }
+
+EXIT_LABEL:
+
+  if (reduced == false)
+  {
+    *fail_index = ii;
+  }
+  else
+  {
+    *fail_index = 0;
+  }
+
+  return(reduced);
+}
+
+/******************************************************************************/
+/* Function: is_reduced_generators                                            */
+/*                                                                            */
+/* Returns: true if the word is reduced and false otherwise.                  */
+/*                                                                            */
+/* Parameters: IN     table - The compiled automaton.                         */
+/*             IN     word - The word as generator indices.                   */
+/*             OUT    fail_index - The index in the word that the word was no */
+/*                                 longer reduced. 0 if the word was reduced. */
+/*                                                                            */
+/* Operation: The same as is_reduced_table reading the whole word from left   */
+/*            to right, but with the row offset taken straight from each      */
+/*            generator index.                                                */
+/******************************************************************************/
+bool is_reduced_generators(AUTOMATON_TABLE *table,
+                           GENERATOR_WORD *word,
+                           int *fail_index)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  bool reduced = true;
+  const int32_t *transitions = table->transitions;
+  int num_generators = table->num_generators;
+  int32_t curr = table->start_state;
+  int ii;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(table != NULL);
+  assert(word != NULL);
+
+  *fail_index = 0;
+  for (ii = 0; ii < word->length; ii++)
+  {
+    curr = transitions[curr * num_generators + word->generators[ii]];
+    if (curr == AUTOMATON_TABLE_REJECT_STATE)
+    {
+      reduced = false;
+      *fail_index = ii;
+      break;
+    }
+  }
+
+  return(reduced);
+}
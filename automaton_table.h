@@ -0,0 +1,61 @@
+/******************************************************************************/
+/* The value stored in the transition table when reading a generator from a   */
+/* state leads to the failure state (i.e. the word is no longer reduced).     */
+/******************************************************************************/
+#define AUTOMATON_TABLE_REJECT_STATE -1
+
+/******************************************************************************/
+/* Group: INIT_AUTOMATON_TABLE_RET_CODES                                      */
+/*                                                                            */
+/* The return codes for function init_automaton_table.                        */
+/******************************************************************************/
+#define INIT_AUTOMATON_TABLE_OK      0
+#define INIT_AUTOMATON_TABLE_MEM_ERR 1
+
+/******************************************************************************/
+/* Group: COMPILE_STATE_TREE_RET_CODES                                        */
+/*                                                                            */
+/* The return codes for function compile_state_tree.                          */
+/******************************************************************************/
+#define COMPILE_STATE_TREE_OK      0
+#define COMPILE_STATE_TREE_MEM_ERR 1
+
+/******************************************************************************/
+/* Group: MINIMISE_AUTOMATON_TABLE_RET_CODES                                  */
+/*                                                                            */
+/* The return codes for function minimise_automaton_table.                    */
+/******************************************************************************/
+#define MINIMISE_AUTOMATON_TABLE_OK      0
+#define MINIMISE_AUTOMATON_TABLE_MEM_ERR 1
+
+/******************************************************************************/
+/* Group: COMPILE_ROOT_ACTION_TABLE_RET_CODES                                 */
+/*                                                                            */
+/* The return codes for functions compile_root_action_subset and             */
+/* compile_root_action_table.                                                 */
+/******************************************************************************/
+#define COMPILE_ROOT_ACTION_TABLE_OK              0
+#define COMPILE_ROOT_ACTION_TABLE_MEM_ERR         1
+#define COMPILE_ROOT_ACTION_TABLE_TOO_MANY_STATES 2
+
+/******************************************************************************/
+/* Group: COUNT_ACCEPTED_WORDS_RET_CODES                                      */
+/*                                                                            */
+/* The return codes for function count_accepted_words.                        */
+/******************************************************************************/
+#define COUNT_ACCEPTED_WORDS_OK      0
+#define COUNT_ACCEPTED_WORDS_MEM_ERR 1
+
+/******************************************************************************/
+/* This structure is the compiled (flat) form of the automaton. The states    */
+/* are numbered 0 to num_states - 1 and the transition out of state s on      */
+/* generator g is held in transitions[s * num_generators + g]. A value of     */
+/* AUTOMATON_TABLE_REJECT_STATE means that the word is not reduced.           */
+/******************************************************************************/
+typedef struct automaton_table
+{
+  long num_states;
+  int num_generators;
+  int32_t start_state;
+  int32_t *transitions;
+} AUTOMATON_TABLE;
@@ -0,0 +1,1159 @@
+#include "cox_prot.h"
+
+/******************************************************************************/
+/* Function: init_batch_reduce                                                */
+/*                                                                            */
+/* Returns: One of BATCH_REDUCE_RET_CODES.                                    */
+/*                                                                            */
+/* Parameters: IN     reducer - The reducer to reduce the words with.         */
+/*             IN     num_generators - The number of group generators.        */
+/*             IN     num_workers - The number of worker processes. 0 reduces */
+/*                                  the words in this process.                */
+/*             IN     compare_pairs - Each line is a pair of words to be      */
+/*                                    compared rather than a word.            */
+/*             IN     corpus - The mapped words, or NULL if they are read     */
+/*                             from a stream.                                 */
+/*             OUT    batch - Will be returned with no workers started.       */
+/*                                                                            */
+/* Operation: Allocate the per worker arrays and the chunk buffers. A chunk   */
+/*            of a mapped corpus is just its start and end offsets.           */
+/******************************************************************************/
+int init_batch_reduce(WORD_REDUCER *reducer,
+                      int num_generators,
+                      int num_workers,
+                      bool compare_pairs,
+                      WORD_CORPUS *corpus,
+                      BATCH_REDUCE **batch)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BATCH_REDUCE_OK;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(reducer != NULL);
+  assert(num_workers >= 0 && num_workers <= MAX_BATCH_WORKERS);
+  assert(batch != NULL);
+
+  *batch = (BATCH_REDUCE *) calloc(1, sizeof(BATCH_REDUCE));
+  if (*batch == NULL)
+  {
+    ret_code = BATCH_REDUCE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  (*batch)->reducer = reducer;
+  (*batch)->num_generators = num_generators;
+  (*batch)->num_workers = num_workers;
+  (*batch)->compare_pairs = compare_pairs;
+  (*batch)->corpus = corpus;
+
+  if (num_workers > 0)
+  {
+    (*batch)->pids = (pid_t *) calloc(num_workers, sizeof(pid_t));
+    (*batch)->to_workers = (FILE **) calloc(num_workers, sizeof(FILE *));
+    (*batch)->from_workers = (FILE **) calloc(num_workers, sizeof(FILE *));
+    if ((*batch)->pids == NULL ||
+        (*batch)->to_workers == NULL ||
+        (*batch)->from_workers == NULL)
+    {
+      ret_code = BATCH_REDUCE_MEM_ERR;
+      goto EXIT_LABEL;
+    }
+  }
+
+  if (init_record_buffer((corpus != NULL) ? sizeof(uint64_t) : sizeof(char),
+                         &((*batch)->chunk)) != RECORD_BUFFER_OK ||
+      init_record_buffer(sizeof(char), &((*batch)->results)) !=
+                                                          RECORD_BUFFER_OK)
+  {
+    ret_code = BATCH_REDUCE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+EXIT_LABEL:
+
+  if (ret_code != BATCH_REDUCE_OK && *batch != NULL)
+  {
+    free_batch_reduce(*batch);
+    *batch = NULL;
+  }
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: free_batch_reduce                                                */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     batch - The batch to be freed. Its workers must have    */
+/*                            been stopped.                                   */
+/*                                                                            */
+/* Operation: Free the buffers and the per worker arrays. The reducer is left */
+/*            alone.                                                          */
+/******************************************************************************/
+void free_batch_reduce(BATCH_REDUCE *batch)
+{
+  assert(batch != NULL);
+
+  if (batch->chunk != NULL)
+  {
+    free_record_buffer(batch->chunk);
+  }
+  if (batch->results != NULL)
+  {
+    free_record_buffer(batch->results);
+  }
+  free(batch->line);
+  free(batch->pids);
+  free(batch->to_workers);
+  free(batch->from_workers);
+  free(batch);
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: read_batch_chunk                                                 */
+/*                                                                            */
+/* Returns: One of BATCH_REDUCE_RET_CODES. BATCH_REDUCE_BAD_WORD is returned  */
+/*          if a line holds anything other than generators, in which case     */
+/*          line_number is the line it was on.                                */
+/*                                                                            */
+/* Parameters: IN/OUT batch - The batch. Its chunk is replaced by the next    */
+/*                            one, which is empty if there are no words left. */
+/*             IN     input - The stream the words are read from if they      */
+/*                            aren't mapped.                                  */
+/*             OUT    finished - Will be returned true if the end of the      */
+/*                               input was reached.                           */
+/*                                                                            */
+/* Operation: A mapped corpus is checked up to the end of the line after      */
+/*            BATCH_CHUNK_BYTES and the chunk is just where that starts and   */
+/*            ends. Otherwise whole lines are read until the chunk holds at   */
+/*            least BATCH_CHUNK_BYTES, ending each word with a newline. An    */
+/*            empty line is the identity and is kept so that every line of    */
+/*            the input has a line in the output.                             */
+/******************************************************************************/
+int read_batch_chunk(BATCH_REDUCE *batch, FILE *input, bool *finished)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BATCH_REDUCE_OK;
+  RECORD_BUFFER *chunk = batch->chunk;
+  WORD_CORPUS *corpus = batch->corpus;
+  uint64_t range[2];
+  size_t start;
+  size_t end;
+  ssize_t length;
+  ssize_t ii;
+  int num_separators;
+
+  chunk->num_records = 0;
+  *finished = false;
+  if (corpus != NULL)
+  {
+    if (next_corpus_chunk(corpus,
+                          batch->num_generators,
+                          batch->compare_pairs,
+                          BATCH_CHUNK_BYTES,
+                          &start,
+                          &end) != NEXT_CORPUS_CHUNK_OK)
+    {
+      batch->line_number = corpus->line_number;
+      ret_code = BATCH_REDUCE_BAD_WORD;
+      goto EXIT_LABEL;
+    }
+    *finished = (corpus->position == corpus->size);
+    if (end > start)
+    {
+      range[0] = (uint64_t) start;
+      range[1] = (uint64_t) end;
+      if (append_record(chunk, &(range[0])) != RECORD_BUFFER_OK ||
+          append_record(chunk, &(range[1])) != RECORD_BUFFER_OK)
+      {
+        ret_code = BATCH_REDUCE_MEM_ERR;
+      }
+    }
+    goto EXIT_LABEL;
+  }
+
+  while (chunk->num_records < BATCH_CHUNK_BYTES)
+  {
+    length = getline(&(batch->line), &(batch->line_capacity), input);
+    if (length < 0)
+    {
+      if (ferror(input))
+      {
+        ret_code = BATCH_REDUCE_FILE_ERR;
+        goto EXIT_LABEL;
+      }
+      *finished = true;
+      break;
+    }
+    batch->line_number++;
+
+    if (length > 0 && batch->line[length - 1] == '\n')
+    {
+      length--;
+    }
+    if (length > 0 && batch->line[length - 1] == '\r')
+    {
+      length--;
+    }
+    num_separators = 0;
+    for (ii = 0; ii < length; ii++)
+    {
+      if (batch->compare_pairs && batch->line[ii] == WORD_PAIR_SEPARATOR)
+      {
+        num_separators++;
+      }
+      else if (batch->line[ii] < ASCII_LOWER_A ||
+               batch->line[ii] >= ASCII_LOWER_A + batch->num_generators)
+      {
+        ret_code = BATCH_REDUCE_BAD_WORD;
+        goto EXIT_LABEL;
+      }
+    }
+    if (batch->compare_pairs && num_separators != 1)
+    {
+      ret_code = BATCH_REDUCE_BAD_WORD;
+      goto EXIT_LABEL;
+    }
+
+    if (reserve_record_buffer(chunk, chunk->num_records + length + 1) !=
+                                                              RECORD_BUFFER_OK)
+    {
+      ret_code = BATCH_REDUCE_MEM_ERR;
+      goto EXIT_LABEL;
+    }
+    memcpy(chunk->records + chunk->num_records, batch->line, length);
+    chunk->records[chunk->num_records + length] = '\n';
+    chunk->num_records += length + 1;
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: reduce_batch_text                                                */
+/*                                                                            */
+/* Returns: One of BATCH_REDUCE_RET_CODES.                                    */
+/*                                                                            */
+/* Parameters: IN     reducer - The reducer to use.                           */
+/*             IN     text - Words, one to a line. The last needn't end with  */
+/*                           a newline. It is only read, so it may be part of */
+/*                           a mapping.                                       */
+/*             IN     length - The length of the text.                        */
+/*             OUT    results - Will be returned holding the reduced words,   */
+/*                              each ending with a newline.                   */
+/*                                                                            */
+/* Operation: Take BATCH_SCAN_WORDS words at a time and check them all with   */
+/*            one interleaved scan, straight from the text, or one at a time  */
+/*            with is_reduced_components if the group is split into           */
+/*            components. With the exchange condition there is nothing to     */
+/*            check with, so every word counts as not reduced. Each word is   */
+/*            then copied to the results and only the words which aren't      */
+/*            already reduced are reduced there, in place.                    */
+/******************************************************************************/
+int reduce_batch_text(WORD_REDUCER *reducer,
+                      const char *text,
+                      size_t length,
+                      RECORD_BUFFER *results)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BATCH_REDUCE_OK;
+  char *group_words[BATCH_SCAN_WORDS];
+  int group_lengths[BATCH_SCAN_WORDS];
+  int fail_indices[BATCH_SCAN_WORDS];
+  const char *end;
+  char *result;
+  size_t read_index = 0;
+  long num_group;
+  long ii;
+  int word_length;
+
+  results->num_records = 0;
+  while (read_index < length)
+  {
+    /**************************************************************************/
+    /* Find the next group of words, dropping any carriage returns.           */
+    /**************************************************************************/
+    for (num_group = 0;
+         num_group < BATCH_SCAN_WORDS && read_index < length;
+         num_group++)
+    {
+      end = (const char *) memchr(text + read_index,
+                                  '\n',
+                                  length - read_index);
+      if (end == NULL)
+      {
+        end = text + length;
+      }
+      word_length = (int) (end - (text + read_index));
+      if (word_length > 0 && text[read_index + word_length - 1] == '\r')
+      {
+        word_length--;
+      }
+      group_words[num_group] = (char *) (text + read_index);
+      group_lengths[num_group] = word_length;
+      read_index = end - text + 1;
+    }
+
+    if (reducer->components != NULL)
+    {
+      for (ii = 0; ii < num_group; ii++)
+      {
+        is_reduced_components(reducer->components,
+                              group_words[ii],
+                              &fail_indices[ii],
+                              0,
+                              group_lengths[ii]);
+      }
+    }
+    else if (reducer->exchange != NULL)
+    {
+      for (ii = 0; ii < num_group; ii++)
+      {
+        fail_indices[ii] = 1;
+      }
+    }
+    else
+    {
+      check_words_interleaved(reducer->table,
+                              group_words,
+                              group_lengths,
+                              num_group,
+                              fail_indices);
+    }
+    for (ii = 0; ii < num_group; ii++)
+    {
+      word_length = group_lengths[ii];
+      if (reserve_record_buffer(results,
+                                results->num_records + word_length + 1) !=
+                                                              RECORD_BUFFER_OK)
+      {
+        ret_code = BATCH_REDUCE_MEM_ERR;
+        goto EXIT_LABEL;
+      }
+      result = results->records + results->num_records;
+      memcpy(result, group_words[ii], word_length);
+      if (fail_indices[ii] != 0)
+      {
+        result[word_length] = '\0';
+        if (reduce_word(reducer, result, &word_length) != WORD_REDUCER_OK)
+        {
+          ret_code = BATCH_REDUCE_MEM_ERR;
+          goto EXIT_LABEL;
+        }
+      }
+      result[word_length] = '\n';
+      results->num_records += word_length + 1;
+    }
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: compare_batch_text                                               */
+/*                                                                            */
+/* Returns: One of BATCH_REDUCE_RET_CODES.                                    */
+/*                                                                            */
+/* Parameters: IN     reducer - The reducer to use.                           */
+/*             IN     text - Pairs of words, one pair to a line with          */
+/*                           WORD_PAIR_SEPARATOR between the two words. The   */
+/*                           last needn't end with a newline.                 */
+/*             IN     length - The length of the text.                        */
+/*             OUT    results - Will be returned holding BATCH_PAIR_EQUAL or  */
+/*                              BATCH_PAIR_NOT_EQUAL for each pair, each      */
+/*                              ending with a newline.                        */
+/*                                                                            */
+/* Operation: Compare each pair with words_equal_text, using the same words   */
+/*            to work in for the whole chunk.                                 */
+/******************************************************************************/
+int compare_batch_text(WORD_REDUCER *reducer,
+                       const char *text,
+                       size_t length,
+                       RECORD_BUFFER *results)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BATCH_REDUCE_OK;
+  GENERATOR_WORD *words[3] = {NULL, NULL, NULL};
+  const char *end;
+  const char *separator;
+  size_t read_index = 0;
+  int line_length;
+  bool equal;
+  int ii;
+
+  results->num_records = 0;
+  for (ii = 0; ii < 3; ii++)
+  {
+    if (init_generator_word(&(words[ii])) != GENERATOR_WORD_OK)
+    {
+      ret_code = BATCH_REDUCE_MEM_ERR;
+      goto EXIT_LABEL;
+    }
+  }
+
+  while (read_index < length)
+  {
+    end = (const char *) memchr(text + read_index, '\n', length - read_index);
+    if (end == NULL)
+    {
+      end = text + length;
+    }
+    line_length = (int) (end - (text + read_index));
+    if (line_length > 0 && text[read_index + line_length - 1] == '\r')
+    {
+      line_length--;
+    }
+    separator = (const char *) memchr(text + read_index,
+                                      WORD_PAIR_SEPARATOR,
+                                      line_length);
+    assert(separator != NULL);
+
+    if (words_equal_text(reducer,
+                         text + read_index,
+                         (int) (separator - (text + read_index)),
+                         separator + 1,
+                         (int) (text + read_index + line_length -
+                                                            (separator + 1)),
+                         words,
+                         &equal) != WORDS_EQUAL_OK)
+    {
+      ret_code = BATCH_REDUCE_MEM_ERR;
+      goto EXIT_LABEL;
+    }
+    if (reserve_record_buffer(results, results->num_records + 2) !=
+                                                              RECORD_BUFFER_OK)
+    {
+      ret_code = BATCH_REDUCE_MEM_ERR;
+      goto EXIT_LABEL;
+    }
+    results->records[results->num_records] = equal ? BATCH_PAIR_EQUAL :
+                                                     BATCH_PAIR_NOT_EQUAL;
+    results->records[results->num_records + 1] = '\n';
+    results->num_records += 2;
+    read_index = end - text + 1;
+  }
+
+EXIT_LABEL:
+
+  for (ii = 0; ii < 3; ii++)
+  {
+    if (words[ii] != NULL)
+    {
+      free_generator_word(words[ii]);
+    }
+  }
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: reduce_batch_chunk                                               */
+/*                                                                            */
+/* Returns: One of BATCH_REDUCE_RET_CODES.                                    */
+/*                                                                            */
+/* Parameters: IN     reducer - The reducer to use.                           */
+/*             IN     corpus - The mapped words, or NULL if they were read    */
+/*                             from a stream.                                 */
+/*             IN     compare_pairs - The chunk is pairs of words to compare. */
+/*             IN     chunk - The chunk, as read by read_batch_chunk.         */
+/*             OUT    results - Will be returned holding the reduced words,   */
+/*                              or the result of comparing each pair.         */
+/*                                                                            */
+/* Operation: Find the text of the chunk, in the mapping or in the chunk      */
+/*            itself, and reduce it or compare its pairs.                     */
+/******************************************************************************/
+int reduce_batch_chunk(WORD_REDUCER *reducer,
+                       WORD_CORPUS *corpus,
+                       bool compare_pairs,
+                       RECORD_BUFFER *chunk,
+                       RECORD_BUFFER *results)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code;
+  const uint64_t *range;
+  const char *text;
+  size_t length;
+
+  if (corpus != NULL)
+  {
+    assert(chunk->num_records == 2);
+    range = (const uint64_t *) chunk->records;
+    assert(range[0] <= range[1] && range[1] <= corpus->size);
+    text = corpus->data + range[0];
+    length = (size_t) (range[1] - range[0]);
+  }
+  else
+  {
+    text = chunk->records;
+    length = (size_t) chunk->num_records;
+  }
+
+  if (compare_pairs)
+  {
+    ret_code = compare_batch_text(reducer, text, length, results);
+  }
+  else
+  {
+    ret_code = reduce_batch_text(reducer, text, length, results);
+  }
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: write_batch_chunk                                                */
+/*                                                                            */
+/* Returns: One of BATCH_REDUCE_RET_CODES.                                    */
+/*                                                                            */
+/* Parameters: IN/OUT words - A chunk of newline terminated reduced words.    */
+/*                            They are overwritten if binary_output is set.   */
+/*             IN     binary_output - Write the words in the binary encoding  */
+/*                                    rather than as text.                    */
+/*             IN     output - The stream to write them to.                   */
+/*                                                                            */
+/* Operation: Write the chunk out as it is, or turn each word's letters into  */
+/*            generator indices in place and write it as a binary word.       */
+/******************************************************************************/
+int write_batch_chunk(RECORD_BUFFER *words, bool binary_output, FILE *output)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BATCH_REDUCE_OK;
+  GENERATOR_WORD word;
+  char *end;
+  long read_index = 0;
+  int ii;
+
+  if (!binary_output)
+  {
+    if (fwrite(words->records, sizeof(char), words->num_records, output) !=
+                                                   (size_t) words->num_records)
+    {
+      ret_code = BATCH_REDUCE_FILE_ERR;
+    }
+    goto EXIT_LABEL;
+  }
+
+  while (read_index < words->num_records)
+  {
+    end = (char *) memchr(words->records + read_index,
+                          '\n',
+                          words->num_records - read_index);
+    word.generators = (uint8_t *) (words->records + read_index);
+    word.length = (int) (end - (words->records + read_index));
+    word.capacity = word.length;
+    for (ii = 0; ii < word.length; ii++)
+    {
+      word.generators[ii] -= ASCII_LOWER_A;
+    }
+    if (write_generator_word(output, &word) != WORD_FILE_OK)
+    {
+      ret_code = BATCH_REDUCE_FILE_ERR;
+      goto EXIT_LABEL;
+    }
+    read_index += word.length + 1;
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: run_batch_worker                                                 */
+/*                                                                            */
+/* Returns: One of BATCH_REDUCE_RET_CODES.                                    */
+/*                                                                            */
+/* Parameters: IN     reducer - The reducer to use. Only its own stack is     */
+/*                              written to, and that is private to the worker */
+/*                              after the fork.                               */
+/*             IN     corpus - The mapped words, or NULL if the chunks hold   */
+/*                             the words themselves.                          */
+/*             IN     compare_pairs - The chunks are pairs of words to        */
+/*                                    compare.                                */
+/*             IN     from_coordinator - The pipe the coordinator writes to.  */
+/*             IN     to_coordinator - The pipe the coordinator reads from.   */
+/*                                                                            */
+/* Operation: Reduce one chunk after another and send each back, until the    */
+/*            coordinator closes the pipe instead of sending another. The     */
+/*            mapping of a corpus is inherited from the fork, so only the     */
+/*            offsets of each chunk come down the pipe.                       */
+/******************************************************************************/
+int run_batch_worker(WORD_REDUCER *reducer,
+                     WORD_CORPUS *corpus,
+                     bool compare_pairs,
+                     FILE *from_coordinator,
+                     FILE *to_coordinator)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BATCH_REDUCE_OK;
+  RECORD_BUFFER *chunk = NULL;
+  RECORD_BUFFER *results = NULL;
+  int message_ret_code;
+
+  if (init_record_buffer((corpus != NULL) ? sizeof(uint64_t) : sizeof(char),
+                         &chunk) != RECORD_BUFFER_OK ||
+      init_record_buffer(sizeof(char), &results) != RECORD_BUFFER_OK)
+  {
+    ret_code = BATCH_REDUCE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  while (true)
+  {
+    message_ret_code = read_record_message(from_coordinator, chunk);
+    if (message_ret_code == RECORD_MESSAGE_CLOSED)
+    {
+      break;
+    }
+    if (message_ret_code != RECORD_MESSAGE_OK)
+    {
+      ret_code = BATCH_REDUCE_WORKER_ERR;
+      goto EXIT_LABEL;
+    }
+
+    ret_code = reduce_batch_chunk(reducer,
+                                  corpus,
+                                  compare_pairs,
+                                  chunk,
+                                  results);
+    if (ret_code != BATCH_REDUCE_OK)
+    {
+      goto EXIT_LABEL;
+    }
+
+    if (write_record_message(to_coordinator, results) != RECORD_MESSAGE_OK)
+    {
+      ret_code = BATCH_REDUCE_WORKER_ERR;
+      goto EXIT_LABEL;
+    }
+  }
+
+EXIT_LABEL:
+
+  if (chunk != NULL)
+  {
+    free_record_buffer(chunk);
+  }
+  if (results != NULL)
+  {
+    free_record_buffer(results);
+  }
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: start_batch_workers                                              */
+/*                                                                            */
+/* Returns: One of BATCH_REDUCE_RET_CODES.                                    */
+/*                                                                            */
+/* Parameters: IN/OUT batch - The batch, with no workers started.             */
+/*                                                                            */
+/* Operation: For each worker create a pipe in each direction and fork. The   */
+/*            child closes the parent's ends of the pipes, including those of */
+/*            the workers started before it, runs the worker and exits        */
+/*            without returning. Each worker inherits the automata from the   */
+/*            fork, so they are shared rather than copied as none of the      */
+/*            workers write to them.                                          */
+/******************************************************************************/
+int start_batch_workers(BATCH_REDUCE *batch)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BATCH_REDUCE_OK;
+  int to_worker_pipe[2];
+  int from_worker_pipe[2];
+  FILE *from_coordinator;
+  FILE *to_coordinator;
+  int worker_ret_code;
+  int ii;
+  int jj;
+
+  /****************************************************************************/
+  /* Anything still waiting to be printed would otherwise be printed by every */
+  /* child as well.                                                           */
+  /****************************************************************************/
+  fflush(stdout);
+
+  for (ii = 0; ii < batch->num_workers; ii++)
+  {
+    if (pipe(to_worker_pipe) != 0)
+    {
+      ret_code = BATCH_REDUCE_WORKER_ERR;
+      goto EXIT_LABEL;
+    }
+    if (pipe(from_worker_pipe) != 0)
+    {
+      close(to_worker_pipe[0]);
+      close(to_worker_pipe[1]);
+      ret_code = BATCH_REDUCE_WORKER_ERR;
+      goto EXIT_LABEL;
+    }
+
+    batch->pids[ii] = fork();
+    if (batch->pids[ii] == 0)
+    {
+      /************************************************************************/
+      /* This is the worker.                                                  */
+      /************************************************************************/
+      for (jj = 0; jj < ii; jj++)
+      {
+        close(fileno(batch->to_workers[jj]));
+        close(fileno(batch->from_workers[jj]));
+      }
+      close(to_worker_pipe[1]);
+      close(from_worker_pipe[0]);
+
+      from_coordinator = fdopen(to_worker_pipe[0], "rb");
+      to_coordinator = fdopen(from_worker_pipe[1], "wb");
+      worker_ret_code = BATCH_REDUCE_WORKER_ERR;
+      if (from_coordinator != NULL && to_coordinator != NULL)
+      {
+        worker_ret_code = run_batch_worker(batch->reducer,
+                                           batch->corpus,
+                                           batch->compare_pairs,
+                                           from_coordinator,
+                                           to_coordinator);
+      }
+      _exit(worker_ret_code == BATCH_REDUCE_OK ? 0 : 1);
+    }
+
+    /**************************************************************************/
+    /* This is the coordinator.                                               */
+    /**************************************************************************/
+    close(to_worker_pipe[0]);
+    close(from_worker_pipe[1]);
+    if (batch->pids[ii] < 0)
+    {
+      batch->pids[ii] = 0;
+      close(to_worker_pipe[1]);
+      close(from_worker_pipe[0]);
+      ret_code = BATCH_REDUCE_WORKER_ERR;
+      goto EXIT_LABEL;
+    }
+    batch->to_workers[ii] = fdopen(to_worker_pipe[1], "wb");
+    batch->from_workers[ii] = fdopen(from_worker_pipe[0], "rb");
+    if (batch->to_workers[ii] == NULL || batch->from_workers[ii] == NULL)
+    {
+      ret_code = BATCH_REDUCE_WORKER_ERR;
+      goto EXIT_LABEL;
+    }
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: stop_batch_workers                                               */
+/*                                                                            */
+/* Returns: One of BATCH_REDUCE_RET_CODES.                                    */
+/*                                                                            */
+/* Parameters: IN/OUT batch - The batch.                                      */
+/*                                                                            */
+/* Operation: Close the pipes, which tells each worker to finish, and wait    */
+/*            for the workers to exit. Any worker which didn't exit cleanly   */
+/*            is an error.                                                    */
+/******************************************************************************/
+int stop_batch_workers(BATCH_REDUCE *batch)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BATCH_REDUCE_OK;
+  int status;
+  int ii;
+
+  for (ii = 0; ii < batch->num_workers; ii++)
+  {
+    if (batch->to_workers[ii] != NULL)
+    {
+      fclose(batch->to_workers[ii]);
+      batch->to_workers[ii] = NULL;
+    }
+    if (batch->from_workers[ii] != NULL)
+    {
+      fclose(batch->from_workers[ii]);
+      batch->from_workers[ii] = NULL;
+    }
+  }
+
+  for (ii = 0; ii < batch->num_workers; ii++)
+  {
+    if (batch->pids[ii] > 0)
+    {
+      if (waitpid(batch->pids[ii], &status, 0) != batch->pids[ii] ||
+          !WIFEXITED(status) ||
+          WEXITSTATUS(status) != 0)
+      {
+        ret_code = BATCH_REDUCE_WORKER_ERR;
+      }
+      batch->pids[ii] = 0;
+    }
+  }
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: reduce_word_batch                                                */
+/*                                                                            */
+/* Returns: One of BATCH_REDUCE_RET_CODES.                                    */
+/*                                                                            */
+/* Parameters: IN     reducer - The reducer to reduce the words with.         */
+/*             IN     num_generators - The number of group generators.        */
+/*             IN     num_workers - The number of worker processes. 0 reduces */
+/*                                  the words in this process.                */
+/*             IN     compare_pairs - Each line is a pair of words, and       */
+/*                                    whether they are equal is written for   */
+/*                                    it rather than a reduced word.          */
+/*             IN     corpus - The mapped words, or NULL to read them from    */
+/*                             the input.                                     */
+/*             IN     input - The stream of words, one to a line, if they     */
+/*                            aren't mapped.                                  */
+/*             IN     binary_output - Write the reduced words in the binary   */
+/*                                    encoding rather than one to a line.     */
+/*             IN     output - The stream the reduced words are written to,   */
+/*                             in the order of the input.                     */
+/*             OUT    bad_line - Will be returned holding the line of the     */
+/*                               input the bad word was on if                 */
+/*                               BATCH_REDUCE_BAD_WORD is returned.           */
+/*                                                                            */
+/* Operation: Keep each worker busy with one chunk. Chunk k goes to worker    */
+/*            k % num_workers, and the oldest chunk's results are always      */
+/*            read back before its worker is given another, so the results    */
+/*            come back in input order and no worker is ever sent a chunk     */
+/*            while it is still writing out the last one.                     */
+/******************************************************************************/
+int reduce_word_batch(WORD_REDUCER *reducer,
+                      int num_generators,
+                      int num_workers,
+                      bool compare_pairs,
+                      WORD_CORPUS *corpus,
+                      FILE *input,
+                      bool binary_output,
+                      FILE *output,
+                      long *bad_line)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code;
+  int stop_ret_code;
+  BATCH_REDUCE *batch = NULL;
+  long chunks_sent = 0;
+  long chunks_received = 0;
+  long max_in_flight = (num_workers > 0 ? num_workers : 1);
+  bool finished = false;
+  void (*old_handler)(int);
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(reducer != NULL);
+  assert(corpus != NULL || input != NULL);
+  assert(output != NULL);
+  assert(bad_line != NULL);
+
+  /****************************************************************************/
+  /* A worker which dies should show up as an error writing to it rather than */
+  /* killing the coordinator.                                                 */
+  /****************************************************************************/
+  old_handler = signal(SIGPIPE, SIG_IGN);
+
+  ret_code = init_batch_reduce(reducer,
+                               num_generators,
+                               num_workers,
+                               compare_pairs,
+                               corpus,
+                               &batch);
+  if (ret_code != BATCH_REDUCE_OK)
+  {
+    goto EXIT_LABEL;
+  }
+
+  ret_code = start_batch_workers(batch);
+  if (ret_code != BATCH_REDUCE_OK)
+  {
+    goto EXIT_LABEL;
+  }
+  if (binary_output &&
+      write_word_file_header(output, num_generators) != WORD_FILE_OK)
+  {
+    ret_code = BATCH_REDUCE_FILE_ERR;
+    goto EXIT_LABEL;
+  }
+
+  while (true)
+  {
+    if (!finished && chunks_sent - chunks_received < max_in_flight)
+    {
+      /************************************************************************/
+      /* Hand out the next chunk as its worker is free.                       */
+      /************************************************************************/
+      ret_code = read_batch_chunk(batch, input, &finished);
+      if (ret_code == BATCH_REDUCE_BAD_WORD)
+      {
+        *bad_line = batch->line_number;
+      }
+      if (ret_code != BATCH_REDUCE_OK)
+      {
+        goto EXIT_LABEL;
+      }
+      if (batch->chunk->num_records == 0)
+      {
+        continue;
+      }
+
+      if (num_workers == 0)
+      {
+        ret_code = reduce_batch_chunk(reducer,
+                                      corpus,
+                                      compare_pairs,
+                                      batch->chunk,
+                                      batch->results);
+        if (ret_code != BATCH_REDUCE_OK)
+        {
+          goto EXIT_LABEL;
+        }
+        ret_code = write_batch_chunk(batch->results, binary_output, output);
+        if (ret_code != BATCH_REDUCE_OK)
+        {
+          goto EXIT_LABEL;
+        }
+      }
+      else
+      {
+        if (write_record_message(batch->to_workers[chunks_sent % num_workers],
+                                 batch->chunk) != RECORD_MESSAGE_OK)
+        {
+          ret_code = BATCH_REDUCE_WORKER_ERR;
+          goto EXIT_LABEL;
+        }
+        chunks_sent++;
+      }
+    }
+    else if (chunks_received < chunks_sent)
+    {
+      /************************************************************************/
+      /* Wait for the oldest chunk and write it out.                          */
+      /************************************************************************/
+      if (read_record_message(batch->from_workers[chunks_received %
+                                                  num_workers],
+                              batch->results) != RECORD_MESSAGE_OK)
+      {
+        ret_code = BATCH_REDUCE_WORKER_ERR;
+        goto EXIT_LABEL;
+      }
+      chunks_received++;
+      ret_code = write_batch_chunk(batch->results, binary_output, output);
+      if (ret_code != BATCH_REDUCE_OK)
+      {
+        goto EXIT_LABEL;
+      }
+    }
+    else
+    {
+      break;
+    }
+  }
+  if (fflush(output) != 0)
+  {
+    ret_code = BATCH_REDUCE_FILE_ERR;
+  }
+
+EXIT_LABEL:
+
+  if (batch != NULL)
+  {
+    stop_ret_code = stop_batch_workers(batch);
+    if (ret_code == BATCH_REDUCE_OK)
+    {
+      ret_code = stop_ret_code;
+    }
+    free_batch_reduce(batch);
+  }
+  signal(SIGPIPE, old_handler);
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: reduce_binary_batch                                              */
+/*                                                                            */
+/* Returns: One of BATCH_REDUCE_RET_CODES.                                    */
+/*                                                                            */
+/* Parameters: IN     reducer - The reducer to reduce the words with.         */
+/*             IN     num_generators - The number of group generators.        */
+/*             IN     input - The stream of words in the binary encoding.     */
+/*             IN     binary_output - Write the reduced words in the binary   */
+/*                                    encoding rather than one to a line.     */
+/*             IN     output - The stream the reduced words are written to,   */
+/*                             in the order of the input.                     */
+/*             OUT    bad_word - Will be returned holding the number of the   */
+/*                               word which couldn't be read, counting from   */
+/*                               1, or 0 if it was the header, if             */
+/*                               BATCH_REDUCE_BAD_WORD is returned.           */
+/*                                                                            */
+/* Operation: Read each word straight into a generator word, so no letter is  */
+/*            ever decoded, check it with the flat table and only reduce it   */
+/*            if it is rejected. If the group is split into components or     */
+/*            words are reduced with the exchange condition there is no flat  */
+/*            table, so every word is reduced.                                */
+/******************************************************************************/
+int reduce_binary_batch(WORD_REDUCER *reducer,
+                        int num_generators,
+                        FILE *input,
+                        bool binary_output,
+                        FILE *output,
+                        long *bad_word)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = BATCH_REDUCE_OK;
+  int read_ret_code;
+  GENERATOR_WORD *word = NULL;
+  char *text = NULL;
+  char *new_text;
+  size_t text_capacity = 0;
+  long word_number = 0;
+  int fail_index;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(reducer != NULL);
+  assert(input != NULL);
+  assert(output != NULL);
+  assert(bad_word != NULL);
+
+  if (init_generator_word(&word) != GENERATOR_WORD_OK)
+  {
+    ret_code = BATCH_REDUCE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  read_ret_code = read_word_file_header(input, num_generators);
+  if (read_ret_code == WORD_FILE_FILE_ERR)
+  {
+    ret_code = BATCH_REDUCE_FILE_ERR;
+    goto EXIT_LABEL;
+  }
+  if (read_ret_code != WORD_FILE_OK)
+  {
+    *bad_word = 0;
+    ret_code = BATCH_REDUCE_BAD_WORD;
+    goto EXIT_LABEL;
+  }
+  if (binary_output &&
+      write_word_file_header(output, num_generators) != WORD_FILE_OK)
+  {
+    ret_code = BATCH_REDUCE_FILE_ERR;
+    goto EXIT_LABEL;
+  }
+
+  while (true)
+  {
+    word_number++;
+    read_ret_code = read_generator_word(input, num_generators, word);
+    if (read_ret_code == WORD_FILE_END)
+    {
+      break;
+    }
+    if (read_ret_code == WORD_FILE_MEM_ERR)
+    {
+      ret_code = BATCH_REDUCE_MEM_ERR;
+      goto EXIT_LABEL;
+    }
+    if (read_ret_code == WORD_FILE_FILE_ERR)
+    {
+      ret_code = BATCH_REDUCE_FILE_ERR;
+      goto EXIT_LABEL;
+    }
+    if (read_ret_code != WORD_FILE_OK)
+    {
+      *bad_word = word_number;
+      ret_code = BATCH_REDUCE_BAD_WORD;
+      goto EXIT_LABEL;
+    }
+
+    if ((reducer->table == NULL ||
+         !is_reduced_generators(reducer->table, word, &fail_index)) &&
+        reduce_generator_word(reducer, word) != WORD_REDUCER_OK)
+    {
+      ret_code = BATCH_REDUCE_MEM_ERR;
+      goto EXIT_LABEL;
+    }
+
+    /**************************************************************************/
+    /* Write the reduced word out in whichever encoding was asked for.        */
+    /**************************************************************************/
+    if (binary_output)
+    {
+      if (write_generator_word(output, word) != WORD_FILE_OK)
+      {
+        ret_code = BATCH_REDUCE_FILE_ERR;
+        goto EXIT_LABEL;
+      }
+      continue;
+    }
+    if ((size_t) word->length + 1 > text_capacity)
+    {
+      new_text = (char *) realloc(text, word->length + 1);
+      if (new_text == NULL)
+      {
+        ret_code = BATCH_REDUCE_MEM_ERR;
+        goto EXIT_LABEL;
+      }
+      text = new_text;
+      text_capacity = word->length + 1;
+    }
+    decode_generator_word(word, text);
+    text[word->length] = '\n';
+    if (fwrite(text, sizeof(char), word->length + 1, output) !=
+                                                   (size_t) word->length + 1)
+    {
+      ret_code = BATCH_REDUCE_FILE_ERR;
+      goto EXIT_LABEL;
+    }
+  }
+  if (fflush(output) != 0)
+  {
+    ret_code = BATCH_REDUCE_FILE_ERR;
+  }
+
+EXIT_LABEL:
+
+  if (word != NULL)
+  {
+    free_generator_word(word);
+  }
+  free(text);
+
+  return(ret_code);
+}
@@ -0,0 +1,67 @@
+/******************************************************************************/
+/* The most worker processes which a batch of words may be reduced across.    */
+/******************************************************************************/
+#define MAX_BATCH_WORKERS 64
+
+/******************************************************************************/
+/* The number of bytes of words read into a chunk before it is handed to a    */
+/* worker. A chunk always ends with a whole word so may be a little longer.   */
+/******************************************************************************/
+#define BATCH_CHUNK_BYTES 65536
+
+/******************************************************************************/
+/* The number of words of a chunk which are checked together by one           */
+/* interleaved scan before any of them are reduced.                           */
+/******************************************************************************/
+#define BATCH_SCAN_WORDS 256
+
+/******************************************************************************/
+/* The results written for a pair of words which are or aren't equal.         */
+/******************************************************************************/
+#define BATCH_PAIR_EQUAL     '1'
+#define BATCH_PAIR_NOT_EQUAL '0'
+
+/******************************************************************************/
+/* Group: BATCH_REDUCE_RET_CODES                                              */
+/*                                                                            */
+/* The return codes for function reduce_word_batch and the functions it       */
+/* calls.                                                                     */
+/******************************************************************************/
+#define BATCH_REDUCE_OK         0
+#define BATCH_REDUCE_MEM_ERR    1
+#define BATCH_REDUCE_FILE_ERR   2
+#define BATCH_REDUCE_WORKER_ERR 3
+#define BATCH_REDUCE_BAD_WORD   4
+
+/******************************************************************************/
+/* This structure holds a batch reduction. The words are read a chunk at a    */
+/* time and chunk k is reduced by worker k % num_workers, so reading the      */
+/* results back in the same order writes them out in the order of the input.  */
+/* If there are no workers the chunks are reduced in this process.            */
+/* compare_pairs - Each line is a pair of words, and the result for it is     */
+/*                 whether they are equal rather than a reduced word.         */
+/* reducer - The reducer each worker uses. The automata it points to are      */
+/*           shared with the workers, which only read them.                   */
+/* corpus - The mapped words, or NULL if they are read from a stream.         */
+/* chunk - The last chunk read. For a corpus this is the offsets of its start */
+/*         and end, otherwise it is the words themselves, each ending with a  */
+/*         newline.                                                           */
+/* results - The reduced words of a chunk, each ending with a newline.        */
+/* line_number - The number of lines read so far, used to report a bad word.  */
+/******************************************************************************/
+typedef struct batch_reduce
+{
+  WORD_REDUCER *reducer;
+  int num_generators;
+  int num_workers;
+  bool compare_pairs;
+  pid_t *pids;
+  FILE **to_workers;
+  FILE **from_workers;
+  WORD_CORPUS *corpus;
+  RECORD_BUFFER *chunk;
+  RECORD_BUFFER *results;
+  char *line;
+  size_t line_capacity;
+  long line_number;
+} BATCH_REDUCE;
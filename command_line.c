@@ -0,0 +1,575 @@
+#include "cox_prot.h"
+
+/******************************************************************************/
+/* Function: print_usage                                                      */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     program_name - The name the program was run with.       */
+/*                                                                            */
+/* Operation: Print the list of valid options to stdout.                      */
+/******************************************************************************/
+void print_usage(char *program_name)
+{
+  printf("Usage: %s [options]\n", program_name);
+  printf("  -f <file>       Read the Coxeter matrix from the file rather than "
+         "asking for\n"
+         "                  its name.\n");
+  printf("  -m  Minimise the automaton before checking words.\n");
+  printf("  -l  Build the automaton lazily as words are checked.\n");
+  printf("  -o <directory>  Build the automaton on disk in the directory.\n");
+  printf("  -M <megabytes>  The memory the on disk build may use "
+         "(default %d).\n", DEFAULT_MEMORY_BUDGET_MB);
+  printf("  -C <seconds>    Checkpoint the on disk build this often.\n");
+  printf("  -R  Resume the on disk build from its last checkpoint.\n");
+  printf("  -w <workers>    Build the automaton with this many processes "
+         "(at most %d).\n", MAX_SHARD_WORKERS);
+  printf("  -S  Also build the ShortLex automaton for normal forms.\n");
+  printf("  -J <generators> Also build the coset automaton for W / W_J.\n");
+  printf("  -c  Build one automaton for each component of a reducible "
+         "group.\n");
+  printf("  -z  Compress the automaton before checking words.\n");
+  printf("  -s  Check words with an unrolled scan using a sink state.\n");
+  printf("  -B  Renumber the automaton's states breadth first.\n");
+  printf("  -F <file>       Renumber the automaton's states by how often the "
+         "words in the file visit them.\n");
+  printf("  -g <name>       Write the automaton out as C source to "
+         "<name>.c.\n");
+  printf("  -a <file>       Save the automaton to the file.\n");
+  printf("  -A <file>       Map a saved automaton rather than building "
+         "one. Only its\n"
+         "                  header is checked, so the file must be trusted "
+         "unless -V is\n"
+         "                  given.\n");
+  printf("  -V              Check every transition of the automaton mapped "
+         "with -A.\n");
+  printf("  -K <directory>  Look the automaton up in the cache directory "
+         "and add it if it\n"
+         "                  has to be built.\n");
+  printf("  -x              Reduce words with the exchange condition rather "
+         "than an\n"
+         "                  automaton.\n");
+  printf("  -b <file>       Reduce the words in the file, one to a line, "
+         "rather than\n"
+         "                  asking for them (- reads them from stdin).\n");
+  printf("  -W <file>       Reduce the whole file as one word of any length "
+         "as it is\n"
+         "                  read (- reads it from stdin).\n");
+  printf("  -L              Write only the length of the word reduced with "
+         "-W.\n");
+  printf("  -O <file>       Write the reduced words of -b or -W to the file "
+         "rather than\n"
+         "                  stdout, in which case everything else goes to "
+         "stderr.\n");
+  printf("  -P <processes>  Reduce a batch with this many processes "
+         "(at most %d).\n", MAX_BATCH_WORKERS);
+  printf("  -e              The words of a batch are in the binary "
+         "encoding.\n");
+  printf("  -E              Write the reduced words of a batch in the binary "
+         "encoding.\n");
+  printf("  -Q              Each line of a batch is two words with a space "
+         "between them.\n"
+         "                  Write %c if they are the same element and %c if "
+         "not.\n", BATCH_PAIR_EQUAL, BATCH_PAIR_NOT_EQUAL);
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: parse_command_line                                               */
+/*                                                                            */
+/* Returns: One of PARSE_COMMAND_LINE_RET_CODES.                              */
+/*                                                                            */
+/* Parameters: IN     argc - The number of arguments passed to main.          */
+/*             IN     argv - The arguments passed to main.                    */
+/*             OUT    options - Will be returned with each option set.        */
+/*                                                                            */
+/* Operation: Set every option to its default and then walk through the       */
+/*            arguments setting the option corresponding to each one. An      */
+/*            argument which is not recognised is an error.                   */
+/******************************************************************************/
+int parse_command_line(int argc, char **argv, PROGRAM_OPTIONS *options)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = PARSE_COMMAND_LINE_OK;
+  char *end;
+  long num_workers;
+  int ii;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(argv != NULL);
+  assert(options != NULL);
+
+  /****************************************************************************/
+  /* Set the defaults for all options.                                        */
+  /****************************************************************************/
+  options->matrix_filename = NULL;
+  options->minimise_automaton = false;
+  options->lazy_automaton = false;
+  options->out_of_core_directory = NULL;
+  options->memory_budget_mb = DEFAULT_MEMORY_BUDGET_MB;
+  options->checkpoint_interval = OUT_OF_CORE_NO_CHECKPOINTS;
+  options->resume_build = false;
+  options->num_workers = 0;
+  options->shortlex_automaton = false;
+  options->coset_generators = NULL;
+  options->split_components = false;
+  options->compress_automaton = false;
+  options->sink_automaton = false;
+  options->renumber_mode = RENUMBER_NONE;
+  options->sample_filename = NULL;
+  options->source_prefix = NULL;
+  options->save_filename = NULL;
+  options->load_filename = NULL;
+  options->verify_load_file = false;
+  options->cache_directory = NULL;
+  options->exchange_condition = false;
+  options->batch_filename = NULL;
+  options->batch_output_filename = NULL;
+  options->batch_workers = 0;
+  options->batch_binary_input = false;
+  options->batch_binary_output = false;
+  options->batch_compare_pairs = false;
+  options->stream_filename = NULL;
+  options->stream_length_only = false;
+
+  /****************************************************************************/
+  /* Walk through the arguments, skipping the program name.                   */
+  /****************************************************************************/
+  for (ii = 1; ii < argc; ii++)
+  {
+    if (strcmp(argv[ii], "-f") == 0 && ii + 1 < argc)
+    {
+      ii++;
+      options->matrix_filename = argv[ii];
+    }
+    else if (strcmp(argv[ii], "-m") == 0)
+    {
+      options->minimise_automaton = true;
+    }
+    else if (strcmp(argv[ii], "-l") == 0)
+    {
+      options->lazy_automaton = true;
+    }
+    else if (strcmp(argv[ii], "-o") == 0 && ii + 1 < argc)
+    {
+      ii++;
+      options->out_of_core_directory = argv[ii];
+    }
+    else if (strcmp(argv[ii], "-M") == 0 && ii + 1 < argc)
+    {
+      ii++;
+      options->memory_budget_mb = strtol(argv[ii], &end, 10);
+      if (*end != '\0' || options->memory_budget_mb <= 0)
+      {
+        printf("Invalid memory budget %s.\n", argv[ii]);
+        ret_code = PARSE_COMMAND_LINE_INVALID;
+        goto EXIT_LABEL;
+      }
+    }
+    else if (strcmp(argv[ii], "-C") == 0 && ii + 1 < argc)
+    {
+      ii++;
+      options->checkpoint_interval = strtol(argv[ii], &end, 10);
+      if (*end != '\0' || options->checkpoint_interval < 0)
+      {
+        printf("Invalid checkpoint interval %s.\n", argv[ii]);
+        ret_code = PARSE_COMMAND_LINE_INVALID;
+        goto EXIT_LABEL;
+      }
+    }
+    else if (strcmp(argv[ii], "-R") == 0)
+    {
+      options->resume_build = true;
+    }
+    else if (strcmp(argv[ii], "-w") == 0 && ii + 1 < argc)
+    {
+      ii++;
+      num_workers = strtol(argv[ii], &end, 10);
+      if (*end != '\0' || num_workers <= 0 || num_workers > MAX_SHARD_WORKERS)
+      {
+        printf("Invalid number of workers %s.\n", argv[ii]);
+        ret_code = PARSE_COMMAND_LINE_INVALID;
+        goto EXIT_LABEL;
+      }
+      options->num_workers = (int) num_workers;
+    }
+    else if (strcmp(argv[ii], "-S") == 0)
+    {
+      options->shortlex_automaton = true;
+    }
+    else if (strcmp(argv[ii], "-J") == 0 && ii + 1 < argc)
+    {
+      ii++;
+      options->coset_generators = argv[ii];
+    }
+    else if (strcmp(argv[ii], "-c") == 0)
+    {
+      options->split_components = true;
+    }
+    else if (strcmp(argv[ii], "-z") == 0)
+    {
+      options->compress_automaton = true;
+    }
+    else if (strcmp(argv[ii], "-s") == 0)
+    {
+      options->sink_automaton = true;
+    }
+    else if (strcmp(argv[ii], "-B") == 0 &&
+             options->renumber_mode == RENUMBER_NONE)
+    {
+      options->renumber_mode = RENUMBER_BANDWIDTH;
+    }
+    else if (strcmp(argv[ii], "-F") == 0 &&
+             ii + 1 < argc &&
+             options->renumber_mode == RENUMBER_NONE)
+    {
+      ii++;
+      options->renumber_mode = RENUMBER_FREQUENCY;
+      options->sample_filename = argv[ii];
+    }
+    else if (strcmp(argv[ii], "-g") == 0 && ii + 1 < argc)
+    {
+      ii++;
+      if (!is_c_identifier(argv[ii]))
+      {
+        printf("The name %s is not a valid C identifier.\n", argv[ii]);
+        ret_code = PARSE_COMMAND_LINE_INVALID;
+        goto EXIT_LABEL;
+      }
+      options->source_prefix = argv[ii];
+    }
+    else if (strcmp(argv[ii], "-a") == 0 && ii + 1 < argc)
+    {
+      ii++;
+      options->save_filename = argv[ii];
+    }
+    else if (strcmp(argv[ii], "-A") == 0 && ii + 1 < argc)
+    {
+      ii++;
+      options->load_filename = argv[ii];
+    }
+    else if (strcmp(argv[ii], "-V") == 0)
+    {
+      options->verify_load_file = true;
+    }
+    else if (strcmp(argv[ii], "-K") == 0 && ii + 1 < argc)
+    {
+      ii++;
+      options->cache_directory = argv[ii];
+    }
+    else if (strcmp(argv[ii], "-x") == 0)
+    {
+      options->exchange_condition = true;
+    }
+    else if (strcmp(argv[ii], "-b") == 0 && ii + 1 < argc)
+    {
+      ii++;
+      options->batch_filename = argv[ii];
+    }
+    else if (strcmp(argv[ii], "-O") == 0 && ii + 1 < argc)
+    {
+      ii++;
+      options->batch_output_filename = argv[ii];
+    }
+    else if (strcmp(argv[ii], "-P") == 0 && ii + 1 < argc)
+    {
+      ii++;
+      num_workers = strtol(argv[ii], &end, 10);
+      if (*end != '\0' || num_workers <= 0 || num_workers > MAX_BATCH_WORKERS)
+      {
+        printf("Invalid number of processes %s.\n", argv[ii]);
+        ret_code = PARSE_COMMAND_LINE_INVALID;
+        goto EXIT_LABEL;
+      }
+      options->batch_workers = (int) num_workers;
+    }
+    else if (strcmp(argv[ii], "-e") == 0)
+    {
+      options->batch_binary_input = true;
+    }
+    else if (strcmp(argv[ii], "-E") == 0)
+    {
+      options->batch_binary_output = true;
+    }
+    else if (strcmp(argv[ii], "-Q") == 0)
+    {
+      options->batch_compare_pairs = true;
+    }
+    else if (strcmp(argv[ii], "-W") == 0 && ii + 1 < argc)
+    {
+      ii++;
+      options->stream_filename = argv[ii];
+    }
+    else if (strcmp(argv[ii], "-L") == 0)
+    {
+      options->stream_length_only = true;
+    }
+    else
+    {
+      printf("Unrecognised option %s.\n", argv[ii]);
+      ret_code = PARSE_COMMAND_LINE_INVALID;
+      goto EXIT_LABEL;
+    }
+  }
+
+  /****************************************************************************/
+  /* A lazy automaton is never complete so it can't be minimised, built on    */
+  /* disk, compressed, renumbered, written out, saved or cached.              */
+  /****************************************************************************/
+  if (options->minimise_automaton && options->lazy_automaton)
+  {
+    printf("The -m and -l options can't be used together.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+  if (options->out_of_core_directory != NULL && options->lazy_automaton)
+  {
+    printf("The -o and -l options can't be used together.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+  if (options->compress_automaton && options->lazy_automaton)
+  {
+    printf("The -z and -l options can't be used together.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+  if (options->sink_automaton && options->lazy_automaton)
+  {
+    printf("The -s and -l options can't be used together.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+  if (options->renumber_mode != RENUMBER_NONE && options->lazy_automaton)
+  {
+    printf("The -B and -F options can't be used with the -l option.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+  if (options->source_prefix != NULL && options->lazy_automaton)
+  {
+    printf("The -g and -l options can't be used together.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+  if (options->save_filename != NULL && options->lazy_automaton)
+  {
+    printf("The -a and -l options can't be used together.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+  if (options->cache_directory != NULL && options->lazy_automaton)
+  {
+    printf("The -K and -l options can't be used together.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* Only one form of the automaton can be used to check words.               */
+  /****************************************************************************/
+  if (options->sink_automaton && options->compress_automaton)
+  {
+    printf("The -s and -z options can't be used together.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* Only one way of building the automaton can be chosen.                    */
+  /****************************************************************************/
+  if (options->num_workers > 0 &&
+      (options->lazy_automaton || options->out_of_core_directory != NULL))
+  {
+    printf("The -w option can't be used with the -l or -o options.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+  if (options->load_filename != NULL &&
+      (options->lazy_automaton ||
+       options->out_of_core_directory != NULL ||
+       options->num_workers > 0))
+  {
+    printf("The -A option can't be used with the -l, -o or -w options.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+  if (options->load_filename == NULL && options->verify_load_file)
+  {
+    printf("The -V option can only be used with the -A option.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+  if (options->load_filename != NULL && options->cache_directory != NULL)
+  {
+    printf("The -A and -K options can't be used together.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+  if (options->exchange_condition &&
+      (options->lazy_automaton ||
+       options->out_of_core_directory != NULL ||
+       options->num_workers > 0 ||
+       options->load_filename != NULL ||
+       options->cache_directory != NULL))
+  {
+    printf("The -x option can't be used with the -l, -o, -w, -A or -K "
+           "options.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* The component automata are built in memory and only ever used side by    */
+  /* side, so there is no single table to change, write out or stream with.   */
+  /****************************************************************************/
+  if (options->split_components &&
+      (options->lazy_automaton ||
+       options->out_of_core_directory != NULL ||
+       options->num_workers > 0 ||
+       options->load_filename != NULL ||
+       options->cache_directory != NULL ||
+       options->exchange_condition))
+  {
+    printf("The -c option can't be used with the -l, -o, -w, -A, -K or -x "
+           "options.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+  if (options->split_components &&
+      (options->compress_automaton ||
+       options->sink_automaton ||
+       options->renumber_mode != RENUMBER_NONE ||
+       options->source_prefix != NULL ||
+       options->save_filename != NULL ||
+       options->stream_filename != NULL))
+  {
+    printf("The -c option can't be used with the -z, -s, -B, -F, -g, -a or -W "
+           "options.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* A mapped automaton is read only so it must be minimised and renumbered   */
+  /* before it is saved.                                                      */
+  /****************************************************************************/
+  if (options->load_filename != NULL &&
+      (options->minimise_automaton ||
+       options->renumber_mode != RENUMBER_NONE))
+  {
+    printf("The -A option can't be used with the -m, -B or -F options.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* The exchange condition reducer has no automaton to change or write out.  */
+  /****************************************************************************/
+  if (options->exchange_condition &&
+      (options->minimise_automaton ||
+       options->compress_automaton ||
+       options->sink_automaton ||
+       options->renumber_mode != RENUMBER_NONE ||
+       options->source_prefix != NULL ||
+       options->save_filename != NULL))
+  {
+    printf("The -x option can't be used with the -m, -z, -s, -B, -F, -g or -a "
+           "options.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* A batch is reduced with the flat table, the component automata or the    */
+  /* exchange condition and a stream with the flat table or the exchange      */
+  /* condition. The tables are only kept when the whole automaton is built    */
+  /* and not compressed or given a sink state.                                */
+  /****************************************************************************/
+  if (options->batch_filename != NULL &&
+      (options->lazy_automaton ||
+       options->compress_automaton ||
+       options->sink_automaton))
+  {
+    printf("The -b option can't be used with the -l, -z or -s options.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+  if (options->stream_filename != NULL &&
+      (options->batch_filename != NULL ||
+       options->lazy_automaton ||
+       options->compress_automaton ||
+       options->sink_automaton))
+  {
+    printf("The -W option can't be used with the -b, -l, -z or -s options.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+  if (options->batch_filename == NULL && options->batch_workers > 0)
+  {
+    printf("The -P option can only be used with the -b option.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+  if (options->batch_filename == NULL &&
+      options->stream_filename == NULL &&
+      options->batch_output_filename != NULL)
+  {
+    printf("The -O option can only be used with the -b or -W options.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+  if (options->batch_filename == NULL &&
+      (options->batch_binary_input || options->batch_binary_output))
+  {
+    printf("The -e and -E options can only be used with the -b option.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+  if (options->batch_filename == NULL && options->batch_compare_pairs)
+  {
+    printf("The -Q option can only be used with the -b option.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+  if (options->batch_compare_pairs &&
+      (options->batch_binary_input || options->batch_binary_output))
+  {
+    printf("The -Q option can't be used with the -e or -E options.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+  if (options->batch_binary_input && options->batch_workers > 0)
+  {
+    printf("The -e and -P options can't be used together.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+  if (options->stream_filename == NULL && options->stream_length_only)
+  {
+    printf("The -L option can only be used with the -W option.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* Checkpoints only exist for the on disk build.                            */
+  /****************************************************************************/
+  if (options->out_of_core_directory == NULL &&
+      (options->resume_build ||
+       options->checkpoint_interval != OUT_OF_CORE_NO_CHECKPOINTS))
+  {
+    printf("The -C and -R options need the -o option.\n");
+    ret_code = PARSE_COMMAND_LINE_INVALID;
+    goto EXIT_LABEL;
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
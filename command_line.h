@@ -0,0 +1,110 @@
+/******************************************************************************/
+/* Group: PARSE_COMMAND_LINE_RET_CODES                                        */
+/*                                                                            */
+/* The return codes for the function parse_command_line.                      */
+/******************************************************************************/
+#define PARSE_COMMAND_LINE_OK      0
+#define PARSE_COMMAND_LINE_INVALID 1
+
+/******************************************************************************/
+/* The number of megabytes the out of core construction may use for sorting   */
+/* if no other value is given.                                                */
+/******************************************************************************/
+#define DEFAULT_MEMORY_BUDGET_MB 64
+
+/******************************************************************************/
+/* This structure holds the options which the program was started with.       */
+/* matrix_filename - If not NULL then the Coxeter matrix is read from this    */
+/*                   file rather than asking for its name.                    */
+/* minimise_automaton - Run Hopcroft minimisation on the compiled automaton   */
+/*                      before any words are checked.                         */
+/* lazy_automaton - Only build the transitions of the automaton as words      */
+/*                  need them rather than the whole automaton up front.       */
+/* out_of_core_directory - If not NULL then build the automaton on disk in    */
+/*                         this directory.                                    */
+/* memory_budget_mb - The memory the out of core construction may use.        */
+/* checkpoint_interval - The least number of seconds between checkpoints of   */
+/*                       the out of core construction, or                     */
+/*                       OUT_OF_CORE_NO_CHECKPOINTS.                          */
+/* resume_build - Resume the out of core construction from its checkpoint.    */
+/* num_workers - If not 0 then build the automaton with this many worker      */
+/*               processes.                                                   */
+/* shortlex_automaton - Also build the ShortLex automaton and use it to say   */
+/*                      whether each reduced word is in normal form.          */
+/* coset_generators - If not NULL then the letters of the generators of a     */
+/*                    parabolic subgroup W_J. The automaton for the minimal   */
+/*                    coset representatives of W / W_J is also built.         */
+/* split_components - If the group is reducible then build one automaton for  */
+/*                    each component of the Coxeter graph rather than the     */
+/*                    automaton for the whole group.                          */
+/* compress_automaton - Check words with the compressed form of the compiled  */
+/*                      automaton rather than the flat table.                 */
+/* sink_automaton - Check words with the unrolled scan over a copy of the     */
+/*                  compiled automaton with a sink state.                     */
+/* renumber_mode - One of RENUMBER_MODES, the order the states of the         */
+/*                 compiled automaton are put in.                             */
+/* sample_filename - The words used to rank the states for                    */
+/*                   RENUMBER_FREQUENCY.                                      */
+/* source_prefix - If not NULL then the automaton is written out as C source  */
+/*                 to <source_prefix>.c with everything in it named           */
+/*                 <source_prefix>_...                                        */
+/* save_filename - If not NULL then the automaton is saved to this file.      */
+/* load_filename - If not NULL then the automaton is mapped from this file    */
+/*                 rather than being built.                                   */
+/* verify_load_file - Check every transition of the mapped automaton before   */
+/*                    using it rather than trusting the file.                 */
+/* cache_directory - If not NULL then the automaton is looked up in this      */
+/*                   cache directory, under any labelling of the generators,  */
+/*                   and added to it if it has to be built.                   */
+/* exchange_condition - Reduce words with the exchange condition on the       */
+/*                      minimal roots rather than building an automaton.      */
+/* batch_filename - If not NULL then the words in this file, one to a line,   */
+/*                  are reduced instead of asking for words. "-" reads them   */
+/*                  from the rest of stdin.                                   */
+/* batch_output_filename - If not NULL then the reduced words of a batch, or  */
+/*                         the reduced stream word, are written to this file  */
+/*                         rather than to stdout.                             */
+/* batch_workers - The number of processes a batch is reduced across. 0       */
+/*                 reduces it in the main process.                            */
+/* batch_binary_input - The words of a batch are in the binary encoding.      */
+/* batch_binary_output - Write the reduced words of a batch in the binary     */
+/*                       encoding.                                            */
+/* batch_compare_pairs - Each line of a batch is a pair of words, and whether */
+/*                       they are the same element is written for it.         */
+/* stream_filename - If not NULL then the whole of this file is read as one   */
+/*                   word of any length and reduced as it is read. "-" reads  */
+/*                   it from the rest of stdin.                               */
+/* stream_length_only - Write only the length of the reduced stream word.     */
+/******************************************************************************/
+typedef struct program_options
+{
+  char *matrix_filename;
+  bool minimise_automaton;
+  bool lazy_automaton;
+  char *out_of_core_directory;
+  long memory_budget_mb;
+  long checkpoint_interval;
+  bool resume_build;
+  int num_workers;
+  bool shortlex_automaton;
+  char *coset_generators;
+  bool split_components;
+  bool compress_automaton;
+  bool sink_automaton;
+  int renumber_mode;
+  char *sample_filename;
+  char *source_prefix;
+  char *save_filename;
+  char *load_filename;
+  bool verify_load_file;
+  char *cache_directory;
+  bool exchange_condition;
+  char *batch_filename;
+  char *batch_output_filename;
+  int batch_workers;
+  bool batch_binary_input;
+  bool batch_binary_output;
+  bool batch_compare_pairs;
+  char *stream_filename;
+  bool stream_length_only;
+} PROGRAM_OPTIONS;
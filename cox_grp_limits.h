@@ -4,6 +4,13 @@
 /******************************************************************************/
 #define MAX_WORD_LEN 200
 
+/******************************************************************************/
+/* The maximum length of a word typed with bracketed powers when they are     */
+/* worked out without being written out. Such a word is never expanded, so it */
+/* may be much longer than MAX_WORD_LEN and nested as deeply as it likes.     */
+/******************************************************************************/
+#define MAX_EXPRESSION_LEN 65536
+
 /******************************************************************************/
 /* The maximum number of generators in a group. This is set to 10 as the      */
 /* automaton for groups with more than 10 generators is likely to be very     */
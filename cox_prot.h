@@ -4,14 +4,125 @@
 extern int init_binary_tree_element(BINARY_TREE_ELEMENT **);
 extern void free_binary_tree_element(BINARY_TREE_ELEMENT *);
 extern int add_state_to_binary_tree(BINARY_TREE_ELEMENT **, AUTOMATON_STATE *, AUTOMATON_STATE **, int);
+/* automaton_cache.c */
+extern void search_canonical_labelling(CANONICAL_SEARCH *, int);
+extern void find_canonical_labelling(MATRIX_DATA *, int, CANONICAL_LABELLING *);
+extern int automaton_cache_filename(char *, CANONICAL_LABELLING *, char **);
+extern int relabel_automaton_table(AUTOMATON_TABLE *, int *, AUTOMATON_TABLE **);
+extern int load_cached_automaton(char *, MATRIX_DATA *, int, AUTOMATON_TABLE **);
+extern int store_cached_automaton(char *, MATRIX_DATA *, int, AUTOMATON_TABLE *);
+/* automaton_codegen.c */
+extern bool is_c_identifier(char *);
+extern int write_transition_array(FILE *, AUTOMATON_TABLE *, char *);
+extern int write_automaton_source(char *, AUTOMATON_TABLE *);
+/* automaton_compressed.c */
+extern int find_distinct_rows(AUTOMATON_TABLE *, uint32_t *, long *, long *);
+extern int reserve_compressed_slots(uint32_t **, uint32_t **, long *, long);
+extern int narrow_state_ids(uint32_t *, long, int, void **);
+extern int compress_automaton_table(AUTOMATON_TABLE *, COMPRESSED_AUTOMATON **);
+extern void free_compressed_automaton(COMPRESSED_AUTOMATON *);
+extern size_t compressed_automaton_size(COMPRESSED_AUTOMATON *);
+extern uint32_t compressed_next_state(COMPRESSED_AUTOMATON *, uint32_t, int);
+extern int scan_compressed_uint8(COMPRESSED_AUTOMATON *, char *, int, int, int);
+extern int scan_compressed_uint16(COMPRESSED_AUTOMATON *, char *, int, int, int);
+extern int scan_compressed_uint32(COMPRESSED_AUTOMATON *, char *, int, int, int);
+extern bool is_reduced_compressed(COMPRESSED_AUTOMATON *, char *, int *, int, int);
+/* automaton_file.c */
+extern uint64_t align_automaton_file_offset(uint64_t);
+extern int write_automaton_file_padding(FILE *, uint64_t);
+extern int save_automaton_file(char *, AUTOMATON_TABLE *, MATRIX_DATA *, ROOT_TABLE *);
+extern int map_automaton_file(char *, MAPPED_AUTOMATON **);
+extern void unmap_automaton_file(MAPPED_AUTOMATON *);
+extern bool automaton_file_matches_group(MAPPED_AUTOMATON *, MATRIX_DATA *, int);
+extern bool automaton_file_transitions_valid(MAPPED_AUTOMATON *);
 /* automaton_graph.c */
 extern int create_state(int, AUTOMATON_STATE **);
+extern int create_start_state(int, AUTOMATON_STATE **);
 extern void free_state(AUTOMATON_STATE *);
 extern void free_state_tree(BINARY_TREE_ELEMENT *);
 extern int compare_states(AUTOMATON_STATE *, AUTOMATON_STATE *, int);
 extern bool state_in_tree(AUTOMATON_STATE *, AUTOMATON_STATE *, AUTOMATON_STATE **, int);
 extern int generate_state_tree(MATRIX_DATA *, int, ROOT_TABLE *, AUTOMATON_STATE **, BINARY_TREE_ELEMENT **);
 extern int generate_next_automaton_state(MATRIX_DATA *, int, ROOT_TABLE *, AUTOMATON_STATE *, AUTOMATON_STATE *, BINARY_TREE_ELEMENT **, int);
+extern int find_next_automaton_state(MATRIX_DATA *, int, AUTOMATON_STATE *, BINARY_TREE_ELEMENT **, int, AUTOMATON_STATE **, bool *);
+extern int init_lazy_automaton(MATRIX_DATA *, int, LAZY_AUTOMATON **);
+extern void free_lazy_automaton(LAZY_AUTOMATON *);
+extern int lazy_next_state(LAZY_AUTOMATON *, AUTOMATON_STATE *, int, AUTOMATON_STATE **);
+extern bool is_reduced_lazy(LAZY_AUTOMATON *, char *, int *, int, int);
+/* automaton_interleaved.c */
+extern void fill_interleaved_lane(INTERLEAVED_SCAN *, int);
+extern void step_interleaved_scan(INTERLEAVED_SCAN *);
+extern void check_words_interleaved(AUTOMATON_TABLE *, char **, int *, long, int *);
+/* automaton_out_of_core.c */
+extern int out_of_core_path(char *, char *, char **);
+extern int init_out_of_core_build(ROOT_ACTION_TABLE *, char *, size_t, long, OUT_OF_CORE_BUILD **);
+extern void free_out_of_core_build(OUT_OF_CORE_BUILD *);
+extern int out_of_core_level_path(OUT_OF_CORE_BUILD *, char *, long, char **);
+extern FILE *open_out_of_core_level(OUT_OF_CORE_BUILD *, char *, long, char *);
+extern bool remove_out_of_core_level(OUT_OF_CORE_BUILD *, long);
+extern int write_start_state(OUT_OF_CORE_BUILD *);
+extern int expand_out_of_core_level(OUT_OF_CORE_BUILD *);
+extern int write_out_of_core_table(OUT_OF_CORE_BUILD *);
+extern int write_out_of_core_checkpoint(OUT_OF_CORE_BUILD *);
+extern int read_out_of_core_checkpoint(OUT_OF_CORE_BUILD *);
+extern int build_automaton_out_of_core(ROOT_ACTION_TABLE *, char *, size_t, long, bool, long *);
+extern int load_automaton_table_file(char *, AUTOMATON_TABLE **);
+/* automaton_renumber.c */
+extern int bandwidth_state_order(AUTOMATON_TABLE *, long *);
+extern int compare_state_visits(const void *, const void *, void *);
+extern int frequency_state_order(AUTOMATON_TABLE *, char **, long, int, long *);
+extern int renumber_automaton_table(AUTOMATON_TABLE *, long *);
+extern int load_sample_words(char *, int, char ***, long *);
+extern void free_sample_words(char **, long);
+extern int reorder_automaton_table(AUTOMATON_TABLE *, int, char **, long, int);
+/* automaton_sharded.c */
+extern int root_bitset_shard(const uint64_t *, int, int);
+extern int init_shard_worker(ROOT_ACTION_TABLE *, int, int, FILE *, FILE *, SHARD_WORKER **);
+extern void free_shard_worker(SHARD_WORKER *);
+extern int send_shard_candidates(SHARD_WORKER *);
+extern int send_shard_new_states(SHARD_WORKER *);
+extern int send_shard_transitions(SHARD_WORKER *);
+extern int run_shard_worker(SHARD_WORKER *);
+extern int init_sharded_build(ROOT_ACTION_TABLE *, int, SHARDED_BUILD **);
+extern void free_sharded_build(SHARDED_BUILD *);
+extern int start_shard_workers(SHARDED_BUILD *);
+extern int stop_shard_workers(SHARDED_BUILD *);
+extern int route_shard_candidates(SHARDED_BUILD *, long *);
+extern int grow_sharded_table(SHARDED_BUILD *, long);
+extern int number_shard_states(SHARDED_BUILD *);
+extern int collect_shard_transitions(SHARDED_BUILD *);
+extern int build_automaton_sharded(ROOT_ACTION_TABLE *, int, AUTOMATON_TABLE **);
+/* automaton_sink.c */
+extern int init_sink_automaton(AUTOMATON_TABLE *, SINK_AUTOMATON **);
+extern void free_sink_automaton(SINK_AUTOMATON *);
+extern bool is_reduced_sink(SINK_AUTOMATON *, char *, int *, int, int);
+/* automaton_table.c */
+extern int init_automaton_table(int, long, AUTOMATON_TABLE **);
+extern void free_automaton_table(AUTOMATON_TABLE *);
+extern int compile_state_tree(AUTOMATON_STATE *, int, AUTOMATON_TABLE **);
+extern int minimise_automaton_table(AUTOMATON_TABLE *, AUTOMATON_TABLE **, long **);
+extern int compile_root_action_subset(ROOT_ACTION_TABLE *, uint64_t *, int, int *, AUTOMATON_TABLE **);
+extern int compile_root_action_table(ROOT_ACTION_TABLE *, uint64_t *, AUTOMATON_TABLE **);
+extern int compile_coset_automaton(ROOT_ACTION_TABLE *, char *, AUTOMATON_TABLE **);
+extern int count_accepted_words(AUTOMATON_TABLE *, int, uint64_t *);
+extern bool is_reduced_table(AUTOMATON_TABLE *, char *, int *, int, int);
+extern bool is_reduced_generators(AUTOMATON_TABLE *, GENERATOR_WORD *, int *);
+/* batch_reduce.c */
+extern int init_batch_reduce(WORD_REDUCER *, int, int, bool, WORD_CORPUS *, BATCH_REDUCE **);
+extern void free_batch_reduce(BATCH_REDUCE *);
+extern int read_batch_chunk(BATCH_REDUCE *, FILE *, bool *);
+extern int reduce_batch_text(WORD_REDUCER *, const char *, size_t, RECORD_BUFFER *);
+extern int compare_batch_text(WORD_REDUCER *, const char *, size_t, RECORD_BUFFER *);
+extern int reduce_batch_chunk(WORD_REDUCER *, WORD_CORPUS *, bool, RECORD_BUFFER *, RECORD_BUFFER *);
+extern int write_batch_chunk(RECORD_BUFFER *, bool, FILE *);
+extern int run_batch_worker(WORD_REDUCER *, WORD_CORPUS *, bool, FILE *, FILE *);
+extern int start_batch_workers(BATCH_REDUCE *);
+extern int stop_batch_workers(BATCH_REDUCE *);
+extern int reduce_word_batch(WORD_REDUCER *, int, int, bool, WORD_CORPUS *, FILE *, bool, FILE *, long *);
+extern int reduce_binary_batch(WORD_REDUCER *, int, FILE *, bool, FILE *, long *);
+/* command_line.c */
+extern void print_usage(char *);
+extern int parse_command_line(int, char **, PROGRAM_OPTIONS *);
 /* cox_action.c */
 extern double cox_scalar_product(MATRIX_DATA *, int, int);
 extern double cox_scalar_product_root(MATRIX_DATA *, int, ROOT *, int);
@@ -20,6 +131,35 @@ extern double cox_action(MATRIX_DATA *, int, int, int);
 extern int fill_cox_action_matrix(MATRIX_DATA *, int);
 extern int cox_action_on_root(MATRIX_DATA *, int, int, ROOT *, ROOT **, ROOT_TABLE *, _Bool *);
 extern int cox_action_on_root_list(ROOT_TABLE *, ROOT_TABLE **, int, int, MATRIX_DATA *);
+/* coxeter_components.c */
+extern int find_coxeter_components(MATRIX_DATA *, int, int *);
+extern int init_component_automaton(MATRIX_DATA *, ROOT_TABLE *, int, COMPONENT_AUTOMATON **);
+extern int minimise_component_automaton(COMPONENT_AUTOMATON *);
+extern void free_component_automaton(COMPONENT_AUTOMATON *);
+extern bool is_reduced_components(COMPONENT_AUTOMATON *, char *, int *, int, int);
+/* exchange_reducer.c */
+extern int init_exchange_reducer(MATRIX_DATA *, ROOT_TABLE *, int, EXCHANGE_REDUCER **);
+extern void free_exchange_reducer(EXCHANGE_REDUCER *);
+extern int exchange_reduce_letter(EXCHANGE_REDUCER *, int);
+extern int exchange_reduce_generator_word(EXCHANGE_REDUCER *, GENERATOR_WORD *);
+/* external_sort.c */
+extern int init_external_sort(char *, size_t, RECORD_COMPARE, void *, size_t, EXTERNAL_SORT **);
+extern void free_external_sort(EXTERNAL_SORT *);
+extern int external_sort_run_filename(EXTERNAL_SORT *, long, char **);
+extern void sort_records(char *, long, size_t, RECORD_COMPARE, void *, char *);
+extern void swap_records(char *, long, long, size_t, char *);
+extern void sift_down_record(char *, long, long, size_t, RECORD_COMPARE, void *, char *);
+extern int write_sorted_run(EXTERNAL_SORT *);
+extern int external_sort_add(EXTERNAL_SORT *, const void *);
+extern int external_sort_flush(EXTERNAL_SORT *);
+extern void restore_external_sort(EXTERNAL_SORT *, long, long);
+extern void remove_stale_runs(EXTERNAL_SORT *, long);
+extern void merge_heap_sift_down(EXTERNAL_SORT *, int);
+extern int open_merge(EXTERNAL_SORT *, int);
+extern void close_merge(EXTERNAL_SORT *);
+extern bool merge_next(EXTERNAL_SORT *, void *);
+extern int external_sort_finish(EXTERNAL_SORT *);
+extern bool external_sort_next(EXTERNAL_SORT *, void *);
 /* file_input_output_matrix.c */
 extern int load_matrix_from_file(char *, long, long, long ***, MATRIX_FILE_INFO **);
 extern void free_file_info(MATRIX_FILE_INFO *);
@@ -28,7 +168,29 @@ extern bool is_symmetric(long **, int);
 extern bool is_reduced(AUTOMATON_STATE *, char *, int *, int, int);
 extern int init_matrix_data(MATRIX_DATA **, int);
 extern void free_matrix_data(MATRIX_DATA *, int);
-extern int main(void);
+extern bool check_word(AUTOMATON_TABLE *, SINK_AUTOMATON *, COMPRESSED_AUTOMATON *, COMPONENT_AUTOMATON *, LAZY_AUTOMATON *, char *, int *, int, int);
+extern int main(int, char **);
+/* record_pipe.c */
+extern int init_record_buffer(size_t, RECORD_BUFFER **);
+extern void free_record_buffer(RECORD_BUFFER *);
+extern int reserve_record_buffer(RECORD_BUFFER *, long);
+extern int append_record(RECORD_BUFFER *, const void *);
+extern int write_record_message(FILE *, RECORD_BUFFER *);
+extern int read_record_message(FILE *, RECORD_BUFFER *);
+/* root_bitset.c */
+extern int init_root_action_table(MATRIX_DATA *, ROOT_TABLE *, int, ROOT_ACTION_TABLE **);
+extern void free_root_action_table(ROOT_ACTION_TABLE *);
+extern void add_shortlex_roots(ROOT_ACTION_TABLE *);
+extern bool root_bitset_next_state(ROOT_ACTION_TABLE *, uint64_t *, int, uint64_t *);
+extern int compare_root_bitsets(const uint64_t *, const uint64_t *, int);
+extern int compare_root_bitset_records(const void *, const void *, void *);
+extern uint64_t hash_root_bitset(const uint64_t *, int);
+extern int init_root_bitset_index(int, ROOT_BITSET_INDEX **);
+extern void free_root_bitset_index(ROOT_BITSET_INDEX *);
+extern uint64_t *find_root_bitset_slot(ROOT_BITSET_INDEX *, const uint64_t *);
+extern bool find_in_root_bitset_index(ROOT_BITSET_INDEX *, const uint64_t *, int64_t *);
+extern int grow_root_bitset_index(ROOT_BITSET_INDEX *);
+extern int set_in_root_bitset_index(ROOT_BITSET_INDEX *, const uint64_t *, int64_t);
 /* root_table.c */
 extern int init_root(int, ROOT **);
 extern void free_root(ROOT *);
@@ -47,6 +209,7 @@ extern int output_root_table(FILE *, ROOT_TABLE *, int);
 extern void flush_stdin(void);
 extern int input_string(int, char **);
 extern int user_input_word(int, int, char **);
+extern int user_input_expression(char **);
 extern int user_input_file(char **);
 /* string_stack.c */
 extern int init_string_stack_element(int, STRING_STACK_ELEMENT **);
@@ -54,3 +217,48 @@ extern void free_string_stack_element(STRING_STACK_ELEMENT *);
 extern int string_stack_push(char *, STRING_STACK_ELEMENT **);
 extern char *string_stack_pop(STRING_STACK_ELEMENT **);
 extern void empty_string_stack(STRING_STACK_ELEMENT *);
+/* word_reducer.c */
+extern int init_word_reducer(AUTOMATON_TABLE *, WORD_REDUCER **);
+extern int init_component_word_reducer(COMPONENT_AUTOMATON *, WORD_REDUCER **);
+extern int init_exchange_word_reducer(EXCHANGE_REDUCER *, WORD_REDUCER **);
+extern void free_word_reducer(WORD_REDUCER *);
+extern int reduce_word(WORD_REDUCER *, char *, int *);
+extern int reserve_word_reducer(WORD_REDUCER *, size_t);
+extern int reduce_table_word(AUTOMATON_TABLE *, int32_t *, uint8_t *, int32_t *, int);
+extern int reduce_generator_word(WORD_REDUCER *, GENERATOR_WORD *);
+extern int reduce_component_word(WORD_REDUCER *, GENERATOR_WORD *);
+/* word_corpus.c */
+extern int map_word_corpus(char *, WORD_CORPUS **);
+extern void unmap_word_corpus(WORD_CORPUS *);
+extern int next_corpus_chunk(WORD_CORPUS *, int, bool, size_t, size_t *, size_t *);
+/* stream_reducer.c */
+extern int init_stream_reducer(AUTOMATON_TABLE *, STREAM_REDUCER **);
+extern int init_exchange_stream_reducer(EXCHANGE_REDUCER *, STREAM_REDUCER **);
+extern void free_stream_reducer(STREAM_REDUCER *);
+extern int stream_reduce_letter(STREAM_REDUCER *, int);
+extern int stream_reduce_file(STREAM_REDUCER *, FILE *, long *);
+extern int write_stream_reducer(STREAM_REDUCER *, FILE *, bool);
+/* generator_word.c */
+extern int init_generator_word(GENERATOR_WORD **);
+extern void free_generator_word(GENERATOR_WORD *);
+extern int reserve_generator_word(GENERATOR_WORD *, int);
+extern int encode_generator_word(const char *, int, int, GENERATOR_WORD *);
+extern void decode_generator_word(GENERATOR_WORD *, char *);
+extern int write_word_file_header(FILE *, int);
+extern int read_word_file_header(FILE *, int);
+extern int write_generator_word(FILE *, GENERATOR_WORD *);
+extern int read_generator_word(FILE *, int, GENERATOR_WORD *);
+/* word_problem.c */
+extern int words_equal(WORD_REDUCER *, GENERATOR_WORD *, GENERATOR_WORD *, GENERATOR_WORD *, bool *);
+extern int words_equal_text(WORD_REDUCER *, const char *, int, const char *, int, GENERATOR_WORD **, bool *);
+/* word_power.c */
+extern int multiply_generator_words(WORD_REDUCER *, GENERATOR_WORD *, GENERATOR_WORD *, GENERATOR_WORD *);
+extern int power_reduced_word(WORD_REDUCER *, GENERATOR_WORD *, uint64_t, GENERATOR_WORD *);
+extern int evaluate_word_expression(WORD_REDUCER *, const char *, GENERATOR_WORD *);
+/* word_program.c */
+extern int init_word_program(WORD_PROGRAM **);
+extern void free_word_program(WORD_PROGRAM *);
+extern uint64_t hash_word_program_node(WORD_PROGRAM *, int, int, int, uint64_t);
+extern int add_word_program_node(WORD_PROGRAM *, int, int, int, uint64_t, int *);
+extern int parse_word_program(WORD_PROGRAM *, const char *, int);
+extern int evaluate_word_program(WORD_REDUCER *, WORD_PROGRAM *, GENERATOR_WORD *);
@@ -0,0 +1,376 @@
+#include "cox_prot.h"
+
+/******************************************************************************/
+/* Function: find_coxeter_components                                          */
+/*                                                                            */
+/* Returns: The number of connected components of the Coxeter graph.          */
+/*                                                                            */
+/* Parameters: IN     matrix_data - Precalculated information about the group.*/
+/*             IN     num_generators - The number of group generators.        */
+/*             OUT    component_of - An array with one entry per generator    */
+/*                                   which is filled in with the component    */
+/*                                   containing that generator.               */
+/*                                                                            */
+/* Operation: Two generators are joined in the Coxeter graph unless they      */
+/*            commute, that is unless their entry in the Coxeter matrix is 2. */
+/*            Flood fill from each generator not yet given a component, so    */
+/*            the components are numbered in order of their first generator.  */
+/******************************************************************************/
+int find_coxeter_components(MATRIX_DATA *matrix_data,
+                            int num_generators,
+                            int *component_of)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int num_components = 0;
+  int stack[MAX_GENERATORS];
+  int stack_size;
+  int current;
+  int gg;
+  int hh;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(matrix_data != NULL);
+  assert(num_generators > 0 && num_generators <= MAX_GENERATORS);
+  assert(component_of != NULL);
+
+  for (gg = 0; gg < num_generators; gg++)
+  {
+    component_of[gg] = -1;
+  }
+
+  for (gg = 0; gg < num_generators; gg++)
+  {
+    if (component_of[gg] != -1)
+    {
+      continue;
+    }
+
+    /**************************************************************************/
+    /* Each generator is pushed at most once as it is given its component     */
+    /* before being pushed, so the stack can't overflow.                      */
+    /**************************************************************************/
+    component_of[gg] = num_components;
+    stack[0] = gg;
+    stack_size = 1;
+    while (stack_size > 0)
+    {
+      current = stack[--stack_size];
+      for (hh = 0; hh < num_generators; hh++)
+      {
+        if (hh != current &&
+            component_of[hh] == -1 &&
+            matrix_data->coxeter_matrix[current][hh] != 2)
+        {
+          component_of[hh] = num_components;
+          stack[stack_size++] = hh;
+        }
+      }
+    }
+    num_components++;
+  }
+
+  return(num_components);
+}
+
+/******************************************************************************/
+/* Function: init_component_automaton                                         */
+/*                                                                            */
+/* Returns: One of INIT_COMPONENT_AUTOMATON_RET_CODES.                        */
+/*                                                                            */
+/* Parameters: IN     matrix_data - Precalculated information about the group.*/
+/*             IN     minimal_root_table - The minimal roots of the group.    */
+/*             IN     num_generators - The number of group generators.        */
+/*             OUT    component_automaton - Will be returned holding one      */
+/*                                          automaton for each component of   */
+/*                                          the Coxeter graph.                */
+/*                                                                            */
+/* Operation: The minimal roots of a reducible group are the minimal roots of */
+/*            its components and a generator only moves roots in its own      */
+/*            component. So the automaton for each component is built from    */
+/*            the action of the whole group on its minimal roots but reading  */
+/*            only the generators of that component. The states reached then  */
+/*            only ever hold roots of that component.                         */
+/******************************************************************************/
+int init_component_automaton(MATRIX_DATA *matrix_data,
+                             ROOT_TABLE *minimal_root_table,
+                             int num_generators,
+                             COMPONENT_AUTOMATON **component_automaton)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = INIT_COMPONENT_AUTOMATON_OK;
+  ROOT_ACTION_TABLE *action_table = NULL;
+  COMPONENT_AUTOMATON *components;
+  int generators[MAX_GENERATORS];
+  int num_component_generators;
+  int cc;
+  int gg;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(matrix_data != NULL);
+  assert(minimal_root_table != NULL);
+  assert(component_automaton != NULL);
+
+  components = (COMPONENT_AUTOMATON *) malloc(sizeof(COMPONENT_AUTOMATON));
+  *component_automaton = components;
+  if (components == NULL)
+  {
+    ret_code = INIT_COMPONENT_AUTOMATON_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  components->num_generators = num_generators;
+  components->num_components =
+             find_coxeter_components(matrix_data,
+                                     num_generators,
+                                     components->component_of);
+  components->num_states = 0;
+  for (cc = 0; cc < MAX_GENERATORS; cc++)
+  {
+    components->tables[cc] = NULL;
+  }
+
+  if (init_root_action_table(matrix_data,
+                             minimal_root_table,
+                             num_generators,
+                             &action_table) != INIT_ROOT_ACTION_TABLE_OK)
+  {
+    ret_code = INIT_COMPONENT_AUTOMATON_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* Build the automaton for each component in turn, giving each generator    */
+  /* the column it is read from in its component's table.                     */
+  /****************************************************************************/
+  for (cc = 0; cc < components->num_components; cc++)
+  {
+    num_component_generators = 0;
+    for (gg = 0; gg < num_generators; gg++)
+    {
+      if (components->component_of[gg] == cc)
+      {
+        components->local_generator[gg] = num_component_generators;
+        generators[num_component_generators++] = gg;
+      }
+    }
+
+    ret_code = compile_root_action_subset(action_table,
+                                          NULL,
+                                          num_component_generators,
+                                          generators,
+                                          &(components->tables[cc]));
+    if (ret_code == COMPILE_ROOT_ACTION_TABLE_MEM_ERR)
+    {
+      ret_code = INIT_COMPONENT_AUTOMATON_MEM_ERR;
+      goto EXIT_LABEL;
+    }
+    if (ret_code == COMPILE_ROOT_ACTION_TABLE_TOO_MANY_STATES)
+    {
+      ret_code = INIT_COMPONENT_AUTOMATON_TOO_MANY_STATES;
+      goto EXIT_LABEL;
+    }
+    ret_code = INIT_COMPONENT_AUTOMATON_OK;
+    components->num_states += components->tables[cc]->num_states;
+  }
+
+EXIT_LABEL:
+
+  if (action_table != NULL)
+  {
+    free_root_action_table(action_table);
+  }
+  if (ret_code != INIT_COMPONENT_AUTOMATON_OK && components != NULL)
+  {
+    free_component_automaton(components);
+    *component_automaton = NULL;
+  }
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: minimise_component_automaton                                     */
+/*                                                                            */
+/* Returns: One of MINIMISE_AUTOMATON_TABLE_RET_CODES.                        */
+/*                                                                            */
+/* Parameters: IN/OUT component_automaton - The automata to be minimised.     */
+/*                                                                            */
+/* Operation: Replace each component's automaton with its minimal automaton.  */
+/*            The product of minimal automata is not in general minimal but   */
+/*            it is never built so this is the best which can be done.        */
+/******************************************************************************/
+int minimise_component_automaton(COMPONENT_AUTOMATON *component_automaton)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = MINIMISE_AUTOMATON_TABLE_OK;
+  AUTOMATON_TABLE *minimal_table;
+  int cc;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(component_automaton != NULL);
+
+  component_automaton->num_states = 0;
+  for (cc = 0; cc < component_automaton->num_components; cc++)
+  {
+    ret_code = minimise_automaton_table(component_automaton->tables[cc],
+                                        &minimal_table,
+                                        NULL);
+    if (ret_code != MINIMISE_AUTOMATON_TABLE_OK)
+    {
+      goto EXIT_LABEL;
+    }
+    free_automaton_table(component_automaton->tables[cc]);
+    component_automaton->tables[cc] = minimal_table;
+    component_automaton->num_states += minimal_table->num_states;
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: free_component_automaton                                         */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     component_automaton - The automata to be freed.         */
+/*                                                                            */
+/* Operation: Free each component's automaton and then the structure itself.  */
+/******************************************************************************/
+void free_component_automaton(COMPONENT_AUTOMATON *component_automaton)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int cc;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(component_automaton != NULL);
+
+  for (cc = 0; cc < component_automaton->num_components; cc++)
+  {
+    if (component_automaton->tables[cc] != NULL)
+    {
+      free_automaton_table(component_automaton->tables[cc]);
+    }
+  }
+  free(component_automaton);
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: is_reduced_components                                            */
+/*                                                                            */
+/* Returns: true if the word is reduced and false otherwise.                  */
+/*                                                                            */
+/* Parameters: IN     component_automaton - The automata for the components.  */
+/*             IN     word - A string consisting of a number of letters which */
+/*                           correspond to generators in the group.           */
+/*             OUT    fail_index - The index in the word that the word was no */
+/*                                 longer reduced. 0 if the word was reduced. */
+/*             IN     start_index - The first letter to be read.              */
+/*             IN     finish_index - One past the last letter to be read. If  */
+/*                                   this is less than start_index then the   */
+/*                                   word is read from right to left.         */
+/*                                                                            */
+/* Operation: The same as is_reduced_table but keeping one state for each     */
+/*            component. Each letter only moves the state of its own          */
+/*            component, and the word fails as soon as any component          */
+/*            rejects.                                                        */
+/*            The language of reduced words is closed under reversal so the   */
+/*            same automata serve in either direction.                        */
+/******************************************************************************/
+bool is_reduced_components(COMPONENT_AUTOMATON *component_automaton,
+                           char *word,
+                           int *fail_index,
+                           int start_index,
+                           int finish_index)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  bool reduced = true;
+  int ii = start_index;
+  int direction;
+  int generator_index;
+  int component;
+  int column;
+  int32_t states[MAX_GENERATORS];
+  AUTOMATON_TABLE *table;
+  int cc;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(component_automaton != NULL);
+  assert(word != NULL);
+
+  /****************************************************************************/
+  /* Work out which way through the word we are going.                        */
+  /****************************************************************************/
+  if (finish_index > start_index)
+  {
+    direction = SEARCH_FORWARDS;
+  }
+  else if (finish_index < start_index)
+  {
+    direction = SEARCH_BACKWARDS;
+  }
+  else
+  {
+    goto EXIT_LABEL;
+  }
+
+  for (cc = 0; cc < component_automaton->num_components; cc++)
+  {
+    states[cc] = component_automaton->tables[cc]->start_state;
+  }
+
+  /****************************************************************************/
+  /* Loop through the word moving the state of the letter's component each    */
+  /* time. If any component reaches the reject state then the word is not     */
+  /* reduced.                                                                 */
+  /****************************************************************************/
+  for (ii = start_index; ii != finish_index; ii += direction)
+  {
+    generator_index = (int) word[ii] - ASCII_LOWER_A;
+    component = component_automaton->component_of[generator_index];
+    column = component_automaton->local_generator[generator_index];
+    table = component_automaton->tables[component];
+    states[component] = table->transitions[states[component] *
+                                           table->num_generators + column];
+    if (states[component] == AUTOMATON_TABLE_REJECT_STATE)
+    {
+      reduced = false;
+      goto EXIT_LABEL;
+    }
+  }
+
+EXIT_LABEL:
+
+  if (reduced == false)
+  {
+    *fail_index = ii;
+  }
+  else
+  {
+    *fail_index = 0;
+  }
+
+  return(reduced);
+}
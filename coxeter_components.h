@@ -0,0 +1,31 @@
+/******************************************************************************/
+/* Group: INIT_COMPONENT_AUTOMATON_RET_CODES                                  */
+/*                                                                            */
+/* The return codes for function init_component_automaton.                    */
+/******************************************************************************/
+#define INIT_COMPONENT_AUTOMATON_OK              0
+#define INIT_COMPONENT_AUTOMATON_MEM_ERR         1
+#define INIT_COMPONENT_AUTOMATON_TOO_MANY_STATES 2
+
+/******************************************************************************/
+/* This structure holds one automaton for each connected component of the     */
+/* Coxeter graph. A reducible group is the direct product of its components,  */
+/* so a word is reduced exactly when the letters from each component form a   */
+/* reduced word in that component. The automaton for the whole group is the   */
+/* product of the component automata and is run on the fly as a tuple of      */
+/* states, so the memory needed is the sum of the component sizes rather than */
+/* their product.                                                             */
+/* component_of[g] - The component containing generator g.                    */
+/* local_generator[g] - The column for generator g in its component's table.  */
+/* tables[c] - The automaton for component c.                                 */
+/* num_states - The total number of states across all the tables.             */
+/******************************************************************************/
+typedef struct component_automaton
+{
+  int num_generators;
+  int num_components;
+  int component_of[MAX_GENERATORS];
+  int local_generator[MAX_GENERATORS];
+  AUTOMATON_TABLE *tables[MAX_GENERATORS];
+  long num_states;
+} COMPONENT_AUTOMATON;
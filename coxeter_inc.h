@@ -1,9 +1,23 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 #include <math.h>
 #include <assert.h>
+#include <errno.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 #include "root_table.h"
 #include "automaton_graph.h"
 #include "file_input_output_matrix.h"
@@ -11,5 +25,29 @@
 #include "user_input.h"
 #include "cox_action.h"
 #include "automaton_binary_tree.h"
+#include "automaton_table.h"
+#include "automaton_compressed.h"
+#include "automaton_sink.h"
+#include "automaton_interleaved.h"
+#include "automaton_renumber.h"
+#include "automaton_codegen.h"
+#include "automaton_file.h"
+#include "automaton_cache.h"
+#include "root_bitset.h"
+#include "external_sort.h"
+#include "automaton_out_of_core.h"
+#include "record_pipe.h"
+#include "automaton_sharded.h"
+#include "coxeter_components.h"
+#include "command_line.h"
 #include "string_stack.h"
+#include "generator_word.h"
+#include "exchange_reducer.h"
+#include "word_reducer.h"
+#include "word_corpus.h"
+#include "batch_reduce.h"
+#include "stream_reducer.h"
+#include "word_problem.h"
+#include "word_power.h"
+#include "word_program.h"
 #include "main.h"
@@ -0,0 +1,257 @@
+#include "cox_prot.h"
+
+/******************************************************************************/
+/* Function: init_exchange_reducer                                            */
+/*                                                                            */
+/* Returns: One of EXCHANGE_REDUCER_RET_CODES.                                */
+/*                                                                            */
+/* Parameters: IN     matrix_data - Precalculated information about the group.*/
+/*             IN     minimal_root_table - The minimal roots of the group.    */
+/*             IN     num_generators - The number of group generators.        */
+/*             OUT    reducer - Will be returned holding the empty word.      */
+/*                                                                            */
+/* Operation: Number the minimal roots and work out the action of each        */
+/*            generator on them, then allocate room for the letters and the   */
+/*            bitsets. The bitset for the empty word is empty.                */
+/******************************************************************************/
+int init_exchange_reducer(MATRIX_DATA *matrix_data,
+                          ROOT_TABLE *minimal_root_table,
+                          int num_generators,
+                          EXCHANGE_REDUCER **reducer)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = EXCHANGE_REDUCER_OK;
+  int num_words;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(matrix_data != NULL);
+  assert(minimal_root_table != NULL);
+  assert(num_generators > 0 && num_generators <= MAX_GENERATORS);
+  assert(reducer != NULL);
+
+  *reducer = (EXCHANGE_REDUCER *) calloc(1, sizeof(EXCHANGE_REDUCER));
+  if (*reducer == NULL)
+  {
+    ret_code = EXCHANGE_REDUCER_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  if (init_root_action_table(matrix_data,
+                             minimal_root_table,
+                             num_generators,
+                             &((*reducer)->action_table)) !=
+                                                   INIT_ROOT_ACTION_TABLE_OK)
+  {
+    free_exchange_reducer(*reducer);
+    *reducer = NULL;
+    ret_code = EXCHANGE_REDUCER_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  num_words = (*reducer)->action_table->num_words;
+  (*reducer)->capacity = EXCHANGE_REDUCER_INITIAL_CAPACITY;
+  (*reducer)->letters = (char *) malloc(EXCHANGE_REDUCER_INITIAL_CAPACITY);
+  (*reducer)->states = (uint64_t *) calloc(
+                                 (EXCHANGE_REDUCER_INITIAL_CAPACITY + 1) *
+                                                          (size_t) num_words,
+                                 sizeof(uint64_t));
+  if ((*reducer)->letters == NULL || (*reducer)->states == NULL)
+  {
+    free_exchange_reducer(*reducer);
+    *reducer = NULL;
+    ret_code = EXCHANGE_REDUCER_MEM_ERR;
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: free_exchange_reducer                                            */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     reducer - The reducer to be freed.                      */
+/*                                                                            */
+/* Operation: Free the action table, the letters, the bitsets and then the    */
+/*            reducer itself.                                                 */
+/******************************************************************************/
+void free_exchange_reducer(EXCHANGE_REDUCER *reducer)
+{
+  assert(reducer != NULL);
+
+  if (reducer->action_table != NULL)
+  {
+    free_root_action_table(reducer->action_table);
+  }
+  free(reducer->letters);
+  free(reducer->states);
+  free(reducer);
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: exchange_reduce_letter                                           */
+/*                                                                            */
+/* Returns: One of EXCHANGE_REDUCER_RET_CODES.                                */
+/*                                                                            */
+/* Parameters: IN/OUT reducer - The reducer.                                  */
+/*             IN     generator - The generator to multiply by on the right.  */
+/*                                                                            */
+/* Operation: If the simple root a_s of the generator s isn't in the bitset   */
+/*            for the reduced word w = s_1 ... s_k then w s is reduced and s  */
+/*            goes on the end. Otherwise the exchange condition says w s is w */
+/*            with the letter s_j deleted, where s_j is the last letter for   */
+/*            which s_j+1 ... s_k (a_s) is the simple root of s_j. Each root  */
+/*            s_m+1 ... s_k (a_s) met on the way is in the bitset for         */
+/*            s_1 ... s_m so is minimal, and reading back from the end finds  */
+/*            s_j with one lookup in the action table for each letter. Once   */
+/*            it is deleted the bitsets after it are worked out again.        */
+/******************************************************************************/
+int exchange_reduce_letter(EXCHANGE_REDUCER *reducer, int generator)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = EXCHANGE_REDUCER_OK;
+  ROOT_ACTION_TABLE *action_table = reducer->action_table;
+  int num_generators = action_table->num_generators;
+  int num_words = action_table->num_words;
+  char *new_letters;
+  uint64_t *new_states;
+  long root_id;
+  size_t cancel_index;
+  bool accepted;
+  int letter;
+
+  /****************************************************************************/
+  /* Make room for the letter and the bitset after it.                        */
+  /****************************************************************************/
+  if (reducer->length == reducer->capacity)
+  {
+    new_letters = (char *) realloc(reducer->letters, reducer->capacity * 2);
+    if (new_letters == NULL)
+    {
+      ret_code = EXCHANGE_REDUCER_MEM_ERR;
+      goto EXIT_LABEL;
+    }
+    reducer->letters = new_letters;
+    new_states = (uint64_t *) realloc(reducer->states,
+                                      sizeof(uint64_t) *
+                                      (reducer->capacity * 2 + 1) *
+                                      (size_t) num_words);
+    if (new_states == NULL)
+    {
+      ret_code = EXCHANGE_REDUCER_MEM_ERR;
+      goto EXIT_LABEL;
+    }
+    reducer->states = new_states;
+    reducer->capacity *= 2;
+  }
+
+  if (root_bitset_next_state(action_table,
+                             reducer->states + reducer->length * num_words,
+                             generator,
+                             reducer->states +
+                                          (reducer->length + 1) * num_words))
+  {
+    reducer->letters[reducer->length] = (char) (ASCII_LOWER_A + generator);
+    reducer->length++;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* Find the letter the rejected one cancels with. The simple root is in the */
+  /* bitset so this always happens before running out of letters.             */
+  /****************************************************************************/
+  root_id = action_table->simple_root_ids[generator];
+  for (cancel_index = reducer->length - 1; ; cancel_index--)
+  {
+    letter = (int) reducer->letters[cancel_index] - ASCII_LOWER_A;
+    if (root_id == action_table->simple_root_ids[letter])
+    {
+      break;
+    }
+    root_id = action_table->actions[root_id * num_generators + letter];
+    assert(root_id != ROOT_BITSET_NOT_MINIMAL && cancel_index > 0);
+  }
+
+  /****************************************************************************/
+  /* Delete it and work out the bitsets after it again. What is left is the   */
+  /* reduced word with the rejected letter on the end, so it is reduced.      */
+  /****************************************************************************/
+  memmove(reducer->letters + cancel_index,
+          reducer->letters + cancel_index + 1,
+          reducer->length - cancel_index - 1);
+  reducer->length--;
+  for (; cancel_index < reducer->length; cancel_index++)
+  {
+    letter = (int) reducer->letters[cancel_index] - ASCII_LOWER_A;
+    accepted = root_bitset_next_state(action_table,
+                                      reducer->states +
+                                                cancel_index * num_words,
+                                      letter,
+                                      reducer->states +
+                                          (cancel_index + 1) * num_words);
+    assert(accepted);
+    (void) accepted;
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: exchange_reduce_generator_word                                   */
+/*                                                                            */
+/* Returns: One of EXCHANGE_REDUCER_RET_CODES.                                */
+/*                                                                            */
+/* Parameters: IN/OUT reducer - The reducer to use. Anything it held before   */
+/*                              is discarded.                                 */
+/*             IN/OUT word - The word to be reduced. Will be returned holding */
+/*                           the reduced word.                                */
+/*                                                                            */
+/* Operation: Start from the empty word, multiply by each letter in turn with */
+/*            exchange_reduce_letter and copy the reduced word back.          */
+/******************************************************************************/
+int exchange_reduce_generator_word(EXCHANGE_REDUCER *reducer,
+                                   GENERATOR_WORD *word)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = EXCHANGE_REDUCER_OK;
+  int ii;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(reducer != NULL);
+  assert(word != NULL);
+
+  reducer->length = 0;
+  for (ii = 0; ii < word->length; ii++)
+  {
+    ret_code = exchange_reduce_letter(reducer, word->generators[ii]);
+    if (ret_code != EXCHANGE_REDUCER_OK)
+    {
+      goto EXIT_LABEL;
+    }
+  }
+  for (ii = 0; ii < (int) reducer->length; ii++)
+  {
+    word->generators[ii] =
+                       (uint8_t) ((int) reducer->letters[ii] - ASCII_LOWER_A);
+  }
+  word->length = (int) reducer->length;
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
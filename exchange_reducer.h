@@ -0,0 +1,43 @@
+/******************************************************************************/
+/* Group: EXCHANGE_REDUCER_RET_CODES                                          */
+/*                                                                            */
+/* The return codes for functions init_exchange_reducer,                      */
+/* exchange_reduce_letter and exchange_reduce_generator_word.                 */
+/******************************************************************************/
+#define EXCHANGE_REDUCER_OK      0
+#define EXCHANGE_REDUCER_MEM_ERR 1
+
+/******************************************************************************/
+/* The number of letters an exchange reducer has room for to begin with. The  */
+/* room doubles as longer words are reduced.                                  */
+/******************************************************************************/
+#define EXCHANGE_REDUCER_INITIAL_CAPACITY 256
+
+/******************************************************************************/
+/* This structure reduces words using the exchange condition on the minimal   */
+/* roots, with no automaton. Roots are only ever held as minimal root ids so  */
+/* the arithmetic is exact and the Gram matrix isn't needed. Each letter      */
+/* costs O(number of minimal roots) to work out the next bitset, and a        */
+/* cancellation costs that again for each letter after the cancelled one,     */
+/* plus one lookup for each letter walked back. This is chosen over keeping   */
+/* the action of the word on the simple roots, which costs O(rank) for each   */
+/* letter walked back, because that needs real coefficients and these grow    */
+/* without bound in hyperbolic groups.                                        */
+/* action_table - The action of the generators on the minimal roots.          */
+/* letters - The reduced word w built so far. It isn't null terminated.       */
+/* length - The length of w.                                                  */
+/* states - The bitsets of minimal roots for each prefix of w, num_words      */
+/*          words each. The bitset after the first i letters starts at        */
+/*          states[i * num_words]. The word w s is reduced exactly when the   */
+/*          simple root of s isn't in the bitset for the whole of w.          */
+/* capacity - The number of letters there is room for. states has room for    */
+/*            one more bitset than this.                                      */
+/******************************************************************************/
+typedef struct exchange_reducer
+{
+  ROOT_ACTION_TABLE *action_table;
+  char *letters;
+  size_t length;
+  uint64_t *states;
+  size_t capacity;
+} EXCHANGE_REDUCER;
@@ -0,0 +1,814 @@
+#include "cox_prot.h"
+
+/******************************************************************************/
+/* Function: init_external_sort                                               */
+/*                                                                            */
+/* Returns: One of INIT_EXTERNAL_SORT_RET_CODES.                              */
+/*                                                                            */
+/* Parameters: IN     path_prefix - The start of the filename for each run.   */
+/*                                  A copy is taken.                          */
+/*             IN     record_size - The size in bytes of each record.         */
+/*             IN     compare - The function used to order the records.       */
+/*             IN     context - Passed to the compare function.               */
+/*             IN     memory_budget - The size in bytes of the buffer used to */
+/*                                    collect records.                        */
+/*             OUT    sort - Will be returned ready for records to be added.  */
+/*                                                                            */
+/* Operation: Allocate the sort object along with the record buffer and the   */
+/*            space needed to merge the runs.                                 */
+/******************************************************************************/
+int init_external_sort(char *path_prefix,
+                       size_t record_size,
+                       RECORD_COMPARE compare,
+                       void *context,
+                       size_t memory_budget,
+                       EXTERNAL_SORT **sort)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = INIT_EXTERNAL_SORT_OK;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(path_prefix != NULL);
+  assert(record_size > 0);
+  assert(compare != NULL);
+
+  /****************************************************************************/
+  /* Allocate the sort object itself.                                         */
+  /****************************************************************************/
+  (*sort) = (EXTERNAL_SORT *) calloc(1, sizeof(EXTERNAL_SORT));
+  if ((*sort) == NULL)
+  {
+    ret_code = INIT_EXTERNAL_SORT_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  (*sort)->record_size = record_size;
+  (*sort)->compare = compare;
+  (*sort)->context = context;
+
+  /****************************************************************************/
+  /* The buffer always holds at least two records so that progress is made.   */
+  /****************************************************************************/
+  (*sort)->buffer_records = (long) (memory_budget / record_size);
+  if ((*sort)->buffer_records < 2)
+  {
+    (*sort)->buffer_records = 2;
+  }
+
+  (*sort)->path_prefix = (char *) malloc(strlen(path_prefix) + 1);
+  (*sort)->buffer = (char *) malloc(record_size * (*sort)->buffer_records);
+  (*sort)->merge_records = (char *) malloc(record_size *
+                                           EXTERNAL_SORT_MAX_FAN_IN);
+  (*sort)->swap_record = (char *) malloc(record_size);
+  if ((*sort)->path_prefix == NULL ||
+      (*sort)->buffer == NULL ||
+      (*sort)->merge_records == NULL ||
+      (*sort)->swap_record == NULL)
+  {
+    free_external_sort(*sort);
+    (*sort) = NULL;
+    ret_code = INIT_EXTERNAL_SORT_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  strcpy((*sort)->path_prefix, path_prefix);
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: free_external_sort                                               */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     sort - The sort to be freed.                            */
+/*                                                                            */
+/* Operation: Close and delete any runs which still exist (unless they are to */
+/*            be kept) and then free the memory.                              */
+/******************************************************************************/
+void free_external_sort(EXTERNAL_SORT *sort)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  char *filename;
+  long ii;
+
+  for (ii = 0; ii < sort->num_merge_files; ii++)
+  {
+    fclose(sort->merge_files[ii]);
+  }
+  if (sort->path_prefix != NULL && !sort->keep_runs)
+  {
+    for (ii = sort->first_run; ii < sort->next_run; ii++)
+    {
+      if (external_sort_run_filename(sort, ii, &filename) == EXTERNAL_SORT_OK)
+      {
+        remove(filename);
+        free(filename);
+      }
+    }
+  }
+
+  free(sort->path_prefix);
+  free(sort->buffer);
+  free(sort->merge_records);
+  free(sort->swap_record);
+  free(sort);
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: external_sort_run_filename                                       */
+/*                                                                            */
+/* Returns: One of EXTERNAL_SORT_RET_CODES.                                   */
+/*                                                                            */
+/* Parameters: IN     sort - The sort the run belongs to.                     */
+/*             IN     run - The number of the run.                            */
+/*             OUT    filename - Will be returned holding the name of the     */
+/*                               file for the run. Must be freed.             */
+/*                                                                            */
+/* Operation: Append the run number to the path prefix.                       */
+/******************************************************************************/
+int external_sort_run_filename(EXTERNAL_SORT *sort,
+                               long run,
+                               char **filename)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = EXTERNAL_SORT_OK;
+  size_t length = strlen(sort->path_prefix) + 24;
+
+  (*filename) = (char *) malloc(length);
+  if ((*filename) == NULL)
+  {
+    ret_code = EXTERNAL_SORT_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  snprintf(*filename, length, "%s.%ld", sort->path_prefix, run);
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: sort_records                                                     */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN/OUT records - The array of records to be sorted.            */
+/*             IN     num_records - The number of records in the array.       */
+/*             IN     record_size - The size in bytes of each record.         */
+/*             IN     compare - The function used to order the records.       */
+/*             IN     context - Passed to every call of compare.              */
+/*             IN     swap_record - Space for one record to swap through.     */
+/*                                                                            */
+/* Operation: Heapsort the records in place. This needs no memory beyond a    */
+/*            single record to swap through, and the compare function can be  */
+/*            given its context (which qsort doesn't allow).                  */
+/******************************************************************************/
+void sort_records(char *records,
+                  long num_records,
+                  size_t record_size,
+                  RECORD_COMPARE compare,
+                  void *context,
+                  char *swap_record)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  long ii;
+
+  /****************************************************************************/
+  /* Turn the array into a heap with the largest record at the front.         */
+  /****************************************************************************/
+  for (ii = num_records / 2 - 1; ii >= 0; ii--)
+  {
+    sift_down_record(records,
+                     ii,
+                     num_records,
+                     record_size,
+                     compare,
+                     context,
+                     swap_record);
+  }
+
+  /****************************************************************************/
+  /* Repeatedly move the largest record to the end of the unsorted part.      */
+  /****************************************************************************/
+  for (ii = num_records - 1; ii > 0; ii--)
+  {
+    swap_records(records, 0, ii, record_size, swap_record);
+    sift_down_record(records,
+                     0,
+                     ii,
+                     record_size,
+                     compare,
+                     context,
+                     swap_record);
+  }
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: swap_records                                                     */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN/OUT records - The array of records.                         */
+/*             IN     first - The index of the first record to swap.          */
+/*             IN     second - The index of the second record to swap.        */
+/*             IN     record_size - The size in bytes of each record.         */
+/*             IN     swap_record - Space for one record to swap through.     */
+/*                                                                            */
+/* Operation: Swap the two records by copying through the swap space.         */
+/******************************************************************************/
+void swap_records(char *records,
+                  long first,
+                  long second,
+                  size_t record_size,
+                  char *swap_record)
+{
+  memcpy(swap_record, records + first * record_size, record_size);
+  memcpy(records + first * record_size,
+         records + second * record_size,
+         record_size);
+  memcpy(records + second * record_size, swap_record, record_size);
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: sift_down_record                                                 */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN/OUT records - The array of records.                         */
+/*             IN     start - The index of the record to sift down.           */
+/*             IN     end - One past the last record in the heap.             */
+/*             IN     record_size - The size in bytes of each record.         */
+/*             IN     compare - The function used to order the records.       */
+/*             IN     context - Passed to every call of compare.              */
+/*             IN     swap_record - Space for one record to swap through.     */
+/*                                                                            */
+/* Operation: Move the record down the heap until neither of its children is  */
+/*            larger than it.                                                 */
+/******************************************************************************/
+void sift_down_record(char *records,
+                      long start,
+                      long end,
+                      size_t record_size,
+                      RECORD_COMPARE compare,
+                      void *context,
+                      char *swap_record)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  long root = start;
+  long child;
+
+  while ((child = 2 * root + 1) < end)
+  {
+    if (child + 1 < end &&
+        compare(records + child * record_size,
+                records + (child + 1) * record_size,
+                context) < 0)
+    {
+      child++;
+    }
+    if (compare(records + root * record_size,
+                records + child * record_size,
+                context) >= 0)
+    {
+      break;
+    }
+    swap_records(records, root, child, record_size, swap_record);
+    root = child;
+  }
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: write_sorted_run                                                 */
+/*                                                                            */
+/* Returns: One of EXTERNAL_SORT_RET_CODES.                                   */
+/*                                                                            */
+/* Parameters: IN/OUT sort - The sort whose buffer is to be written out.      */
+/*                                                                            */
+/* Operation: Sort the records in the buffer and write them to a new run. The */
+/*            buffer is then empty.                                           */
+/******************************************************************************/
+int write_sorted_run(EXTERNAL_SORT *sort)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = EXTERNAL_SORT_OK;
+  char *filename = NULL;
+  FILE *run_file;
+
+  sort_records(sort->buffer,
+               sort->num_buffered,
+               sort->record_size,
+               sort->compare,
+               sort->context,
+               sort->swap_record);
+
+  ret_code = external_sort_run_filename(sort, sort->next_run, &filename);
+  if (ret_code != EXTERNAL_SORT_OK)
+  {
+    goto EXIT_LABEL;
+  }
+
+  run_file = fopen(filename, "wb");
+  if (run_file == NULL)
+  {
+    printf("Unable to create the sort run %s.\n", filename);
+    ret_code = EXTERNAL_SORT_FILE_ERR;
+    goto EXIT_LABEL;
+  }
+  sort->next_run++;
+
+  if (fwrite(sort->buffer,
+             sort->record_size,
+             sort->num_buffered,
+             run_file) != (size_t) sort->num_buffered)
+  {
+    printf("Unable to write the sort run %s.\n", filename);
+    ret_code = EXTERNAL_SORT_FILE_ERR;
+  }
+  if (fclose(run_file) != 0)
+  {
+    ret_code = EXTERNAL_SORT_FILE_ERR;
+  }
+  sort->num_buffered = 0;
+
+EXIT_LABEL:
+
+  free(filename);
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: external_sort_add                                                */
+/*                                                                            */
+/* Returns: One of EXTERNAL_SORT_RET_CODES.                                   */
+/*                                                                            */
+/* Parameters: IN/OUT sort - The sort to add the record to.                   */
+/*             IN     record - The record to be added. It is copied.          */
+/*                                                                            */
+/* Operation: Copy the record into the buffer, writing the buffer out as a    */
+/*            run first if it is full.                                        */
+/******************************************************************************/
+int external_sort_add(EXTERNAL_SORT *sort, const void *record)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = EXTERNAL_SORT_OK;
+
+  assert(!sort->finished);
+
+  if (sort->num_buffered == sort->buffer_records)
+  {
+    ret_code = write_sorted_run(sort);
+    if (ret_code != EXTERNAL_SORT_OK)
+    {
+      goto EXIT_LABEL;
+    }
+  }
+
+  memcpy(sort->buffer + sort->num_buffered * sort->record_size,
+         record,
+         sort->record_size);
+  sort->num_buffered++;
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: external_sort_flush                                              */
+/*                                                                            */
+/* Returns: One of EXTERNAL_SORT_RET_CODES.                                   */
+/*                                                                            */
+/* Parameters: IN/OUT sort - The sort to flush.                               */
+/*                                                                            */
+/* Operation: Write any buffered records out as a run so that every record    */
+/*            added so far is on disk in runs first_run to next_run - 1.      */
+/******************************************************************************/
+int external_sort_flush(EXTERNAL_SORT *sort)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = EXTERNAL_SORT_OK;
+
+  assert(!sort->finished);
+
+  if (sort->num_buffered > 0)
+  {
+    ret_code = write_sorted_run(sort);
+  }
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: restore_external_sort                                            */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN/OUT sort - A newly initialised sort.                        */
+/*             IN     first_run - The first run to carry on from.             */
+/*             IN     next_run - One past the last run to carry on from.      */
+/*                                                                            */
+/* Operation: Adopt runs left on disk by an earlier sort with the same path   */
+/*            prefix after it was flushed. Any later runs it left behind are  */
+/*            deleted as their records were never recorded as added.          */
+/******************************************************************************/
+void restore_external_sort(EXTERNAL_SORT *sort, long first_run, long next_run)
+{
+  assert(sort->num_buffered == 0);
+  assert(first_run <= next_run);
+
+  sort->first_run = first_run;
+  sort->next_run = next_run;
+  remove_stale_runs(sort, next_run);
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: remove_stale_runs                                                */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     sort - The sort whose path prefix is used.              */
+/*             IN     first_run - The first run to delete.                    */
+/*                                                                            */
+/* Operation: Delete runs with the sort's path prefix, starting at first_run, */
+/*            until one is found not to exist. These are left behind by a     */
+/*            sort which was interrupted.                                     */
+/******************************************************************************/
+void remove_stale_runs(EXTERNAL_SORT *sort, long first_run)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  char *filename;
+  long ii;
+  bool removed = true;
+
+  for (ii = first_run; removed; ii++)
+  {
+    removed = false;
+    if (external_sort_run_filename(sort, ii, &filename) == EXTERNAL_SORT_OK)
+    {
+      removed = (remove(filename) == 0);
+      free(filename);
+    }
+  }
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: merge_heap_sift_down                                             */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN/OUT sort - The sort being merged.                           */
+/*             IN     start - The position in the heap to sift down from.     */
+/*                                                                            */
+/* Operation: The merge heap holds the indices of the open runs ordered so    */
+/*            that the run with the smallest current record is at the top.    */
+/*            Move the entry at start down until the heap is ordered again.   */
+/******************************************************************************/
+void merge_heap_sift_down(EXTERNAL_SORT *sort, int start)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  size_t record_size = sort->record_size;
+  int root = start;
+  int child;
+  int swap;
+
+  while ((child = 2 * root + 1) < sort->merge_heap_size)
+  {
+    if (child + 1 < sort->merge_heap_size &&
+        sort->compare(sort->merge_records +
+                                 sort->merge_heap[child + 1] * record_size,
+                      sort->merge_records +
+                                 sort->merge_heap[child] * record_size,
+                      sort->context) < 0)
+    {
+      child++;
+    }
+    if (sort->compare(sort->merge_records +
+                                 sort->merge_heap[root] * record_size,
+                      sort->merge_records +
+                                 sort->merge_heap[child] * record_size,
+                      sort->context) <= 0)
+    {
+      break;
+    }
+    swap = sort->merge_heap[root];
+    sort->merge_heap[root] = sort->merge_heap[child];
+    sort->merge_heap[child] = swap;
+    root = child;
+  }
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: open_merge                                                       */
+/*                                                                            */
+/* Returns: One of EXTERNAL_SORT_RET_CODES.                                   */
+/*                                                                            */
+/* Parameters: IN/OUT sort - The sort being merged.                           */
+/*             IN     num_runs - The number of runs to merge, starting from   */
+/*                               first_run. At most EXTERNAL_SORT_MAX_FAN_IN. */
+/*                                                                            */
+/* Operation: Open each run, read its first record and build the heap.        */
+/******************************************************************************/
+int open_merge(EXTERNAL_SORT *sort, int num_runs)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = EXTERNAL_SORT_OK;
+  char *filename;
+  int ii;
+
+  assert(num_runs <= EXTERNAL_SORT_MAX_FAN_IN);
+
+  sort->merge_heap_size = 0;
+  for (ii = 0; ii < num_runs; ii++)
+  {
+    ret_code = external_sort_run_filename(sort,
+                                          sort->first_run + ii,
+                                          &filename);
+    if (ret_code != EXTERNAL_SORT_OK)
+    {
+      goto EXIT_LABEL;
+    }
+    sort->merge_files[ii] = fopen(filename, "rb");
+    free(filename);
+    if (sort->merge_files[ii] == NULL)
+    {
+      ret_code = EXTERNAL_SORT_FILE_ERR;
+      goto EXIT_LABEL;
+    }
+    sort->num_merge_files++;
+
+    if (fread(sort->merge_records + ii * sort->record_size,
+              sort->record_size,
+              1,
+              sort->merge_files[ii]) == 1)
+    {
+      sort->merge_heap[sort->merge_heap_size] = ii;
+      sort->merge_heap_size++;
+    }
+  }
+
+  for (ii = sort->merge_heap_size / 2 - 1; ii >= 0; ii--)
+  {
+    merge_heap_sift_down(sort, ii);
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: close_merge                                                      */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN/OUT sort - The sort being merged.                           */
+/*                                                                            */
+/* Operation: Close the runs which were being merged, delete them (unless     */
+/*            they are to be kept) and move first_run past them.              */
+/******************************************************************************/
+void close_merge(EXTERNAL_SORT *sort)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  char *filename;
+  int ii;
+
+  for (ii = 0; ii < sort->num_merge_files; ii++)
+  {
+    fclose(sort->merge_files[ii]);
+    if (!sort->keep_runs &&
+        external_sort_run_filename(sort,
+                                   sort->first_run + ii,
+                                   &filename) == EXTERNAL_SORT_OK)
+    {
+      remove(filename);
+      free(filename);
+    }
+  }
+  sort->first_run += sort->num_merge_files;
+  sort->num_merge_files = 0;
+  sort->merge_heap_size = 0;
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: merge_next                                                       */
+/*                                                                            */
+/* Returns: true if a record was returned and false if the runs being merged  */
+/*          are all exhausted.                                                */
+/*                                                                            */
+/* Parameters: IN/OUT sort - The sort being merged.                           */
+/*             OUT    record - The smallest remaining record.                 */
+/*                                                                            */
+/* Operation: Take the record from the top of the heap and then replace it    */
+/*            with the next record from the same run.                         */
+/******************************************************************************/
+bool merge_next(EXTERNAL_SORT *sort, void *record)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int run;
+
+  if (sort->merge_heap_size == 0)
+  {
+    return(false);
+  }
+
+  run = sort->merge_heap[0];
+  memcpy(record,
+         sort->merge_records + run * sort->record_size,
+         sort->record_size);
+
+  if (fread(sort->merge_records + run * sort->record_size,
+            sort->record_size,
+            1,
+            sort->merge_files[run]) != 1)
+  {
+    sort->merge_heap_size--;
+    sort->merge_heap[0] = sort->merge_heap[sort->merge_heap_size];
+  }
+  merge_heap_sift_down(sort, 0);
+
+  return(true);
+}
+
+/******************************************************************************/
+/* Function: external_sort_finish                                             */
+/*                                                                            */
+/* Returns: One of EXTERNAL_SORT_RET_CODES.                                   */
+/*                                                                            */
+/* Parameters: IN/OUT sort - The sort which all records have been added to.   */
+/*                                                                            */
+/* Operation: If no run has been written then just sort the buffer.           */
+/*            Otherwise write out the last run and free the buffer. While     */
+/*            there are too many runs to merge at once, merge the oldest      */
+/*            EXTERNAL_SORT_MAX_FAN_IN runs into a new one. Finally open the  */
+/*            remaining runs ready for external_sort_next.                    */
+/******************************************************************************/
+int external_sort_finish(EXTERNAL_SORT *sort)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = EXTERNAL_SORT_OK;
+  char *filename;
+  FILE *run_file;
+
+  assert(!sort->finished);
+  sort->finished = true;
+
+  /****************************************************************************/
+  /* If everything fit in memory then there is nothing to merge.              */
+  /****************************************************************************/
+  if (sort->first_run == sort->next_run)
+  {
+    sort_records(sort->buffer,
+                 sort->num_buffered,
+                 sort->record_size,
+                 sort->compare,
+                 sort->context,
+                 sort->swap_record);
+    sort->next_buffered = 0;
+    goto EXIT_LABEL;
+  }
+
+  if (sort->num_buffered > 0)
+  {
+    ret_code = write_sorted_run(sort);
+    if (ret_code != EXTERNAL_SORT_OK)
+    {
+      goto EXIT_LABEL;
+    }
+  }
+  free(sort->buffer);
+  sort->buffer = NULL;
+
+  /****************************************************************************/
+  /* Merge the runs in groups until few enough are left.                      */
+  /****************************************************************************/
+  while (sort->next_run - sort->first_run > EXTERNAL_SORT_MAX_FAN_IN)
+  {
+    ret_code = open_merge(sort, EXTERNAL_SORT_MAX_FAN_IN);
+    if (ret_code != EXTERNAL_SORT_OK)
+    {
+      goto EXIT_LABEL;
+    }
+
+    ret_code = external_sort_run_filename(sort, sort->next_run, &filename);
+    if (ret_code != EXTERNAL_SORT_OK)
+    {
+      goto EXIT_LABEL;
+    }
+    run_file = fopen(filename, "wb");
+    free(filename);
+    if (run_file == NULL)
+    {
+      ret_code = EXTERNAL_SORT_FILE_ERR;
+      goto EXIT_LABEL;
+    }
+    sort->next_run++;
+
+    while (merge_next(sort, sort->swap_record))
+    {
+      if (fwrite(sort->swap_record, sort->record_size, 1, run_file) != 1)
+      {
+        ret_code = EXTERNAL_SORT_FILE_ERR;
+        break;
+      }
+    }
+    if (fclose(run_file) != 0)
+    {
+      ret_code = EXTERNAL_SORT_FILE_ERR;
+    }
+    close_merge(sort);
+    if (ret_code != EXTERNAL_SORT_OK)
+    {
+      goto EXIT_LABEL;
+    }
+  }
+
+  /****************************************************************************/
+  /* Open the final runs so that the records can be read back.                */
+  /****************************************************************************/
+  ret_code = open_merge(sort, (int) (sort->next_run - sort->first_run));
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: external_sort_next                                               */
+/*                                                                            */
+/* Returns: true if a record was returned and false once all of the records   */
+/*          have been read.                                                   */
+/*                                                                            */
+/* Parameters: IN/OUT sort - A sort which has been finished.                  */
+/*             OUT    record - The next record in order.                      */
+/*                                                                            */
+/* Operation: Read from the buffer if it was never written out, otherwise     */
+/*            from the merge of the remaining runs.                           */
+/******************************************************************************/
+bool external_sort_next(EXTERNAL_SORT *sort, void *record)
+{
+  assert(sort->finished);
+
+  if (sort->buffer != NULL)
+  {
+    if (sort->next_buffered == sort->num_buffered)
+    {
+      return(false);
+    }
+    memcpy(record,
+           sort->buffer + sort->next_buffered * sort->record_size,
+           sort->record_size);
+    sort->next_buffered++;
+
+    return(true);
+  }
+
+  return(merge_next(sort, record));
+}
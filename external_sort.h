@@ -0,0 +1,62 @@
+/******************************************************************************/
+/* The most runs which are merged at once. Each open run costs one stdio      */
+/* buffer and one record of memory.                                           */
+/******************************************************************************/
+#define EXTERNAL_SORT_MAX_FAN_IN 16
+
+/******************************************************************************/
+/* Group: INIT_EXTERNAL_SORT_RET_CODES                                        */
+/*                                                                            */
+/* The return codes for function init_external_sort.                          */
+/******************************************************************************/
+#define INIT_EXTERNAL_SORT_OK      0
+#define INIT_EXTERNAL_SORT_MEM_ERR 1
+
+/******************************************************************************/
+/* Group: EXTERNAL_SORT_RET_CODES                                             */
+/*                                                                            */
+/* The return codes for functions external_sort_add and external_sort_finish. */
+/******************************************************************************/
+#define EXTERNAL_SORT_OK       0
+#define EXTERNAL_SORT_MEM_ERR  1
+#define EXTERNAL_SORT_FILE_ERR 2
+
+/******************************************************************************/
+/* The comparison function used to order records. It returns one of the usual */
+/* GREATER (1), EQUAL (0) or SMALLER (-1) values and is passed the context    */
+/* given to init_external_sort.                                               */
+/******************************************************************************/
+typedef int (*RECORD_COMPARE)(const void *, const void *, void *);
+
+/******************************************************************************/
+/* This structure sorts fixed size records using a bounded amount of memory.  */
+/* Records are collected in the buffer, which is sorted and written out as a  */
+/* run each time it fills up. Once all records have been added the runs are   */
+/* merged (in several passes if there are more than EXTERNAL_SORT_MAX_FAN_IN  */
+/* of them) and the records can then be read back in order.                   */
+/* Runs are held in files named <path_prefix>.<run number>. Only the runs     */
+/* numbered first_run to next_run - 1 still exist.                            */
+/* If nothing was ever written out then the records are read straight back    */
+/* from the buffer.                                                           */
+/******************************************************************************/
+typedef struct external_sort
+{
+  char *path_prefix;
+  size_t record_size;
+  RECORD_COMPARE compare;
+  void *context;
+  char *buffer;
+  long buffer_records;
+  long num_buffered;
+  long next_buffered;
+  long first_run;
+  long next_run;
+  int num_merge_files;
+  FILE *merge_files[EXTERNAL_SORT_MAX_FAN_IN];
+  char *merge_records;
+  char *swap_record;
+  int merge_heap[EXTERNAL_SORT_MAX_FAN_IN];
+  int merge_heap_size;
+  bool finished;
+  bool keep_runs;
+} EXTERNAL_SORT;
@@ -0,0 +1,360 @@
+#include "cox_prot.h"
+
+/******************************************************************************/
+/* Function: init_generator_word                                              */
+/*                                                                            */
+/* Returns: One of GENERATOR_WORD_RET_CODES.                                  */
+/*                                                                            */
+/* Parameters: OUT    word - Will be returned holding the empty word.         */
+/*                                                                            */
+/* Operation: Allocate the word with room for GENERATOR_WORD_INITIAL_CAPACITY */
+/*            generators. It grows as longer words are put in it.             */
+/******************************************************************************/
+int init_generator_word(GENERATOR_WORD **word)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = GENERATOR_WORD_OK;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(word != NULL);
+
+  *word = (GENERATOR_WORD *) malloc(sizeof(GENERATOR_WORD));
+  if (*word == NULL)
+  {
+    ret_code = GENERATOR_WORD_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  (*word)->length = 0;
+  (*word)->capacity = GENERATOR_WORD_INITIAL_CAPACITY;
+  (*word)->generators = (uint8_t *) malloc(GENERATOR_WORD_INITIAL_CAPACITY);
+  if ((*word)->generators == NULL)
+  {
+    free(*word);
+    *word = NULL;
+    ret_code = GENERATOR_WORD_MEM_ERR;
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: free_generator_word                                              */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     word - The word to be freed.                            */
+/*                                                                            */
+/* Operation: Free the generators and then the word itself.                   */
+/******************************************************************************/
+void free_generator_word(GENERATOR_WORD *word)
+{
+  assert(word != NULL);
+
+  free(word->generators);
+  free(word);
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: reserve_generator_word                                           */
+/*                                                                            */
+/* Returns: One of GENERATOR_WORD_RET_CODES.                                  */
+/*                                                                            */
+/* Parameters: IN/OUT word - The word.                                        */
+/*             IN     length - The number of generators it must have room     */
+/*                             for.                                           */
+/*                                                                            */
+/* Operation: Grow the word to at least the given length, at least doubling   */
+/*            it so that a word built up a generator at a time is copied only */
+/*            a few times. The generators already in it are kept.             */
+/******************************************************************************/
+int reserve_generator_word(GENERATOR_WORD *word, int length)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = GENERATOR_WORD_OK;
+  uint8_t *generators;
+  int capacity;
+
+  if (length <= word->capacity)
+  {
+    goto EXIT_LABEL;
+  }
+  capacity = (word->capacity > INT32_MAX / 2) ?
+                                           INT32_MAX : word->capacity * 2;
+  if (capacity < length)
+  {
+    capacity = length;
+  }
+  generators = (uint8_t *) realloc(word->generators, capacity);
+  if (generators == NULL)
+  {
+    ret_code = GENERATOR_WORD_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  word->generators = generators;
+  word->capacity = capacity;
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: encode_generator_word                                            */
+/*                                                                            */
+/* Returns: One of GENERATOR_WORD_RET_CODES. GENERATOR_WORD_BAD_LETTER is     */
+/*          returned if a letter isn't one of the generators.                 */
+/*                                                                            */
+/* Parameters: IN     text - The letters of the word.                         */
+/*             IN     length - The number of letters.                         */
+/*             IN     num_generators - The number of group generators.        */
+/*             OUT    word - Will be returned holding the word.               */
+/*                                                                            */
+/* Operation: Turn each letter into the index of its generator. This is the   */
+/*            only place a text word is decoded, so the reducer and the scans */
+/*            never have to look at a letter.                                 */
+/******************************************************************************/
+int encode_generator_word(const char *text,
+                          int length,
+                          int num_generators,
+                          GENERATOR_WORD *word)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = GENERATOR_WORD_OK;
+  int generator;
+  int ii;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(text != NULL || length == 0);
+  assert(word != NULL);
+
+  ret_code = reserve_generator_word(word, length);
+  if (ret_code != GENERATOR_WORD_OK)
+  {
+    goto EXIT_LABEL;
+  }
+  for (ii = 0; ii < length; ii++)
+  {
+    generator = (int) text[ii] - ASCII_LOWER_A;
+    if (generator < 0 || generator >= num_generators)
+    {
+      ret_code = GENERATOR_WORD_BAD_LETTER;
+      goto EXIT_LABEL;
+    }
+    word->generators[ii] = (uint8_t) generator;
+  }
+  word->length = length;
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: decode_generator_word                                            */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     word - The word.                                        */
+/*             OUT    text - Will be returned holding the letters of the word */
+/*                           followed by a null. It must have room for        */
+/*                           length + 1 characters.                           */
+/*                                                                            */
+/* Operation: Turn each generator back into its letter.                       */
+/******************************************************************************/
+void decode_generator_word(GENERATOR_WORD *word, char *text)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ii;
+
+  for (ii = 0; ii < word->length; ii++)
+  {
+    text[ii] = (char) (ASCII_LOWER_A + word->generators[ii]);
+  }
+  text[word->length] = '\0';
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: write_word_file_header                                           */
+/*                                                                            */
+/* Returns: One of WORD_FILE_RET_CODES.                                       */
+/*                                                                            */
+/* Parameters: IN     word_file - The stream to write to.                     */
+/*             IN     num_generators - The number of group generators.        */
+/*                                                                            */
+/* Operation: Write the header which must come before the first word.         */
+/******************************************************************************/
+int write_word_file_header(FILE *word_file, int num_generators)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = WORD_FILE_OK;
+  WORD_FILE_HEADER header;
+
+  memset(&header, 0, sizeof(header));
+  strncpy(header.magic, WORD_FILE_MAGIC, sizeof(header.magic));
+  header.endian_tag = WORD_FILE_ENDIAN_TAG;
+  header.version = WORD_FILE_VERSION;
+  header.num_generators = num_generators;
+  if (fwrite(&header, sizeof(header), 1, word_file) != 1)
+  {
+    ret_code = WORD_FILE_FILE_ERR;
+  }
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: read_word_file_header                                            */
+/*                                                                            */
+/* Returns: One of WORD_FILE_RET_CODES.                                       */
+/*                                                                            */
+/* Parameters: IN     word_file - The stream to read from.                    */
+/*             IN     num_generators - The number of group generators.        */
+/*                                                                            */
+/* Operation: Read the header and check that it was written by a machine of   */
+/*            the same byte order, in this version of the layout and for a    */
+/*            group with the same number of generators.                       */
+/******************************************************************************/
+int read_word_file_header(FILE *word_file, int num_generators)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = WORD_FILE_OK;
+  WORD_FILE_HEADER header;
+
+  if (fread(&header, sizeof(header), 1, word_file) != 1)
+  {
+    ret_code = ferror(word_file) ? WORD_FILE_FILE_ERR : WORD_FILE_BAD_FORMAT;
+    goto EXIT_LABEL;
+  }
+  if (memcmp(header.magic, WORD_FILE_MAGIC, sizeof(header.magic)) != 0)
+  {
+    ret_code = WORD_FILE_BAD_FORMAT;
+    goto EXIT_LABEL;
+  }
+  if (header.endian_tag != WORD_FILE_ENDIAN_TAG)
+  {
+    ret_code = WORD_FILE_WRONG_ENDIAN;
+    goto EXIT_LABEL;
+  }
+  if (header.version != WORD_FILE_VERSION)
+  {
+    ret_code = WORD_FILE_WRONG_VERSION;
+    goto EXIT_LABEL;
+  }
+  if (header.num_generators != num_generators)
+  {
+    ret_code = WORD_FILE_WRONG_GROUP;
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: write_generator_word                                             */
+/*                                                                            */
+/* Returns: One of WORD_FILE_RET_CODES.                                       */
+/*                                                                            */
+/* Parameters: IN     word_file - The stream to write to.                     */
+/*             IN     word - The word to write.                               */
+/*                                                                            */
+/* Operation: Write the length of the word and then its generators.           */
+/******************************************************************************/
+int write_generator_word(FILE *word_file, GENERATOR_WORD *word)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = WORD_FILE_OK;
+  uint32_t length = (uint32_t) word->length;
+
+  if (fwrite(&length, sizeof(length), 1, word_file) != 1 ||
+      fwrite(word->generators, 1, length, word_file) != length)
+  {
+    ret_code = WORD_FILE_FILE_ERR;
+  }
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: read_generator_word                                              */
+/*                                                                            */
+/* Returns: One of WORD_FILE_RET_CODES. WORD_FILE_END is returned once there  */
+/*          are no more words, and WORD_FILE_BAD_FORMAT if the file ends part */
+/*          way through a word or a generator is out of range.                */
+/*                                                                            */
+/* Parameters: IN     word_file - The stream to read from.                    */
+/*             IN     num_generators - The number of group generators.        */
+/*             OUT    word - Will be returned holding the word read.          */
+/*                                                                            */
+/* Operation: Read the length of the word and then that many generators       */
+/*            straight into the word.                                         */
+/******************************************************************************/
+int read_generator_word(FILE *word_file,
+                        int num_generators,
+                        GENERATOR_WORD *word)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = WORD_FILE_OK;
+  uint32_t length;
+  int ii;
+
+  if (fread(&length, sizeof(length), 1, word_file) != 1)
+  {
+    ret_code = ferror(word_file) ? WORD_FILE_FILE_ERR : WORD_FILE_END;
+    goto EXIT_LABEL;
+  }
+  if (length > (uint32_t) INT32_MAX)
+  {
+    ret_code = WORD_FILE_BAD_FORMAT;
+    goto EXIT_LABEL;
+  }
+  if (reserve_generator_word(word, (int) length) != GENERATOR_WORD_OK)
+  {
+    ret_code = WORD_FILE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  if (fread(word->generators, 1, length, word_file) != length)
+  {
+    ret_code = ferror(word_file) ? WORD_FILE_FILE_ERR : WORD_FILE_BAD_FORMAT;
+    goto EXIT_LABEL;
+  }
+  for (ii = 0; ii < (int) length; ii++)
+  {
+    if (word->generators[ii] >= num_generators)
+    {
+      ret_code = WORD_FILE_BAD_FORMAT;
+      goto EXIT_LABEL;
+    }
+  }
+  word->length = (int) length;
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
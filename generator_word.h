@@ -0,0 +1,73 @@
+/******************************************************************************/
+/* The first eight bytes of every binary word file.                           */
+/******************************************************************************/
+#define WORD_FILE_MAGIC "COXWORD"
+
+/******************************************************************************/
+/* Written in the byte order of the machine which wrote the file, as for      */
+/* AUTOMATON_FILE_ENDIAN_TAG.                                                 */
+/******************************************************************************/
+#define WORD_FILE_ENDIAN_TAG 0x01020304
+
+/******************************************************************************/
+/* The version of the binary word file layout.                                */
+/******************************************************************************/
+#define WORD_FILE_VERSION 1
+
+/******************************************************************************/
+/* The number of generators a word holds room for to begin with.              */
+/******************************************************************************/
+#define GENERATOR_WORD_INITIAL_CAPACITY 256
+
+/******************************************************************************/
+/* Group: GENERATOR_WORD_RET_CODES                                            */
+/*                                                                            */
+/* The return codes for functions init_generator_word, reserve_generator_word */
+/* and encode_generator_word.                                                 */
+/******************************************************************************/
+#define GENERATOR_WORD_OK         0
+#define GENERATOR_WORD_MEM_ERR    1
+#define GENERATOR_WORD_BAD_LETTER 2
+
+/******************************************************************************/
+/* Group: WORD_FILE_RET_CODES                                                 */
+/*                                                                            */
+/* The return codes for functions write_word_file_header,                     */
+/* read_word_file_header, write_generator_word and read_generator_word.       */
+/* WORD_FILE_END means the file ended cleanly before another word.            */
+/******************************************************************************/
+#define WORD_FILE_OK            0
+#define WORD_FILE_MEM_ERR       1
+#define WORD_FILE_FILE_ERR      2
+#define WORD_FILE_BAD_FORMAT    3
+#define WORD_FILE_WRONG_ENDIAN  4
+#define WORD_FILE_WRONG_VERSION 5
+#define WORD_FILE_WRONG_GROUP   6
+#define WORD_FILE_END           7
+
+/******************************************************************************/
+/* This structure is a word held as the indices of its generators rather than */
+/* as letters, so nothing has to be decoded as it is read.                    */
+/* generators - generators[i] is the index of the i-th generator of the word. */
+/* length - The number of generators in the word.                             */
+/* capacity - The number of generators there is room for.                     */
+/******************************************************************************/
+typedef struct generator_word
+{
+  uint8_t *generators;
+  int length;
+  int capacity;
+} GENERATOR_WORD;
+
+/******************************************************************************/
+/* This structure is the header at the start of a binary word file. It is     */
+/* followed by the words, each as its length in a uint32_t and then that many */
+/* generator indices of one byte each.                                        */
+/******************************************************************************/
+typedef struct word_file_header
+{
+  char magic[8];
+  uint32_t endian_tag;
+  uint32_t version;
+  int32_t num_generators;
+} WORD_FILE_HEADER;
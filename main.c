@@ -221,13 +221,20 @@ void free_matrix_data(MATRIX_DATA *matrix_data, int num_generators)
   
   /****************************************************************************/
   /* Free the 2d matrices for the simple coxeter actions, the scalar products */
-  /* products and the coxeter matrix.                                         */
+  /* products and the coxeter matrix. The first two are only filled in when   */
+  /* the root tables are generated, which isn't done for a cached automaton.  */
   /****************************************************************************/
   for (ii = 0; ii < num_generators; ii++)
   {
     free(matrix_data->coxeter_matrix[ii]);
-    free(matrix_data->scalar_products[ii]);
-    free(matrix_data->simple_action_results[ii]);
+    if (matrix_data->scalar_products != NULL)
+    {
+      free(matrix_data->scalar_products[ii]);
+    }
+    if (matrix_data->simple_action_results != NULL)
+    {
+      free(matrix_data->simple_action_results[ii]);
+    }
   }
   free(matrix_data->coxeter_matrix);
   free(matrix_data->scalar_products);
@@ -241,12 +248,92 @@ void free_matrix_data(MATRIX_DATA *matrix_data, int num_generators)
   return;
 }
 
-int main (void)
+/******************************************************************************/
+/* Function: check_word                                                       */
+/*                                                                            */
+/* Returns: true if the word is reduced and false otherwise.                  */
+/*                                                                            */
+/* Parameters: IN     automaton_table - The compiled automaton. NULL if the   */
+/*                                      automaton is being built lazily.      */
+/*             IN     sink_table - The compiled automaton with a sink state.  */
+/*                                 NULL if it wasn't asked for.               */
+/*             IN     compressed_table - The compressed form of the compiled  */
+/*                                       automaton. NULL if it wasn't asked   */
+/*                                       for, in which case automaton_table   */
+/*                                       is used.                             */
+/*             IN     component_automaton - The automata for each component   */
+/*                                          of a reducible group. Only used   */
+/*                                          if there is no other single       */
+/*                                          automaton.                        */
+/*             IN/OUT lazy_automaton - The lazy automaton. Only used if there */
+/*                                     is no compiled automaton.              */
+/*             IN     word - The word to be checked.                          */
+/*             OUT    fail_index - The index at which the word was found not  */
+/*                                 to be reduced.                             */
+/*             IN     start_index - The first letter to be read.              */
+/*             IN     finish_index - One past the last letter to be read.     */
+/*                                                                            */
+/* Operation: Pass the word to whichever automaton is being used. A word read */
+/*            from right to left goes to the same automaton, as a word is     */
+/*            reduced exactly when the word with its letters reversed is.     */
+/******************************************************************************/
+bool check_word(AUTOMATON_TABLE *automaton_table,
+                SINK_AUTOMATON *sink_table,
+                COMPRESSED_AUTOMATON *compressed_table,
+                COMPONENT_AUTOMATON *component_automaton,
+                LAZY_AUTOMATON *lazy_automaton,
+                char *word,
+                int *fail_index,
+                int start_index,
+                int finish_index)
+{
+  if (automaton_table != NULL)
+  {
+    return(is_reduced_table(automaton_table, 
+                            word, 
+                            fail_index, 
+                            start_index, 
+                            finish_index));
+  }
+  if (sink_table != NULL)
+  {
+    return(is_reduced_sink(sink_table, 
+                           word, 
+                           fail_index, 
+                           start_index, 
+                           finish_index));
+  }
+  if (compressed_table != NULL)
+  {
+    return(is_reduced_compressed(compressed_table, 
+                                 word, 
+                                 fail_index, 
+                                 start_index, 
+                                 finish_index));
+  }
+  if (component_automaton != NULL)
+  {
+    return(is_reduced_components(component_automaton, 
+                                 word, 
+                                 fail_index, 
+                                 start_index, 
+                                 finish_index));
+  }
+  
+  return(is_reduced_lazy(lazy_automaton, 
+                         word, 
+                         fail_index, 
+                         start_index, 
+                         finish_index));
+}
+
+int main (int argc, char **argv)
 {
   int ret_code;
   int ret_val;
   int left_fail_index;
   int right_fail_index;
+  int ii;
   char *word;
   char *temp_word;
   char *reduced_word;
@@ -258,20 +345,85 @@ int main (void)
   MATRIX_FILE_INFO *file_info;
   ROOT_TABLE *root_table = NULL;
   ROOT_TABLE *minimal_root_table = NULL;
-  AUTOMATON_STATE *state_tree;
+  AUTOMATON_STATE *state_tree = NULL;
   BINARY_TREE_ELEMENT *binary_state_tree = NULL;
+  AUTOMATON_TABLE *automaton_table = NULL;
+  AUTOMATON_TABLE *minimal_table;
+  AUTOMATON_TABLE *shortlex_table = NULL;
+  AUTOMATON_TABLE *coset_table = NULL;
+  AUTOMATON_TABLE *coset_count_table = NULL;
+  COMPONENT_AUTOMATON *component_automaton = NULL;
+  COMPRESSED_AUTOMATON *compressed_table = NULL;
+  SINK_AUTOMATON *sink_table = NULL;
+  WORD_REDUCER *word_reducer = NULL;
+  EXCHANGE_REDUCER *exchange_reducer = NULL;
+  WORD_CORPUS *word_corpus = NULL;
+  FILE *batch_input = NULL;
+  FILE *batch_output = NULL;
+  FILE *results_output = stdout;
+  long bad_line;
+  STREAM_REDUCER *stream_reducer = NULL;
+  GENERATOR_WORD *power_word = NULL;
+  long bad_offset;
+  MAPPED_AUTOMATON *mapped_automaton = NULL;
+  bool found_in_cache = false;
+  char **sample_words = NULL;
+  long num_sample_words = 0;
+  int component_of[MAX_GENERATORS];
+  uint64_t element_counts[SHORTLEX_COUNT_LENGTH + 1];
+  LAZY_AUTOMATON *lazy_automaton = NULL;
+  ROOT_ACTION_TABLE *action_table;
+  char *table_filename;
+  long num_states;
+  PROGRAM_OPTIONS options;
+  int exit_code = 0;
+  
+  /****************************************************************************/
+  /* Read the options the program was started with.                           */
+  /****************************************************************************/
+  ret_code = parse_command_line(argc, argv, &options);
+  if (ret_code != PARSE_COMMAND_LINE_OK)
+  {
+    print_usage(argv[0]);
+    return(1);
+  }
+  
+  /****************************************************************************/
+  /* When the reduced words of a batch or stream go to stdout keep stdout for */
+  /* them alone. They are written to a copy of it and everything else the     */
+  /* program prints, from the prompts to the root tables, goes to stderr.     */
+  /****************************************************************************/
+  if ((options.batch_filename != NULL || options.stream_filename != NULL) && 
+      options.batch_output_filename == NULL)
+  {
+    fflush(stdout);
+    results_output = fdopen(dup(STDOUT_FILENO), "w");
+    if (results_output == NULL || dup2(STDERR_FILENO, STDOUT_FILENO) < 0)
+    {
+      fprintf(stderr, "The results could not be kept apart on stdout.\n");
+      return(1);
+    }
+    setvbuf(stdout, NULL, _IOLBF, 0);
+  }
   
   do
   {
     /**************************************************************************/
-    /* Get a filename for the matrix from the user.                           */
-    /* If the filename is bad then keep asking for a new one.                 */
+    /* Get a filename for the matrix from the command line or from the user.  */
+    /* If the filename from the user is bad then keep asking for a new one.   */
     /**************************************************************************/
-    do
+    if (options.matrix_filename != NULL)
     {
-      ret_code = user_input_file(&filename);
-      printf("\n");
-    } while (ret_code != FILE_INPUT_OK);
+      filename = options.matrix_filename;
+    }
+    else
+    {
+      do
+      {
+        ret_code = user_input_file(&filename);
+        printf("\n");
+      } while (ret_code != FILE_INPUT_OK);
+    }
   
     /**************************************************************************/
     /* Load the matrix data from the file. This fills in the file info object */
@@ -286,6 +438,14 @@ int main (void)
                                     &input_matrix, 
                                     &file_info);
     
+    /**************************************************************************/
+    /* A matrix named on the command line is only tried once.                 */
+    /**************************************************************************/
+    if (options.matrix_filename != NULL && ret_val != FILE_INPUT_ERR_NONE)
+    {
+      return(1);
+    }
+    
     /**************************************************************************/
     /* Check that the matrix inputted is symmetric. All coxeter matrices are. */
     /**************************************************************************/
@@ -293,6 +453,10 @@ int main (void)
     if (!matrix_is_symmetric)
     {
       printf("The matrix inputted is not symmetric.\n");
+      if (options.matrix_filename != NULL)
+      {
+        return(1);
+      }
     }
     
   } while (ret_val != FILE_INPUT_ERR_NONE || !matrix_is_symmetric);
@@ -300,7 +464,10 @@ int main (void)
   /****************************************************************************/
   /* The filename is no longer needed so free the allocated memory.           */
   /****************************************************************************/
-  free(filename);
+  if (options.matrix_filename == NULL)
+  {
+    free(filename);
+  }
   
   /****************************************************************************/
   /* Set up the object which will hold the precalculated matrix data.         */
@@ -313,42 +480,703 @@ int main (void)
   /****************************************************************************/
   matrix_data->coxeter_matrix = input_matrix;
   
+  /****************************************************************************/
+  /* Look the group up in the cache first. The cache only needs the Coxeter   */
+  /* matrix, so a group which has been built before, perhaps with its         */
+  /* generators labelled differently, is loaded without building anything.    */
+  /****************************************************************************/
+  if (options.cache_directory != NULL &&
+      load_cached_automaton(options.cache_directory, 
+                            matrix_data, 
+                            file_info->width, 
+                            &automaton_table) == CACHED_AUTOMATON_OK)
+  {
+    found_in_cache = true;
+  }
+  
   /****************************************************************************/
   /* Create the minimal (and standard) root table for use in the automaton.   */
+  /* When the automaton came from the cache or is mapped from a file they are */
+  /* only needed for the other automata and for saving the automaton.         */
+  /****************************************************************************/
+  if ((!found_in_cache && options.load_filename == NULL) || 
+      options.shortlex_automaton || 
+      options.coset_generators != NULL || 
+      options.save_filename != NULL)
+  {
+    ret_code = generate_root_table(matrix_data, 
+                                   &root_table, 
+                                   &minimal_root_table, 
+                                   file_info->width);
+    assert(ret_code == GENERATE_ROOT_TABLE_OK);
+    
+    /**************************************************************************/
+    /* Print out the root table for the group.                                */
+    /**************************************************************************/
+    printf("The minimal root table for the group inputted is:\n");
+    output_root_table(stdout, minimal_root_table, file_info->width);
+    printf("\n");
+    printf("The root table for the group inputted is:\n");
+    output_root_table(stdout, root_table, file_info->width);
+    printf("\n");
+  }
+  
+  if (options.lazy_automaton)
+  {
+    /**************************************************************************/
+    /* Only create the start state. The rest of the automaton is filled in as */
+    /* words are checked.                                                     */
+    /**************************************************************************/
+    ret_code = init_lazy_automaton(matrix_data, 
+                                   file_info->width, 
+                                   &lazy_automaton);
+    assert(ret_code == INIT_LAZY_AUTOMATON_OK);
+  }
+  else if (options.exchange_condition)
+  {
+    /**************************************************************************/
+    /* Words are reduced using the action on the minimal roots so no          */
+    /* automaton is built at all.                                             */
+    /**************************************************************************/
+    ret_code = init_exchange_reducer(matrix_data, 
+                                     minimal_root_table, 
+                                     file_info->width, 
+                                     &exchange_reducer);
+    if (ret_code != EXCHANGE_REDUCER_OK)
+    {
+      printf("The exchange condition reducer could not be created.\n");
+      goto EXIT_LABEL;
+    }
+    printf("Words will be reduced using the exchange condition.\n");
+  }
+  else if (options.load_filename != NULL)
+  {
+    /**************************************************************************/
+    /* Map an automaton saved by an earlier run. The table is used straight   */
+    /* from the mapping and is shared with any other process mapping it.      */
+    /**************************************************************************/
+    ret_code = map_automaton_file(options.load_filename, &mapped_automaton);
+    if (ret_code != MAP_AUTOMATON_FILE_OK)
+    {
+      printf("The automaton could not be mapped from %s.\n", 
+             options.load_filename);
+      goto EXIT_LABEL;
+    }
+    if (!automaton_file_matches_group(mapped_automaton, 
+                                      matrix_data, 
+                                      file_info->width))
+    {
+      printf("The automaton in %s is for a different group.\n", 
+             options.load_filename);
+      goto EXIT_LABEL;
+    }
+    if (options.verify_load_file && 
+        !automaton_file_transitions_valid(mapped_automaton))
+    {
+      printf("The automaton in %s has a transition to a state it doesn't "
+             "have.\n", 
+             options.load_filename);
+      goto EXIT_LABEL;
+    }
+    automaton_table = &(mapped_automaton->table);
+    printf("The automaton has %ld states.\n", automaton_table->num_states);
+  }
+  else if (found_in_cache)
+  {
+    /**************************************************************************/
+    /* The group has been built before, perhaps with its generators labelled  */
+    /* differently, so use the automaton from the cache.                      */
+    /**************************************************************************/
+    printf("The automaton was found in the cache and has %ld states.\n", 
+           automaton_table->num_states);
+  }
+  else if (options.out_of_core_directory != NULL)
+  {
+    /**************************************************************************/
+    /* Build the automaton on disk with states held as bitsets of roots and   */
+    /* then load the finished table.                                          */
+    /**************************************************************************/
+    ret_code = init_root_action_table(matrix_data,
+                                      minimal_root_table,
+                                      file_info->width,
+                                      &action_table);
+    assert(ret_code == INIT_ROOT_ACTION_TABLE_OK);
+    ret_code = build_automaton_out_of_core(action_table,
+                                           options.out_of_core_directory,
+                                           (size_t) options.memory_budget_mb *
+                                                                   1024 * 1024,
+                                           options.checkpoint_interval,
+                                           options.resume_build,
+                                           &num_states);
+    free_root_action_table(action_table);
+    if (ret_code != BUILD_AUTOMATON_OUT_OF_CORE_OK)
+    {
+      printf("The automaton could not be built in %s.\n",
+             options.out_of_core_directory);
+      goto EXIT_LABEL;
+    }
+    
+    ret_code = out_of_core_path(options.out_of_core_directory,
+                                OUT_OF_CORE_TABLE_FILENAME,
+                                &table_filename);
+    assert(ret_code == BUILD_AUTOMATON_OUT_OF_CORE_OK);
+    ret_code = load_automaton_table_file(table_filename, &automaton_table);
+    free(table_filename);
+    if (ret_code != LOAD_AUTOMATON_TABLE_FILE_OK)
+    {
+      printf("The automaton table could not be read.\n");
+      goto EXIT_LABEL;
+    }
+    printf("The automaton has %ld states.\n", automaton_table->num_states);
+  }
+  else if (options.num_workers > 0)
+  {
+    /**************************************************************************/
+    /* Build the automaton with the states split across worker processes.     */
+    /**************************************************************************/
+    ret_code = init_root_action_table(matrix_data,
+                                      minimal_root_table,
+                                      file_info->width,
+                                      &action_table);
+    assert(ret_code == INIT_ROOT_ACTION_TABLE_OK);
+    ret_code = build_automaton_sharded(action_table,
+                                       options.num_workers,
+                                       &automaton_table);
+    free_root_action_table(action_table);
+    if (ret_code != BUILD_AUTOMATON_SHARDED_OK)
+    {
+      printf("The automaton could not be built with %d workers.\n",
+             options.num_workers);
+      goto EXIT_LABEL;
+    }
+    printf("The automaton has %ld states.\n", automaton_table->num_states);
+  }
+  else if (options.split_components && 
+           find_coxeter_components(matrix_data, 
+                                   file_info->width, 
+                                   component_of) > 1)
+  {
+    /**************************************************************************/
+    /* The group is reducible and the user asked for it to be split, so build */
+    /* one automaton for each component of the Coxeter graph and run them     */
+    /* side by side rather than building their product.                       */
+    /**************************************************************************/
+    ret_code = init_component_automaton(matrix_data,
+                                        minimal_root_table,
+                                        file_info->width,
+                                        &component_automaton);
+    if (ret_code != INIT_COMPONENT_AUTOMATON_OK)
+    {
+      printf("The component automata could not be built.\n");
+      goto EXIT_LABEL;
+    }
+    printf("The Coxeter graph has %d components.\n", 
+           component_automaton->num_components);
+    for (ii = 0; ii < component_automaton->num_components; ii++)
+    {
+      printf("The automaton for component %d has %ld states.\n", 
+             ii, 
+             component_automaton->tables[ii]->num_states);
+    }
+    printf("The component automata have %ld states in total.\n", 
+           component_automaton->num_states);
+  }
+  else
+  {
+    /**************************************************************************/
+    /* Create the state tree for the minimal root table that was generated.   */
+    /**************************************************************************/
+    ret_code = generate_state_tree(matrix_data, 
+                                   file_info->width, 
+                                   minimal_root_table, 
+                                   &state_tree,
+                                   &binary_state_tree);
+    assert(ret_code == GENERATE_STATE_TREE_OK);
+  
+    /**************************************************************************/
+    /* Compile the state tree into a flat table which is what is used to      */
+    /* check words.                                                           */
+    /**************************************************************************/
+    ret_code = compile_state_tree(state_tree, 
+                                  file_info->width, 
+                                  &automaton_table);
+    assert(ret_code == COMPILE_STATE_TREE_OK);
+    printf("The automaton has %ld states.\n", automaton_table->num_states);
+  }
+  
+  /****************************************************************************/
+  /* Add a newly built automaton to the cache so that later runs on the same  */
+  /* group, in any labelling, don't have to build it.                         */
+  /****************************************************************************/
+  if (options.cache_directory != NULL && 
+      automaton_table != NULL && 
+      !found_in_cache)
+  {
+    ret_code = store_cached_automaton(options.cache_directory, 
+                                      matrix_data, 
+                                      file_info->width, 
+                                      automaton_table);
+    if (ret_code != CACHED_AUTOMATON_OK)
+    {
+      printf("The automaton could not be added to the cache in %s.\n", 
+             options.cache_directory);
+      goto EXIT_LABEL;
+    }
+    printf("The automaton has been added to the cache in %s.\n", 
+           options.cache_directory);
+  }
+  
+  /****************************************************************************/
+  /* If asked to then replace the compiled automaton with the minimal one.    */
+  /****************************************************************************/
+  if (options.minimise_automaton && component_automaton != NULL)
+  {
+    ret_code = minimise_component_automaton(component_automaton);
+    assert(ret_code == MINIMISE_AUTOMATON_TABLE_OK);
+    printf("The minimised component automata have %ld states in total.\n", 
+           component_automaton->num_states);
+  }
+  else if (options.minimise_automaton)
+  {
+    ret_code = minimise_automaton_table(automaton_table, &minimal_table, NULL);
+    assert(ret_code == MINIMISE_AUTOMATON_TABLE_OK);
+    free_automaton_table(automaton_table);
+    automaton_table = minimal_table;
+    printf("The minimised automaton has %ld states.\n", 
+           automaton_table->num_states);
+  }
+  
+  /****************************************************************************/
+  /* If asked to then renumber the states of the automaton so that the states */
+  /* used most (or reached from each other) sit close together in memory.     */
+  /****************************************************************************/
+  if (options.renumber_mode != RENUMBER_NONE)
+  {
+    if (options.renumber_mode == RENUMBER_FREQUENCY)
+    {
+      ret_code = load_sample_words(options.sample_filename, 
+                                   file_info->width, 
+                                   &sample_words, 
+                                   &num_sample_words);
+      if (ret_code != LOAD_SAMPLE_WORDS_OK)
+      {
+        printf("The sample words could not be read from %s.\n", 
+               options.sample_filename);
+        goto EXIT_LABEL;
+      }
+    }
+    ret_code = reorder_automaton_table(automaton_table, 
+                                       options.renumber_mode, 
+                                       sample_words, 
+                                       num_sample_words, 
+                                       SEARCH_FORWARDS);
+    if (ret_code != RENUMBER_AUTOMATON_TABLE_OK)
+    {
+      printf("The automaton could not be renumbered.\n");
+      goto EXIT_LABEL;
+    }
+    printf("The automaton states have been renumbered.\n");
+  }
+  
+  /****************************************************************************/
+  /* If asked to then save the automaton so that later runs can map it rather */
+  /* than building it.                                                        */
   /****************************************************************************/
-  ret_code = generate_root_table(matrix_data, 
-                                 &root_table, 
-                                 &minimal_root_table, 
-                                 file_info->width);
-  assert(ret_code == GENERATE_ROOT_TABLE_OK);
+  if (options.save_filename != NULL)
+  {
+    ret_code = save_automaton_file(options.save_filename, 
+                                   automaton_table, 
+                                   matrix_data, 
+                                   minimal_root_table);
+    if (ret_code != SAVE_AUTOMATON_FILE_OK)
+    {
+      printf("The automaton could not be saved to %s.\n", 
+             options.save_filename);
+      goto EXIT_LABEL;
+    }
+    printf("The automaton has been saved to %s.\n", options.save_filename);
+  }
   
   /****************************************************************************/
-  /* Print out the root table for the group.                                  */
+  /* If asked to then write the automaton out as C source which can be built  */
+  /* into another program.                                                    */
   /****************************************************************************/
-  printf("The minimal root table for the group inputted is:\n");
-  output_root_table(stdout, minimal_root_table, file_info->width);
-  printf("\n");
-  printf("The root table for the group inputted is:\n");
-  output_root_table(stdout, root_table, file_info->width);
-  printf("\n");
+  if (options.source_prefix != NULL)
+  {
+    ret_code = write_automaton_source(options.source_prefix, 
+                                      automaton_table);
+    if (ret_code != WRITE_AUTOMATON_SOURCE_OK)
+    {
+      printf("The automaton could not be written to %s.c.\n", 
+             options.source_prefix);
+      goto EXIT_LABEL;
+    }
+    printf("The automaton has been written to %s.c.\n", 
+           options.source_prefix);
+  }
   
   /****************************************************************************/
-  /* Create the state tree for the minimal root table that was generated.     */
+  /* If asked to then replace the flat table with its compressed form.        */
   /****************************************************************************/
-  ret_code = generate_state_tree(matrix_data, 
-                                 file_info->width, 
-                                 minimal_root_table, 
-                                 &state_tree,
-                                 &binary_state_tree);
-  assert(ret_code == GENERATE_STATE_TREE_OK);
+  if (options.compress_automaton)
+  {
+    ret_code = compress_automaton_table(automaton_table, &compressed_table);
+    if (ret_code != COMPRESS_AUTOMATON_TABLE_OK)
+    {
+      printf("The automaton could not be compressed.\n");
+      goto EXIT_LABEL;
+    }
+    printf("The compressed automaton has %ld states with %d byte ids and "
+           "takes %lu bytes rather than %lu.\n",
+           compressed_table->num_states,
+           compressed_table->id_width,
+           (unsigned long) compressed_automaton_size(compressed_table),
+           (unsigned long) (automaton_table->num_states * 
+                            automaton_table->num_generators * 
+                            sizeof(int32_t)));
+    if (mapped_automaton == NULL)
+    {
+      free_automaton_table(automaton_table);
+    }
+    automaton_table = NULL;
+  }
   
   /****************************************************************************/
-  /* Ask the user to enter a word and then check whether it is reduced.       */
+  /* If asked to then replace the flat table with a copy that has a sink      */
+  /* state, so that words are checked without a branch per letter.            */
   /****************************************************************************/
+  if (options.sink_automaton)
+  {
+    ret_code = init_sink_automaton(automaton_table, &sink_table);
+    if (ret_code != INIT_SINK_AUTOMATON_OK)
+    {
+      printf("The automaton with a sink state could not be built.\n");
+      goto EXIT_LABEL;
+    }
+    if (mapped_automaton == NULL)
+    {
+      free_automaton_table(automaton_table);
+    }
+    automaton_table = NULL;
+  }
+  
+  /****************************************************************************/
+  /* If asked to then build the ShortLex automaton, which accepts only the    */
+  /* normal form of each element, and use it to count the elements of each    */
+  /* length.                                                                  */
+  /****************************************************************************/
+  if (options.shortlex_automaton)
+  {
+    ret_code = init_root_action_table(matrix_data,
+                                      minimal_root_table,
+                                      file_info->width,
+                                      &action_table);
+    assert(ret_code == INIT_ROOT_ACTION_TABLE_OK);
+    add_shortlex_roots(action_table);
+    ret_code = compile_root_action_table(action_table, 
+                                         NULL, 
+                                         &shortlex_table);
+    free_root_action_table(action_table);
+    if (ret_code != COMPILE_ROOT_ACTION_TABLE_OK)
+    {
+      printf("The ShortLex automaton could not be built.\n");
+      goto EXIT_LABEL;
+    }
+    printf("The ShortLex automaton has %ld states.\n", 
+           shortlex_table->num_states);
+    
+    ret_code = count_accepted_words(shortlex_table, 
+                                    SHORTLEX_COUNT_LENGTH, 
+                                    element_counts);
+    assert(ret_code == COUNT_ACCEPTED_WORDS_OK);
+    printf("The number of elements of each length up to %d is:\n", 
+           SHORTLEX_COUNT_LENGTH);
+    for (ii = 0; ii <= SHORTLEX_COUNT_LENGTH; ii++)
+    {
+      printf("%llu ", (unsigned long long) element_counts[ii]);
+    }
+    printf("\n");
+  }
+  
+  /****************************************************************************/
+  /* If asked to then build the automaton for the minimal coset               */
+  /* representatives of W / W_J. A second one which only accepts normal forms */
+  /* is used to count the representatives of each length.                     */
+  /****************************************************************************/
+  if (options.coset_generators != NULL)
+  {
+    for (ii = 0; options.coset_generators[ii] != '\0'; ii++)
+    {
+      if (options.coset_generators[ii] < ASCII_LOWER_A ||
+          options.coset_generators[ii] >= ASCII_LOWER_A + file_info->width)
+      {
+        printf("The generator %c is not in the group.\n", 
+               options.coset_generators[ii]);
+        goto EXIT_LABEL;
+      }
+    }
+    
+    ret_code = init_root_action_table(matrix_data,
+                                      minimal_root_table,
+                                      file_info->width,
+                                      &action_table);
+    assert(ret_code == INIT_ROOT_ACTION_TABLE_OK);
+    ret_code = compile_coset_automaton(action_table, 
+                                       options.coset_generators, 
+                                       &coset_table);
+    if (ret_code == COMPILE_ROOT_ACTION_TABLE_OK)
+    {
+      add_shortlex_roots(action_table);
+      ret_code = compile_coset_automaton(action_table, 
+                                         options.coset_generators, 
+                                         &coset_count_table);
+    }
+    free_root_action_table(action_table);
+    if (ret_code != COMPILE_ROOT_ACTION_TABLE_OK)
+    {
+      printf("The coset automaton could not be built.\n");
+      goto EXIT_LABEL;
+    }
+    printf("The coset automaton has %ld states.\n", 
+           coset_table->num_states);
+    
+    ret_code = count_accepted_words(coset_count_table, 
+                                    SHORTLEX_COUNT_LENGTH, 
+                                    element_counts);
+    assert(ret_code == COUNT_ACCEPTED_WORDS_OK);
+    printf("The number of coset representatives of each length up to %d "
+           "is:\n", 
+           SHORTLEX_COUNT_LENGTH);
+    for (ii = 0; ii <= SHORTLEX_COUNT_LENGTH; ii++)
+    {
+      printf("%llu ", (unsigned long long) element_counts[ii]);
+    }
+    printf("\n");
+  }
+  
+  /****************************************************************************/
+  /* When the flat table is being used reduce words in a single pass, keeping */
+  /* the state after each letter of the reduced word so far. The reduced      */
+  /* words are closed under reversal, so the same table reads words from      */
+  /* right to left to find the letter a rejected one cancels with. The        */
+  /* component automata are used the same way, one component at a time, and   */
+  /* the exchange condition reducer keeps its own stack.                      */
+  /****************************************************************************/
+  if (automaton_table != NULL)
+  {
+    ret_code = init_word_reducer(automaton_table, &word_reducer);
+  }
+  else if (component_automaton != NULL)
+  {
+    ret_code = init_component_word_reducer(component_automaton, 
+                                           &word_reducer);
+  }
+  else if (exchange_reducer != NULL)
+  {
+    ret_code = init_exchange_word_reducer(exchange_reducer, &word_reducer);
+  }
+  if (word_reducer == NULL && 
+      (automaton_table != NULL || 
+       component_automaton != NULL || 
+       exchange_reducer != NULL))
+  {
+    printf("The word reducer could not be created.\n");
+    goto EXIT_LABEL;
+  }
+  
+  /****************************************************************************/
+  /* If given a batch of words then reduce those, across the worker processes */
+  /* if asked to, instead of asking the user for words.                       */
+  /****************************************************************************/
+  if (options.batch_filename != NULL)
+  {
+    assert(word_reducer != NULL);
+    exit_code = 1;
+    
+    /**************************************************************************/
+    /* Map the words if they are in a file, so that they are read straight    */
+    /* from the page cache. Anything else, such as stdin or a pipe, is read   */
+    /* as a stream.                                                           */
+    /**************************************************************************/
+    if (strcmp(options.batch_filename, "-") == 0)
+    {
+      batch_input = stdin;
+    }
+    else if (options.batch_binary_input)
+    {
+      batch_input = fopen(options.batch_filename, "rb");
+    }
+    else
+    {
+      ret_code = map_word_corpus(options.batch_filename, &word_corpus);
+      if (ret_code == MAP_WORD_CORPUS_NOT_REGULAR)
+      {
+        batch_input = fopen(options.batch_filename, "r");
+      }
+      else if (ret_code != MAP_WORD_CORPUS_OK)
+      {
+        fprintf(stderr, 
+                "The words could not be mapped from %s.\n", 
+                options.batch_filename);
+        goto EXIT_LABEL;
+      }
+    }
+    if (word_corpus == NULL && batch_input == NULL)
+    {
+      fprintf(stderr, 
+              "The words could not be read from %s.\n", 
+              options.batch_filename);
+      goto EXIT_LABEL;
+    }
+    batch_output = (options.batch_output_filename == NULL) ? 
+                    results_output : fopen(options.batch_output_filename, "wb");
+    if (batch_output == NULL)
+    {
+      fprintf(stderr, 
+              "The reduced words could not be written to %s.\n", 
+              options.batch_output_filename);
+      goto EXIT_LABEL;
+    }
+    
+    if (options.batch_binary_input)
+    {
+      ret_code = reduce_binary_batch(word_reducer, 
+                                     file_info->width, 
+                                     batch_input, 
+                                     options.batch_binary_output, 
+                                     batch_output, 
+                                     &bad_line);
+    }
+    else
+    {
+      ret_code = reduce_word_batch(word_reducer, 
+                                   file_info->width, 
+                                   options.batch_workers, 
+                                   options.batch_compare_pairs, 
+                                   word_corpus, 
+                                   batch_input, 
+                                   options.batch_binary_output, 
+                                   batch_output, 
+                                   &bad_line);
+    }
+    if (ret_code == BATCH_REDUCE_BAD_WORD && options.batch_binary_input)
+    {
+      if (bad_line == 0)
+      {
+        fprintf(stderr, 
+                "The batch does not start with a word file header for this "
+                "group.\n");
+      }
+      else
+      {
+        fprintf(stderr, 
+                "Word %ld of the batch is not a word in the generators.\n", 
+                bad_line);
+      }
+    }
+    else if (ret_code == BATCH_REDUCE_BAD_WORD)
+    {
+      fprintf(stderr, 
+              "Line %ld of the batch is not %s in the generators.\n", 
+              bad_line, 
+              options.batch_compare_pairs ? "a pair of words" : "a word");
+    }
+    else if (ret_code != BATCH_REDUCE_OK)
+    {
+      fprintf(stderr, "The batch could not be reduced.\n");
+    }
+    else
+    {
+      exit_code = 0;
+    }
+    goto EXIT_LABEL;
+  }
+  
+  /****************************************************************************/
+  /* If given a stream then read it all as one word, keeping only the reduced */
+  /* word so far, and write out the reduced word or its length at the end.    */
+  /****************************************************************************/
+  if (options.stream_filename != NULL)
+  {
+    assert(word_reducer != NULL && word_reducer->components == NULL);
+    exit_code = 1;
+    batch_input = (strcmp(options.stream_filename, "-") == 0) ? 
+                                   stdin : fopen(options.stream_filename, "r");
+    if (batch_input == NULL)
+    {
+      fprintf(stderr, 
+              "The word could not be read from %s.\n", 
+              options.stream_filename);
+      goto EXIT_LABEL;
+    }
+    batch_output = (options.batch_output_filename == NULL) ? 
+                     results_output : fopen(options.batch_output_filename, "w");
+    if (batch_output == NULL)
+    {
+      fprintf(stderr, 
+              "The reduced word could not be written to %s.\n", 
+              options.batch_output_filename);
+      goto EXIT_LABEL;
+    }
+    
+    if (word_reducer->exchange != NULL)
+    {
+      ret_code = init_exchange_stream_reducer(word_reducer->exchange, 
+                                              &stream_reducer);
+    }
+    else
+    {
+      ret_code = init_stream_reducer(word_reducer->table, &stream_reducer);
+    }
+    if (ret_code == STREAM_REDUCER_OK)
+    {
+      ret_code = stream_reduce_file(stream_reducer, batch_input, &bad_offset);
+    }
+    if (ret_code == STREAM_REDUCER_OK)
+    {
+      ret_code = write_stream_reducer(stream_reducer, 
+                                      batch_output, 
+                                      options.stream_length_only);
+    }
+    if (ret_code == STREAM_REDUCER_BAD_LETTER)
+    {
+      fprintf(stderr, 
+              "Byte %ld of the stream is not a generator.\n", 
+              bad_offset);
+    }
+    else if (ret_code != STREAM_REDUCER_OK)
+    {
+      fprintf(stderr, "The stream could not be reduced.\n");
+    }
+    else
+    {
+      exit_code = 0;
+    }
+    goto EXIT_LABEL;
+  }
+  
+  /****************************************************************************/
+  /* Ask the user to enter a word and then check whether it is reduced. With  */
+  /* the one pass reducer any powers in the word are worked out on reduced    */
+  /* words rather than being written out in full first.                       */
+  /****************************************************************************/
+  if (word_reducer != NULL && 
+      init_generator_word(&power_word) != GENERATOR_WORD_OK)
+  {
+    printf("There was a memory allocation error creating the word.\n");
+    goto EXIT_LABEL;
+  }
   printf("To exit program enter nothing when asked for a word.\n");
   while(true)
   {
-    ret_code = user_input_word(file_info->width, MAX_WORD_LEN - 1, &word);
+    if (word_reducer != NULL)
+    {
+      ret_code = user_input_expression(&word);
+    }
+    else
+    {
+      ret_code = user_input_word(file_info->width, MAX_WORD_LEN - 1, &word);
+    }
     if (ret_code == WORD_INPUT_OK)
     {
       printf("word: %s\n", word);
@@ -387,6 +1215,47 @@ int main (void)
         goto EXIT_LABEL;
       }
       
+      if (word_reducer != NULL)
+      {
+        ret_code = evaluate_word_expression(word_reducer, word, power_word);
+        if (ret_code == WORD_POWER_INVALID || 
+            ret_code == WORD_POWER_TOO_LONG || 
+            ret_code == WORD_POWER_TOO_BIG)
+        {
+          if (ret_code == WORD_POWER_INVALID)
+          {
+            printf("The word is not made of generators and bracketed powers "
+                   "such as a(bc)^3.\n");
+          }
+          else if (ret_code == WORD_POWER_TOO_BIG)
+          {
+            printf("An exponent is larger than %llu.\n", 
+                   (unsigned long long) UINT64_MAX);
+          }
+          else
+          {
+            printf("The reduced word is longer than %d letters.\n", 
+                   WORD_POWER_MAX_LENGTH);
+          }
+          free(word);
+          free(reduced_word);
+          free(temp_word);
+          continue;
+        }
+        free(reduced_word);
+        reduced_word = (ret_code == WORD_POWER_OK) ? 
+                            malloc((power_word->length + 1) * sizeof(char)) : 
+                            NULL;
+        if (reduced_word == NULL)
+        {
+          printf("There was a memory allocation error reducing the word.\n");
+          free(word);
+          free(temp_word);
+          goto EXIT_LABEL;
+        }
+        decode_generator_word(power_word, reduced_word);
+      }
+      
       /************************************************************************/
       /* In order to reduce a word in a Coxeter group run through it from the */
       /* left until the point at which it is not reduced is found. Then a new */
@@ -396,13 +1265,22 @@ int main (void)
       /* elements of this subword and rerun all of the above until the word   */
       /* is reduced.                                                          */
       /************************************************************************/
-      while (!is_reduced(state_tree, 
+      while (word_reducer == NULL &&
+             !check_word(automaton_table, 
+                         sink_table,
+                         compressed_table,
+                         component_automaton,
+                         lazy_automaton,
                          reduced_word, 
                          &left_fail_index, 
                          0, 
                          strlen(reduced_word)))
       {
-        is_reduced(state_tree, 
+        check_word(automaton_table, 
+                   sink_table,
+                   compressed_table,
+                   component_automaton,
+                   lazy_automaton,
                    reduced_word, 
                    &right_fail_index, 
                    left_fail_index, 
@@ -425,6 +1303,40 @@ int main (void)
       /* Print the reduced form of the word.                                  */
       /************************************************************************/
       printf("The reduced form of %s is:\n%s\n", word, reduced_word);
+      if (shortlex_table != NULL)
+      {
+        if (is_reduced_table(shortlex_table, 
+                             reduced_word, 
+                             &left_fail_index, 
+                             0, 
+                             strlen(reduced_word)))
+        {
+          printf("This is the ShortLex normal form.\n");
+        }
+        else
+        {
+          printf("This is not the ShortLex normal form.\n");
+        }
+      }
+      
+      /************************************************************************/
+      /* The coset automaton reads words from right to left.                  */
+      /************************************************************************/
+      if (coset_table != NULL)
+      {
+        if (is_reduced_table(coset_table, 
+                             reduced_word, 
+                             &left_fail_index, 
+                             strlen(reduced_word) - 1, 
+                             -1))
+        {
+          printf("This is a minimal coset representative.\n");
+        }
+        else
+        {
+          printf("This is not a minimal coset representative.\n");
+        }
+      }
       
       /************************************************************************/
       /* Free the memory used for the word.                                   */
@@ -444,12 +1356,86 @@ EXIT_LABEL:
   /* to free the list elements.                                               */
   /* Also free the precalculated group information.                           */
   /****************************************************************************/
-  free_root_table(root_table, DELETE_ROOTS);
-  free_root_table(minimal_root_table, NO_DELETE_ROOTS);
-  free_state_tree(binary_state_tree);
-  free_state(state_tree);
+  if (root_table != NULL)
+  {
+    free_root_table(root_table, DELETE_ROOTS);
+    free_root_table(minimal_root_table, NO_DELETE_ROOTS);
+  }
+  if (lazy_automaton != NULL)
+  {
+    free_lazy_automaton(lazy_automaton);
+  }
+  if (binary_state_tree != NULL)
+  {
+    free_state_tree(binary_state_tree);
+  }
+  if (state_tree != NULL)
+  {
+    free_state(state_tree);
+  }
+  if (automaton_table != NULL && mapped_automaton == NULL)
+  {
+    free_automaton_table(automaton_table);
+  }
+  if (mapped_automaton != NULL)
+  {
+    unmap_automaton_file(mapped_automaton);
+  }
+  if (component_automaton != NULL)
+  {
+    free_component_automaton(component_automaton);
+  }
+  if (compressed_table != NULL)
+  {
+    free_compressed_automaton(compressed_table);
+  }
+  if (sink_table != NULL)
+  {
+    free_sink_automaton(sink_table);
+  }
+  if (word_reducer != NULL)
+  {
+    free_word_reducer(word_reducer);
+  }
+  if (exchange_reducer != NULL)
+  {
+    free_exchange_reducer(exchange_reducer);
+  }
+  if (word_corpus != NULL)
+  {
+    unmap_word_corpus(word_corpus);
+  }
+  if (stream_reducer != NULL)
+  {
+    free_stream_reducer(stream_reducer);
+  }
+  if (power_word != NULL)
+  {
+    free_generator_word(power_word);
+  }
+  if (batch_input != NULL && batch_input != stdin)
+  {
+    fclose(batch_input);
+  }
+  if (batch_output != NULL && batch_output != stdout)
+  {
+    fclose(batch_output);
+  }
+  free_sample_words(sample_words, num_sample_words);
+  if (shortlex_table != NULL)
+  {
+    free_automaton_table(shortlex_table);
+  }
+  if (coset_table != NULL)
+  {
+    free_automaton_table(coset_table);
+  }
+  if (coset_count_table != NULL)
+  {
+    free_automaton_table(coset_count_table);
+  }
   free_matrix_data(matrix_data, file_info->width);
   free_file_info(file_info);
    
-  return(0);
+  return(exit_code);
 }
@@ -27,6 +27,12 @@
 #define SEARCH_FORWARDS 1
 #define SEARCH_BACKWARDS -1
 
+/******************************************************************************/
+/* The longest elements which are counted when the ShortLex or coset          */
+/* automaton is built.                                                        */
+/******************************************************************************/
+#define SHORTLEX_COUNT_LENGTH 10
+
 /******************************************************************************/
 /* This structure contains all the pre calculated information about the       */
 /* coxeter matrix.                                                            */
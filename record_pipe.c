@@ -0,0 +1,209 @@
+#include "cox_prot.h"
+
+/******************************************************************************/
+/* Function: init_record_buffer                                               */
+/*                                                                            */
+/* Returns: One of RECORD_BUFFER_RET_CODES.                                   */
+/*                                                                            */
+/* Parameters: IN     record_size - The size in bytes of each record.         */
+/*             OUT    buffer - Will be returned empty.                        */
+/*                                                                            */
+/* Operation: Allocate the buffer object. No records are allocated until the  */
+/*            first one is added.                                             */
+/******************************************************************************/
+int init_record_buffer(size_t record_size, RECORD_BUFFER **buffer)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = RECORD_BUFFER_OK;
+
+  (*buffer) = (RECORD_BUFFER *) calloc(1, sizeof(RECORD_BUFFER));
+  if ((*buffer) == NULL)
+  {
+    ret_code = RECORD_BUFFER_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  (*buffer)->record_size = record_size;
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: free_record_buffer                                               */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     buffer - The buffer to be freed.                        */
+/*                                                                            */
+/* Operation: Free the records and then the buffer itself.                    */
+/******************************************************************************/
+void free_record_buffer(RECORD_BUFFER *buffer)
+{
+  free(buffer->records);
+  free(buffer);
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: reserve_record_buffer                                            */
+/*                                                                            */
+/* Returns: One of RECORD_BUFFER_RET_CODES.                                   */
+/*                                                                            */
+/* Parameters: IN/OUT buffer - The buffer to make room in.                    */
+/*             IN     num_records - The number of records which must fit.     */
+/*                                                                            */
+/* Operation: Double the capacity of the buffer until the records fit. The    */
+/*            records already in the buffer are kept.                         */
+/******************************************************************************/
+int reserve_record_buffer(RECORD_BUFFER *buffer, long num_records)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = RECORD_BUFFER_OK;
+  long new_capacity;
+  char *new_records;
+
+  if (num_records <= buffer->capacity)
+  {
+    goto EXIT_LABEL;
+  }
+
+  new_capacity = (buffer->capacity > 0 ? buffer->capacity : 64);
+  while (new_capacity < num_records)
+  {
+    new_capacity *= 2;
+  }
+  new_records = (char *) realloc(buffer->records,
+                                 buffer->record_size * new_capacity);
+  if (new_records == NULL)
+  {
+    ret_code = RECORD_BUFFER_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  buffer->records = new_records;
+  buffer->capacity = new_capacity;
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: append_record                                                    */
+/*                                                                            */
+/* Returns: One of RECORD_BUFFER_RET_CODES.                                   */
+/*                                                                            */
+/* Parameters: IN/OUT buffer - The buffer to add to.                          */
+/*             IN     record - The record to copy onto the end of the buffer. */
+/*                                                                            */
+/* Operation: Make room for the record and copy it in.                        */
+/******************************************************************************/
+int append_record(RECORD_BUFFER *buffer, const void *record)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code;
+
+  ret_code = reserve_record_buffer(buffer, buffer->num_records + 1);
+  if (ret_code != RECORD_BUFFER_OK)
+  {
+    goto EXIT_LABEL;
+  }
+  memcpy(buffer->records + buffer->num_records * buffer->record_size,
+         record,
+         buffer->record_size);
+  buffer->num_records++;
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: write_record_message                                             */
+/*                                                                            */
+/* Returns: One of RECORD_MESSAGE_RET_CODES.                                  */
+/*                                                                            */
+/* Parameters: IN     stream - The pipe to write to.                          */
+/*             IN     buffer - The records to send.                           */
+/*                                                                            */
+/* Operation: Write the number of records and then the records. The stream is */
+/*            flushed so that the other end doesn't wait for records which    */
+/*            are sitting in a stdio buffer.                                  */
+/******************************************************************************/
+int write_record_message(FILE *stream, RECORD_BUFFER *buffer)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = RECORD_MESSAGE_OK;
+  uint64_t num_records = (uint64_t) buffer->num_records;
+
+  if (fwrite(&num_records, sizeof(uint64_t), 1, stream) != 1 ||
+      (num_records > 0 &&
+       fwrite(buffer->records,
+              buffer->record_size,
+              buffer->num_records,
+              stream) != (size_t) buffer->num_records) ||
+      fflush(stream) != 0)
+  {
+    ret_code = RECORD_MESSAGE_PIPE_ERR;
+  }
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: read_record_message                                              */
+/*                                                                            */
+/* Returns: One of RECORD_MESSAGE_RET_CODES. RECORD_MESSAGE_CLOSED is         */
+/*          returned if the other end closed the pipe between messages.       */
+/*                                                                            */
+/* Parameters: IN     stream - The pipe to read from.                         */
+/*             IN/OUT buffer - Will be returned holding just the records      */
+/*                             which were read.                               */
+/*                                                                            */
+/* Operation: Read the number of records, make room for them and read them.   */
+/******************************************************************************/
+int read_record_message(FILE *stream, RECORD_BUFFER *buffer)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = RECORD_MESSAGE_OK;
+  uint64_t num_records;
+
+  buffer->num_records = 0;
+  if (fread(&num_records, sizeof(uint64_t), 1, stream) != 1)
+  {
+    ret_code = (feof(stream) && !ferror(stream) ? RECORD_MESSAGE_CLOSED :
+                                                   RECORD_MESSAGE_PIPE_ERR);
+    goto EXIT_LABEL;
+  }
+
+  if (reserve_record_buffer(buffer, (long) num_records) != RECORD_BUFFER_OK)
+  {
+    ret_code = RECORD_MESSAGE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  if (num_records > 0 &&
+      fread(buffer->records,
+            buffer->record_size,
+            (size_t) num_records,
+            stream) != (size_t) num_records)
+  {
+    ret_code = RECORD_MESSAGE_PIPE_ERR;
+    goto EXIT_LABEL;
+  }
+  buffer->num_records = (long) num_records;
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
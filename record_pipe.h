@@ -0,0 +1,32 @@
+/******************************************************************************/
+/* Group: RECORD_BUFFER_RET_CODES                                             */
+/*                                                                            */
+/* The return codes for functions init_record_buffer, reserve_record_buffer   */
+/* and append_record.                                                         */
+/******************************************************************************/
+#define RECORD_BUFFER_OK      0
+#define RECORD_BUFFER_MEM_ERR 1
+
+/******************************************************************************/
+/* Group: RECORD_MESSAGE_RET_CODES                                            */
+/*                                                                            */
+/* The return codes for functions read_record_message and                     */
+/* write_record_message.                                                      */
+/******************************************************************************/
+#define RECORD_MESSAGE_OK       0
+#define RECORD_MESSAGE_MEM_ERR  1
+#define RECORD_MESSAGE_PIPE_ERR 2
+#define RECORD_MESSAGE_CLOSED   3
+
+/******************************************************************************/
+/* This structure is an array of fixed size records which grows as records    */
+/* are added to it. It is also the unit sent down a pipe as one message: the  */
+/* number of records (64 bits) followed by the records themselves.            */
+/******************************************************************************/
+typedef struct record_buffer
+{
+  size_t record_size;
+  long num_records;
+  long capacity;
+  char *records;
+} RECORD_BUFFER;
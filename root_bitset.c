@@ -0,0 +1,617 @@
+#include "cox_prot.h"
+
+/******************************************************************************/
+/* Function: init_root_action_table                                           */
+/*                                                                            */
+/* Returns: One of INIT_ROOT_ACTION_TABLE_RET_CODES.                          */
+/*                                                                            */
+/* Parameters: IN     matrix_data - Precalculated information about the group.*/
+/*             IN     minimal_root_table - The minimal roots of the group.    */
+/*             IN     num_generators - The number of group generators.        */
+/*             OUT    action_table - Will be returned holding the action of   */
+/*                                   each generator on each minimal root.     */
+/*                                                                            */
+/* Operation: Number the minimal roots in the order they appear in the table. */
+/*            Then for each root and each generator look up the cached result */
+/*            of the action and record its id if it is minimal.               */
+/******************************************************************************/
+int init_root_action_table(MATRIX_DATA *matrix_data,
+                           ROOT_TABLE *minimal_root_table,
+                           int num_generators,
+                           ROOT_ACTION_TABLE **action_table)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = INIT_ROOT_ACTION_TABLE_OK;
+  ROOT_TABLE_ELEMENT *current_element;
+  ROOT *next_root;
+  long root_id;
+  int ii;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(matrix_data != NULL);
+  assert(minimal_root_table != NULL);
+  assert(num_generators > 0);
+
+  /****************************************************************************/
+  /* Allocate the table object itself.                                        */
+  /****************************************************************************/
+  (*action_table) = (ROOT_ACTION_TABLE *) calloc(1, sizeof(ROOT_ACTION_TABLE));
+  if ((*action_table) == NULL)
+  {
+    ret_code = INIT_ROOT_ACTION_TABLE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* Number the minimal roots.                                                */
+  /****************************************************************************/
+  root_id = 0;
+  for (current_element = minimal_root_table->first;
+       current_element != NULL;
+       current_element = current_element->next)
+  {
+    current_element->root->root_id = root_id;
+    root_id++;
+  }
+  (*action_table)->num_generators = num_generators;
+  (*action_table)->num_roots = root_id;
+  (*action_table)->num_words = (int) ((root_id + ROOT_BITSET_WORD_BITS - 1) /
+                                                        ROOT_BITSET_WORD_BITS);
+  if ((*action_table)->num_words == 0)
+  {
+    (*action_table)->num_words = 1;
+  }
+
+  /****************************************************************************/
+  /* Allocate the arrays of simple root ids and of actions.                   */
+  /****************************************************************************/
+  (*action_table)->simple_root_ids = (long *) malloc(sizeof(long) *
+                                                     num_generators);
+  (*action_table)->actions = (long *) malloc(sizeof(long) *
+                                             (root_id > 0 ? root_id : 1) *
+                                             num_generators);
+  (*action_table)->added_roots = (uint64_t *) calloc((size_t) num_generators *
+                                                     (*action_table)->num_words,
+                                                     sizeof(uint64_t));
+  if ((*action_table)->simple_root_ids == NULL ||
+      (*action_table)->actions == NULL ||
+      (*action_table)->added_roots == NULL)
+  {
+    free_root_action_table(*action_table);
+    (*action_table) = NULL;
+    ret_code = INIT_ROOT_ACTION_TABLE_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* The simple roots are always minimal so they have been numbered above.    */
+  /* Reading a generator adds its simple root to the state.                   */
+  /****************************************************************************/
+  for (ii = 0; ii < num_generators; ii++)
+  {
+    assert(matrix_data->simple_roots[ii]->root_id >= 0);
+    (*action_table)->simple_root_ids[ii] =
+                                         matrix_data->simple_roots[ii]->root_id;
+    root_id = (*action_table)->simple_root_ids[ii];
+    (*action_table)->added_roots[ii * (*action_table)->num_words +
+                                 root_id / ROOT_BITSET_WORD_BITS] |=
+                          ((uint64_t) 1) << (root_id % ROOT_BITSET_WORD_BITS);
+  }
+
+  /****************************************************************************/
+  /* Fill in the action of every generator on every minimal root. The results */
+  /* were all cached when the root table was generated.                       */
+  /****************************************************************************/
+  for (current_element = minimal_root_table->first;
+       current_element != NULL;
+       current_element = current_element->next)
+  {
+    root_id = current_element->root->root_id;
+    for (ii = 0; ii < num_generators; ii++)
+    {
+      next_root = current_element->root->next_roots[ii];
+      assert(next_root != NULL);
+      if (next_root->positive_minimal && next_root->root_id >= 0)
+      {
+        (*action_table)->actions[root_id * num_generators + ii] =
+                                                             next_root->root_id;
+      }
+      else
+      {
+        (*action_table)->actions[root_id * num_generators + ii] =
+                                                        ROOT_BITSET_NOT_MINIMAL;
+      }
+    }
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: free_root_action_table                                           */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     action_table - The table to be freed.                   */
+/*                                                                            */
+/* Operation: Free the arrays and then the table itself.                      */
+/******************************************************************************/
+void free_root_action_table(ROOT_ACTION_TABLE *action_table)
+{
+  free(action_table->simple_root_ids);
+  free(action_table->actions);
+  free(action_table->added_roots);
+  free(action_table);
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: add_shortlex_roots                                               */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN/OUT action_table - The table to set up for the ShortLex     */
+/*                                   automaton.                               */
+/*                                                                            */
+/* Operation: A reduced word is in ShortLex normal form exactly when, for     */
+/*            every letter s in it, no generator t < s is a left descent of   */
+/*            the part of the word starting at s. Reading s then t fails      */
+/*            when the root s(alpha_t) is carried to alpha_t by the rest of   */
+/*            the word, just as the ordinary automaton fails when alpha_s     */
+/*            is. So when s is read add the roots s(alpha_t) for t < s to the */
+/*            state as well as alpha_s.                                       */
+/*            As with the other roots in a state, only the minimal ones need  */
+/*            to be kept. A root which isn't minimal can never be taken to a  */
+/*            simple root.                                                    */
+/******************************************************************************/
+void add_shortlex_roots(ROOT_ACTION_TABLE *action_table)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int num_generators = action_table->num_generators;
+  long root_id;
+  int ii;
+  int jj;
+
+  for (ii = 0; ii < num_generators; ii++)
+  {
+    for (jj = 0; jj < ii; jj++)
+    {
+      root_id = action_table->actions[action_table->simple_root_ids[jj] *
+                                      num_generators + ii];
+      if (root_id != ROOT_BITSET_NOT_MINIMAL)
+      {
+        action_table->added_roots[ii * action_table->num_words +
+                                  root_id / ROOT_BITSET_WORD_BITS] |=
+                          ((uint64_t) 1) << (root_id % ROOT_BITSET_WORD_BITS);
+      }
+    }
+  }
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: root_bitset_next_state                                           */
+/*                                                                            */
+/* Returns: false if reading the generator leads to the failure state (the    */
+/*          word is no longer reduced) and true otherwise.                    */
+/*                                                                            */
+/* Parameters: IN     action_table - The action of the generators on the      */
+/*                                   minimal roots.                           */
+/*             IN     state - The bitset of roots for the current state.      */
+/*             IN     generator - The generator being read.                   */
+/*             OUT    next_state - The bitset of roots for the next state.    */
+/*                                 Only filled in if true is returned.        */
+/*                                                                            */
+/* Operation: This is the same transition as find_next_automaton_state. If    */
+/*            the simple root for the generator is in the state then fail.    */
+/*            Otherwise the next state is the set of minimal images of the    */
+/*            roots in the state together with the added roots for the        */
+/*            generator (normally just the simple root).                      */
+/******************************************************************************/
+bool root_bitset_next_state(ROOT_ACTION_TABLE *action_table,
+                            uint64_t *state,
+                            int generator,
+                            uint64_t *next_state)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  long simple_root_id = action_table->simple_root_ids[generator];
+  long *actions = action_table->actions;
+  int num_generators = action_table->num_generators;
+  uint64_t *added_roots;
+  uint64_t bits;
+  long root_id;
+  long next_root_id;
+  int ii;
+  int jj;
+
+  /****************************************************************************/
+  /* If the simple root is in the state then the word is not reduced.         */
+  /****************************************************************************/
+  if ((state[simple_root_id / ROOT_BITSET_WORD_BITS] >>
+                             (simple_root_id % ROOT_BITSET_WORD_BITS)) & 1)
+  {
+    return(false);
+  }
+
+  memset(next_state, 0, sizeof(uint64_t) * action_table->num_words);
+
+  /****************************************************************************/
+  /* Apply the generator to each root in the state keeping the minimal ones.  */
+  /****************************************************************************/
+  for (ii = 0; ii < action_table->num_words; ii++)
+  {
+    bits = state[ii];
+    for (jj = 0; bits != 0; jj++, bits >>= 1)
+    {
+      if (bits & 1)
+      {
+        root_id = (long) ii * ROOT_BITSET_WORD_BITS + jj;
+        next_root_id = actions[root_id * num_generators + generator];
+        if (next_root_id != ROOT_BITSET_NOT_MINIMAL)
+        {
+          next_state[next_root_id / ROOT_BITSET_WORD_BITS] |=
+                       ((uint64_t) 1) << (next_root_id % ROOT_BITSET_WORD_BITS);
+        }
+      }
+    }
+  }
+
+  /****************************************************************************/
+  /* Finally add the simple root itself and any other added roots.            */
+  /****************************************************************************/
+  added_roots = action_table->added_roots + generator * action_table->num_words;
+  for (ii = 0; ii < action_table->num_words; ii++)
+  {
+    next_state[ii] |= added_roots[ii];
+  }
+
+  return(true);
+}
+
+/******************************************************************************/
+/* Function: compare_root_bitsets                                             */
+/*                                                                            */
+/* Returns: One of COMPARE_STATES_RET_CODES.                                  */
+/*                                                                            */
+/* Parameters: IN     first - The first bitset.                               */
+/*             IN     second - The second bitset.                             */
+/*             IN     num_words - The number of words in each bitset.         */
+/*                                                                            */
+/* Operation: Compare the bitsets a word at a time.                           */
+/******************************************************************************/
+int compare_root_bitsets(const uint64_t *first,
+                         const uint64_t *second,
+                         int num_words)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ii;
+
+  for (ii = 0; ii < num_words; ii++)
+  {
+    if (first[ii] < second[ii])
+    {
+      return(COMPARE_STATES_SMALLER);
+    }
+    if (first[ii] > second[ii])
+    {
+      return(COMPARE_STATES_GREATER);
+    }
+  }
+
+  return(COMPARE_STATES_EQUAL);
+}
+
+/******************************************************************************/
+/* Function: compare_root_bitset_records                                      */
+/*                                                                            */
+/* Returns: One of COMPARE_STATES_RET_CODES.                                  */
+/*                                                                            */
+/* Parameters: IN     first - The first record.                               */
+/*             IN     second - The second record.                             */
+/*             IN     context - Points to an int holding the number of words  */
+/*                              in a bitset.                                  */
+/*                                                                            */
+/* Operation: A record is a bitset followed by one further word. Compare the  */
+/*            whole record as a bitset, so that records with the same bitset  */
+/*            are ordered by the final word.                                  */
+/******************************************************************************/
+int compare_root_bitset_records(const void *first,
+                                const void *second,
+                                void *context)
+{
+  return(compare_root_bitsets((const uint64_t *) first,
+                              (const uint64_t *) second,
+                              *((int *) context) + 1));
+}
+
+/******************************************************************************/
+/* Function: hash_root_bitset                                                 */
+/*                                                                            */
+/* Returns: A hash of the bitset.                                             */
+/*                                                                            */
+/* Parameters: IN     bitset - The bitset to hash.                            */
+/*             IN     num_words - The number of words in the bitset.          */
+/*                                                                            */
+/* Operation: Fold each word into the hash and then mix the result so that    */
+/*            every bit of it depends on every bit of the bitset.             */
+/******************************************************************************/
+uint64_t hash_root_bitset(const uint64_t *bitset, int num_words)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  uint64_t hash = 0x9e3779b97f4a7c15ULL;
+  int ii;
+
+  for (ii = 0; ii < num_words; ii++)
+  {
+    hash = (hash ^ bitset[ii]) * 0x100000001b3ULL;
+    hash ^= hash >> 29;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+
+  return(hash);
+}
+
+/******************************************************************************/
+/* Function: init_root_bitset_index                                           */
+/*                                                                            */
+/* Returns: One of ROOT_BITSET_INDEX_RET_CODES.                               */
+/*                                                                            */
+/* Parameters: IN     num_words - The number of words in each bitset.         */
+/*             OUT    index - Will be returned empty.                         */
+/*                                                                            */
+/* Operation: Allocate the index and its slots and mark every slot unused.    */
+/******************************************************************************/
+int init_root_bitset_index(int num_words, ROOT_BITSET_INDEX **index)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = ROOT_BITSET_INDEX_OK;
+  long ii;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(num_words > 0);
+
+  (*index) = (ROOT_BITSET_INDEX *) calloc(1, sizeof(ROOT_BITSET_INDEX));
+  if ((*index) == NULL)
+  {
+    ret_code = ROOT_BITSET_INDEX_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  (*index)->num_words = num_words;
+  (*index)->capacity = ROOT_BITSET_INDEX_INITIAL_CAPACITY;
+  (*index)->num_entries = 0;
+  (*index)->slots = (uint64_t *) malloc(sizeof(uint64_t) *
+                                        (num_words + 1) *
+                                        (*index)->capacity);
+  if ((*index)->slots == NULL)
+  {
+    free(*index);
+    (*index) = NULL;
+    ret_code = ROOT_BITSET_INDEX_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  for (ii = 0; ii < (*index)->capacity; ii++)
+  {
+    (*index)->slots[ii * (num_words + 1) + num_words] =
+                                             (uint64_t) ROOT_BITSET_INDEX_EMPTY;
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: free_root_bitset_index                                           */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     index - The index to be freed.                          */
+/*                                                                            */
+/* Operation: Free the slots and then the index itself.                       */
+/******************************************************************************/
+void free_root_bitset_index(ROOT_BITSET_INDEX *index)
+{
+  free(index->slots);
+  free(index);
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: find_root_bitset_slot                                            */
+/*                                                                            */
+/* Returns: The slot holding the bitset, or the unused slot where it would be */
+/*          put if it isn't in the index.                                     */
+/*                                                                            */
+/* Parameters: IN     index - The index to search.                            */
+/*             IN     bitset - The bitset to look for.                        */
+/*                                                                            */
+/* Operation: Start at the slot given by the hash and step through the slots  */
+/*            one at a time until either the bitset or an unused slot is      */
+/*            found. The index is never full so this always stops.            */
+/******************************************************************************/
+uint64_t *find_root_bitset_slot(ROOT_BITSET_INDEX *index,
+                                const uint64_t *bitset)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int num_words = index->num_words;
+  long mask = index->capacity - 1;
+  long slot_number;
+  uint64_t *slot;
+
+  slot_number = (long) (hash_root_bitset(bitset, num_words) & (uint64_t) mask);
+  while (true)
+  {
+    slot = index->slots + slot_number * (num_words + 1);
+    if ((int64_t) slot[num_words] == ROOT_BITSET_INDEX_EMPTY ||
+        compare_root_bitsets(slot,
+                             bitset,
+                             num_words) == COMPARE_STATES_EQUAL)
+    {
+      break;
+    }
+    slot_number = (slot_number + 1) & mask;
+  }
+
+  return(slot);
+}
+
+/******************************************************************************/
+/* Function: find_in_root_bitset_index                                        */
+/*                                                                            */
+/* Returns: true if the bitset is in the index and false otherwise.           */
+/*                                                                            */
+/* Parameters: IN     index - The index to search.                            */
+/*             IN     bitset - The bitset to look for.                        */
+/*             OUT    value - The value stored with the bitset. Only filled   */
+/*                            in if true is returned.                         */
+/*                                                                            */
+/* Operation: Find the slot for the bitset and see whether it is in use.      */
+/******************************************************************************/
+bool find_in_root_bitset_index(ROOT_BITSET_INDEX *index,
+                               const uint64_t *bitset,
+                               int64_t *value)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  uint64_t *slot = find_root_bitset_slot(index, bitset);
+
+  if ((int64_t) slot[index->num_words] == ROOT_BITSET_INDEX_EMPTY)
+  {
+    return(false);
+  }
+  (*value) = (int64_t) slot[index->num_words];
+
+  return(true);
+}
+
+/******************************************************************************/
+/* Function: grow_root_bitset_index                                           */
+/*                                                                            */
+/* Returns: One of ROOT_BITSET_INDEX_RET_CODES.                               */
+/*                                                                            */
+/* Parameters: IN/OUT index - The index to grow.                              */
+/*                                                                            */
+/* Operation: Allocate twice as many slots and put every entry back in. The   */
+/*            index is left unchanged if the memory can't be allocated.       */
+/******************************************************************************/
+int grow_root_bitset_index(ROOT_BITSET_INDEX *index)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = ROOT_BITSET_INDEX_OK;
+  int num_words = index->num_words;
+  uint64_t *old_slots = index->slots;
+  long old_capacity = index->capacity;
+  uint64_t *old_slot;
+  uint64_t *new_slot;
+  long ii;
+
+  index->slots = (uint64_t *) malloc(sizeof(uint64_t) *
+                                     (num_words + 1) *
+                                     old_capacity * 2);
+  if (index->slots == NULL)
+  {
+    index->slots = old_slots;
+    ret_code = ROOT_BITSET_INDEX_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  index->capacity = old_capacity * 2;
+  for (ii = 0; ii < index->capacity; ii++)
+  {
+    index->slots[ii * (num_words + 1) + num_words] =
+                                             (uint64_t) ROOT_BITSET_INDEX_EMPTY;
+  }
+
+  for (ii = 0; ii < old_capacity; ii++)
+  {
+    old_slot = old_slots + ii * (num_words + 1);
+    if ((int64_t) old_slot[num_words] != ROOT_BITSET_INDEX_EMPTY)
+    {
+      new_slot = find_root_bitset_slot(index, old_slot);
+      memcpy(new_slot, old_slot, sizeof(uint64_t) * (num_words + 1));
+    }
+  }
+  free(old_slots);
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: set_in_root_bitset_index                                         */
+/*                                                                            */
+/* Returns: One of ROOT_BITSET_INDEX_RET_CODES.                               */
+/*                                                                            */
+/* Parameters: IN/OUT index - The index to update.                            */
+/*             IN     bitset - The bitset to set the value of.                */
+/*             IN     value - The value to store. Must not be                 */
+/*                            ROOT_BITSET_INDEX_EMPTY.                        */
+/*                                                                            */
+/* Operation: Replace the value if the bitset is already in the index.        */
+/*            Otherwise add it, first growing the index if it would become    */
+/*            more than half full.                                            */
+/******************************************************************************/
+int set_in_root_bitset_index(ROOT_BITSET_INDEX *index,
+                             const uint64_t *bitset,
+                             int64_t value)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = ROOT_BITSET_INDEX_OK;
+  uint64_t *slot;
+
+  assert(value != ROOT_BITSET_INDEX_EMPTY);
+
+  slot = find_root_bitset_slot(index, bitset);
+  if ((int64_t) slot[index->num_words] == ROOT_BITSET_INDEX_EMPTY)
+  {
+    if ((index->num_entries + 1) * 2 > index->capacity)
+    {
+      ret_code = grow_root_bitset_index(index);
+      if (ret_code != ROOT_BITSET_INDEX_OK)
+      {
+        goto EXIT_LABEL;
+      }
+      slot = find_root_bitset_slot(index, bitset);
+    }
+    memcpy(slot, bitset, sizeof(uint64_t) * index->num_words);
+    index->num_entries++;
+  }
+  slot[index->num_words] = (uint64_t) value;
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
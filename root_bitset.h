@@ -0,0 +1,75 @@
+/******************************************************************************/
+/* The number of bits held in each word of a root bitset.                     */
+/******************************************************************************/
+#define ROOT_BITSET_WORD_BITS 64
+
+/******************************************************************************/
+/* The value stored in the action table when applying a generator to a        */
+/* minimal root gives a root which is not minimal (so it is dropped from the  */
+/* state).                                                                    */
+/******************************************************************************/
+#define ROOT_BITSET_NOT_MINIMAL -1
+
+/******************************************************************************/
+/* Group: INIT_ROOT_ACTION_TABLE_RET_CODES                                    */
+/*                                                                            */
+/* The return codes for function init_root_action_table.                      */
+/******************************************************************************/
+#define INIT_ROOT_ACTION_TABLE_OK      0
+#define INIT_ROOT_ACTION_TABLE_MEM_ERR 1
+
+/******************************************************************************/
+/* This structure holds the action of the generators on the minimal roots in  */
+/* a form which lets an automaton state be held as a bitset of root ids       */
+/* rather than as a ROOT_TABLE.                                               */
+/* actions[r * num_generators + g] is the id of the root obtained by applying */
+/* generator g to root r, or ROOT_BITSET_NOT_MINIMAL.                         */
+/* A state bitset is num_words words long.                                    */
+/* added_roots holds a bitset for each generator of the roots added to the    */
+/* state when the generator is read. This is just the simple root unless the  */
+/* table has been set up for the ShortLex automaton.                          */
+/******************************************************************************/
+typedef struct root_action_table
+{
+  int num_generators;
+  long num_roots;
+  int num_words;
+  long *simple_root_ids;
+  long *actions;
+  uint64_t *added_roots;
+} ROOT_ACTION_TABLE;
+
+/******************************************************************************/
+/* The value held in an unused slot of a ROOT_BITSET_INDEX. It can't be used  */
+/* as the value of an entry.                                                  */
+/******************************************************************************/
+#define ROOT_BITSET_INDEX_EMPTY INT64_MIN
+
+/******************************************************************************/
+/* The number of slots a ROOT_BITSET_INDEX starts off with. Always a power of */
+/* two.                                                                       */
+/******************************************************************************/
+#define ROOT_BITSET_INDEX_INITIAL_CAPACITY 1024
+
+/******************************************************************************/
+/* Group: ROOT_BITSET_INDEX_RET_CODES                                         */
+/*                                                                            */
+/* The return codes for functions init_root_bitset_index and                  */
+/* set_in_root_bitset_index.                                                  */
+/******************************************************************************/
+#define ROOT_BITSET_INDEX_OK      0
+#define ROOT_BITSET_INDEX_MEM_ERR 1
+
+/******************************************************************************/
+/* This structure maps root bitsets to values using an open addressing hash   */
+/* table. Each slot is num_words words of bitset followed by one word holding */
+/* the value, which is ROOT_BITSET_INDEX_EMPTY if the slot is unused. The     */
+/* table doubles in size whenever it becomes half full.                       */
+/******************************************************************************/
+typedef struct root_bitset_index
+{
+  int num_words;
+  long capacity;
+  long num_entries;
+  uint64_t *slots;
+} ROOT_BITSET_INDEX;
@@ -57,6 +57,7 @@ int init_root(int num_generators, ROOT **root)
   /* All roots are initially assumed to be positive minimal.                  */
   /****************************************************************************/
   (*root)->positive_minimal = true;
+  (*root)->root_id = -1;
 
 EXIT_LABEL:
 
@@ -11,12 +11,16 @@
 /* when they were first performed.                                            */
 /*                                                                            */
 /* A root is positive minimal if it is positive and doesn't dominate anything */
+/*                                                                            */
+/* The root id is -1 until the minimal roots are numbered so that sets of     */
+/* them can be held as bitsets.                                               */
 /******************************************************************************/
 typedef struct root
 {
   double *coefficients;
   struct root **next_roots;
   _Bool positive_minimal;
+  long root_id;
 } ROOT;
 
 /******************************************************************************/
@@ -0,0 +1,377 @@
+#include "cox_prot.h"
+
+/******************************************************************************/
+/* Function: init_stream_reducer                                              */
+/*                                                                            */
+/* Returns: One of STREAM_REDUCER_RET_CODES.                                  */
+/*                                                                            */
+/* Parameters: IN     table - The automaton.                                  */
+/*             OUT    stream - Will be returned holding the empty word.       */
+/*                                                                            */
+/* Operation: Allocate the reducer with room for STREAM_REDUCER_BLOCK_BYTES   */
+/*            letters to begin with. The automata are only pointed to and     */
+/*            must outlive the reducer.                                       */
+/******************************************************************************/
+int init_stream_reducer(AUTOMATON_TABLE *table, STREAM_REDUCER **stream)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = STREAM_REDUCER_OK;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(table != NULL);
+  assert(stream != NULL);
+
+  *stream = (STREAM_REDUCER *) calloc(1, sizeof(STREAM_REDUCER));
+  if (*stream == NULL)
+  {
+    ret_code = STREAM_REDUCER_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  (*stream)->num_generators = table->num_generators;
+  (*stream)->table = table;
+  (*stream)->letters_capacity = STREAM_REDUCER_BLOCK_BYTES;
+  (*stream)->checkpoints_capacity = STREAM_REDUCER_BLOCK_BYTES /
+                                    STREAM_REDUCER_CHECKPOINT_INTERVAL;
+  (*stream)->letters = (char *) malloc((*stream)->letters_capacity);
+  (*stream)->checkpoints = (int32_t *) malloc(sizeof(int32_t) *
+                                           (*stream)->checkpoints_capacity);
+  if ((*stream)->letters == NULL || (*stream)->checkpoints == NULL)
+  {
+    free_stream_reducer(*stream);
+    *stream = NULL;
+    ret_code = STREAM_REDUCER_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  (*stream)->checkpoints[0] = table->start_state;
+  (*stream)->last_state = table->start_state;
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: init_exchange_stream_reducer                                     */
+/*                                                                            */
+/* Returns: One of STREAM_REDUCER_RET_CODES.                                  */
+/*                                                                            */
+/* Parameters: IN/OUT exchange - The exchange condition reducer to use. It is */
+/*                               emptied and then holds the reduced word.     */
+/*             OUT    stream - Will be returned holding the empty word.       */
+/*                                                                            */
+/* Operation: Allocate the reducer. The letters are passed on to the exchange */
+/*            reducer, which keeps the reduced word and its own stack, so     */
+/*            nothing else is allocated. The exchange reducer is only pointed */
+/*            to and must outlive the reducer.                                */
+/******************************************************************************/
+int init_exchange_stream_reducer(EXCHANGE_REDUCER *exchange,
+                                 STREAM_REDUCER **stream)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = STREAM_REDUCER_OK;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(exchange != NULL);
+  assert(stream != NULL);
+
+  *stream = (STREAM_REDUCER *) calloc(1, sizeof(STREAM_REDUCER));
+  if (*stream == NULL)
+  {
+    ret_code = STREAM_REDUCER_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  (*stream)->num_generators = exchange->action_table->num_generators;
+  (*stream)->exchange = exchange;
+  exchange->length = 0;
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: free_stream_reducer                                              */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     stream - The reducer to be freed.                       */
+/*                                                                            */
+/* Operation: Free the reduced word, the checkpoints and then the reducer     */
+/*            itself. The automata and the exchange reducer are left alone.   */
+/******************************************************************************/
+void free_stream_reducer(STREAM_REDUCER *stream)
+{
+  assert(stream != NULL);
+
+  free(stream->letters);
+  free(stream->checkpoints);
+  free(stream);
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: stream_reduce_letter                                             */
+/*                                                                            */
+/* Returns: One of STREAM_REDUCER_RET_CODES.                                  */
+/*                                                                            */
+/* Parameters: IN/OUT stream - The reducer.                                   */
+/*             IN     generator - The generator to multiply by on the right.  */
+/*                                                                            */
+/* Operation: The same as one letter of reduce_word. If the letter is         */
+/*            accepted it goes on the end. Otherwise the letter it cancels    */
+/*            with is found by reading back along the word and deleted, and   */
+/*            the checkpoints after it are worked out again starting from the */
+/*            last one before it. With the exchange condition the letter is   */
+/*            just passed on to exchange_reduce_letter.                       */
+/******************************************************************************/
+int stream_reduce_letter(STREAM_REDUCER *stream, int generator)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = STREAM_REDUCER_OK;
+  int num_generators = stream->num_generators;
+  const int32_t *transitions;
+  char *letters = stream->letters;
+  char *new_letters;
+  int32_t *new_checkpoints;
+  int32_t state;
+  size_t cancel_index;
+  size_t position;
+
+  if (stream->exchange != NULL)
+  {
+    if (exchange_reduce_letter(stream->exchange, generator) !=
+                                                          EXCHANGE_REDUCER_OK)
+    {
+      ret_code = STREAM_REDUCER_MEM_ERR;
+    }
+    goto EXIT_LABEL;
+  }
+
+  transitions = stream->table->transitions;
+  state = transitions[stream->last_state * num_generators + generator];
+  if (state != AUTOMATON_TABLE_REJECT_STATE)
+  {
+    /**************************************************************************/
+    /* Make room for the letter, and for a checkpoint if one falls after it.  */
+    /**************************************************************************/
+    if (stream->length == stream->letters_capacity)
+    {
+      new_letters = (char *) realloc(stream->letters,
+                                     stream->letters_capacity * 2);
+      if (new_letters == NULL)
+      {
+        ret_code = STREAM_REDUCER_MEM_ERR;
+        goto EXIT_LABEL;
+      }
+      stream->letters = new_letters;
+      stream->letters_capacity *= 2;
+    }
+    if ((stream->length + 1) / STREAM_REDUCER_CHECKPOINT_INTERVAL ==
+                                                 stream->checkpoints_capacity)
+    {
+      new_checkpoints = (int32_t *) realloc(stream->checkpoints,
+                                            sizeof(int32_t) *
+                                            stream->checkpoints_capacity * 2);
+      if (new_checkpoints == NULL)
+      {
+        ret_code = STREAM_REDUCER_MEM_ERR;
+        goto EXIT_LABEL;
+      }
+      stream->checkpoints = new_checkpoints;
+      stream->checkpoints_capacity *= 2;
+    }
+
+    stream->letters[stream->length] = (char) (ASCII_LOWER_A + generator);
+    stream->length++;
+    stream->last_state = state;
+    if (stream->length % STREAM_REDUCER_CHECKPOINT_INTERVAL == 0)
+    {
+      stream->checkpoints[stream->length /
+                          STREAM_REDUCER_CHECKPOINT_INTERVAL] = state;
+    }
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* Find the letter the rejected one cancels with. Reading back from the     */
+  /* rejected letter always rejects before running out of letters as the      */
+  /* reduced word with the rejected letter on the end isn't reduced.          */
+  /****************************************************************************/
+  state = transitions[stream->table->start_state * num_generators +
+                      generator];
+  for (cancel_index = stream->length - 1; cancel_index > 0; cancel_index--)
+  {
+    state = transitions[state * num_generators +
+                        (int) letters[cancel_index] - ASCII_LOWER_A];
+    if (state == AUTOMATON_TABLE_REJECT_STATE)
+    {
+      break;
+    }
+  }
+
+  /****************************************************************************/
+  /* Delete it and work out the checkpoints after it again.                   */
+  /****************************************************************************/
+  memmove(letters + cancel_index,
+          letters + cancel_index + 1,
+          stream->length - cancel_index - 1);
+  stream->length--;
+  position = cancel_index - cancel_index % STREAM_REDUCER_CHECKPOINT_INTERVAL;
+  state = stream->checkpoints[position / STREAM_REDUCER_CHECKPOINT_INTERVAL];
+  for (; position < stream->length; position++)
+  {
+    state = transitions[state * num_generators +
+                        (int) letters[position] - ASCII_LOWER_A];
+    if ((position + 1) % STREAM_REDUCER_CHECKPOINT_INTERVAL == 0)
+    {
+      stream->checkpoints[(position + 1) /
+                          STREAM_REDUCER_CHECKPOINT_INTERVAL] = state;
+    }
+  }
+  stream->last_state = state;
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: stream_reduce_file                                               */
+/*                                                                            */
+/* Returns: One of STREAM_REDUCER_RET_CODES.                                  */
+/*                                                                            */
+/* Parameters: IN/OUT stream - The reducer. The word read is multiplied onto  */
+/*                             the end of its reduced word.                   */
+/*             IN     input - The stream to read the word from.               */
+/*             OUT    bad_offset - Will be returned holding the offset in the */
+/*                                 input of the first character which isn't a */
+/*                                 generator or white space, if               */
+/*                                 STREAM_REDUCER_BAD_LETTER is returned.     */
+/*                                                                            */
+/* Operation: Read the input a block at a time until it runs out, feeding     */
+/*            each generator to the reducer. White space, including line      */
+/*            breaks, is ignored so the word may be split over many lines.    */
+/******************************************************************************/
+int stream_reduce_file(STREAM_REDUCER *stream, FILE *input, long *bad_offset)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = STREAM_REDUCER_OK;
+  int num_generators = stream->num_generators;
+  char *block;
+  size_t num_read;
+  size_t ii;
+  long offset = 0;
+  int letter;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(stream != NULL);
+  assert(input != NULL);
+  assert(bad_offset != NULL);
+
+  block = (char *) malloc(STREAM_REDUCER_BLOCK_BYTES);
+  if (block == NULL)
+  {
+    ret_code = STREAM_REDUCER_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  while ((num_read = fread(block,
+                           sizeof(char),
+                           STREAM_REDUCER_BLOCK_BYTES,
+                           input)) > 0)
+  {
+    for (ii = 0; ii < num_read; ii++)
+    {
+      letter = (unsigned char) block[ii];
+      if (letter >= ASCII_LOWER_A && letter < ASCII_LOWER_A + num_generators)
+      {
+        ret_code = stream_reduce_letter(stream, letter - ASCII_LOWER_A);
+        if (ret_code != STREAM_REDUCER_OK)
+        {
+          goto EXIT_LABEL;
+        }
+      }
+      else if (!isspace(letter))
+      {
+        *bad_offset = offset + (long) ii;
+        ret_code = STREAM_REDUCER_BAD_LETTER;
+        goto EXIT_LABEL;
+      }
+    }
+    offset += (long) num_read;
+  }
+  if (ferror(input))
+  {
+    ret_code = STREAM_REDUCER_FILE_ERR;
+  }
+
+EXIT_LABEL:
+
+  free(block);
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: write_stream_reducer                                             */
+/*                                                                            */
+/* Returns: One of STREAM_REDUCER_RET_CODES.                                  */
+/*                                                                            */
+/* Parameters: IN     stream - The reducer.                                   */
+/*             IN     output - The stream to write to.                        */
+/*             IN     length_only - Write only the length of the reduced word */
+/*                                  rather than the word itself.              */
+/*                                                                            */
+/* Operation: Write the reduced word, or its length, followed by a newline.   */
+/******************************************************************************/
+int write_stream_reducer(STREAM_REDUCER *stream,
+                         FILE *output,
+                         bool length_only)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = STREAM_REDUCER_OK;
+  char *letters = stream->letters;
+  size_t length = stream->length;
+
+  if (stream->exchange != NULL)
+  {
+    letters = stream->exchange->letters;
+    length = stream->exchange->length;
+  }
+
+  if (length_only)
+  {
+    if (fprintf(output, "%llu\n", (unsigned long long) length) < 0)
+    {
+      ret_code = STREAM_REDUCER_FILE_ERR;
+    }
+  }
+  else if (fwrite(letters, sizeof(char), length, output) != length ||
+           fputc('\n', output) == EOF)
+  {
+    ret_code = STREAM_REDUCER_FILE_ERR;
+  }
+  if (fflush(output) != 0)
+  {
+    ret_code = STREAM_REDUCER_FILE_ERR;
+  }
+
+  return(ret_code);
+}
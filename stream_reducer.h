@@ -0,0 +1,54 @@
+/******************************************************************************/
+/* Group: STREAM_REDUCER_RET_CODES                                            */
+/*                                                                            */
+/* The return codes for functions init_stream_reducer,                        */
+/* init_exchange_stream_reducer, stream_reduce_letter, stream_reduce_file and */
+/* write_stream_reducer.                                                      */
+/******************************************************************************/
+#define STREAM_REDUCER_OK         0
+#define STREAM_REDUCER_MEM_ERR    1
+#define STREAM_REDUCER_FILE_ERR   2
+#define STREAM_REDUCER_BAD_LETTER 3
+
+/******************************************************************************/
+/* The state is only kept after every this many letters of the reduced word.  */
+/* Any other state is worked out again from the one before it, which costs    */
+/* no more than working out again the states after a cancelled letter.        */
+/******************************************************************************/
+#define STREAM_REDUCER_CHECKPOINT_INTERVAL 16
+
+/******************************************************************************/
+/* The number of bytes read from the input at a time.                         */
+/******************************************************************************/
+#define STREAM_REDUCER_BLOCK_BYTES 65536
+
+/******************************************************************************/
+/* This structure reduces a word of any length as its letters arrive, holding */
+/* only the reduced word so far.                                              */
+/* num_generators - The number of generators of the group.                    */
+/* table - The automaton. The reduced words are closed under reversal, so it  */
+/*         also reads words from right to left. NULL if exchange is used      */
+/*         instead.                                                           */
+/* exchange - If not NULL then the letters are reduced with the exchange      */
+/*            condition, which keeps the reduced word itself, and none of the */
+/*            fields below are used.                                          */
+/* letters - The reduced word so far. It isn't null terminated.               */
+/* length - The length of the reduced word so far.                            */
+/* letters_capacity - The number of letters there is room for.                */
+/* checkpoints - checkpoints[i] is the state of table after reading the       */
+/*               first i * STREAM_REDUCER_CHECKPOINT_INTERVAL letters.        */
+/* checkpoints_capacity - The number of checkpoints there is room for.        */
+/* last_state - The state of table after reading the whole reduced word.      */
+/******************************************************************************/
+typedef struct stream_reducer
+{
+  int num_generators;
+  AUTOMATON_TABLE *table;
+  EXCHANGE_REDUCER *exchange;
+  char *letters;
+  size_t length;
+  size_t letters_capacity;
+  int32_t *checkpoints;
+  size_t checkpoints_capacity;
+  int32_t last_state;
+} STREAM_REDUCER;
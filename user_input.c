@@ -404,6 +404,41 @@ EXIT_LABEL:
   return(ret_code);
 }
 
+/******************************************************************************/
+/* Function: user_input_expression                                            */
+/*                                                                            */
+/* Returns: One of WORD_INPUT_RET_CODES.                                      */
+/*                                                                            */
+/* Parameters: OUT    expression - The word as the user typed it.             */
+/*                                                                            */
+/* Operation: Ask the user for a word in the same way as user_input_word but  */
+/*            return it as typed, brackets and exponents included, so that    */
+/*            its powers can be worked out without writing them out in full.  */
+/*            As it is never expanded it may be up to MAX_EXPRESSION_LEN      */
+/*            long. The caller checks the word while evaluating it.           */
+/******************************************************************************/
+int user_input_expression(char **expression)
+{
+  /****************************************************************************/
+  /* Local variables.                                                         */
+  /****************************************************************************/
+  int ret_code = WORD_INPUT_OK;
+  
+  /****************************************************************************/
+  /* Ask the user for input and flush the output buffer to make sure the user */
+  /* sees the request.                                                        */
+  /****************************************************************************/
+  printf("Enter a word for the group loaded.\n");
+  fflush(stdout);
+  
+  if (input_string(MAX_EXPRESSION_LEN, expression) != STRING_INPUT_OK)
+  {
+    ret_code = WORD_INPUT_INVALID;
+  }
+  
+  return(ret_code);
+}
+
 /******************************************************************************/
 /* Function: user_input_file                                                  */
 /*                                                                            */
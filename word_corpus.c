@@ -0,0 +1,192 @@
+#include "cox_prot.h"
+
+/******************************************************************************/
+/* Function: map_word_corpus                                                  */
+/*                                                                            */
+/* Returns: One of MAP_WORD_CORPUS_RET_CODES.                                 */
+/*                                                                            */
+/* Parameters: IN     filename - A file of words, one to a line.              */
+/*             OUT    corpus - Will be returned holding the mapped file.      */
+/*                                                                            */
+/* Operation: Map the whole file read only. The kernel is told it will be     */
+/*            read from start to finish so that it reads ahead. Nothing is    */
+/*            read here, so the words are only brought in as they are used.   */
+/******************************************************************************/
+int map_word_corpus(char *filename, WORD_CORPUS **corpus)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = MAP_WORD_CORPUS_OK;
+  int file_descriptor = -1;
+  struct stat file_status;
+  void *mapping;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(filename != NULL);
+  assert(corpus != NULL);
+
+  *corpus = (WORD_CORPUS *) calloc(1, sizeof(WORD_CORPUS));
+  if (*corpus == NULL)
+  {
+    ret_code = MAP_WORD_CORPUS_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  file_descriptor = open(filename, O_RDONLY);
+  if (file_descriptor < 0 || fstat(file_descriptor, &file_status) != 0)
+  {
+    ret_code = MAP_WORD_CORPUS_FILE_ERR;
+    goto EXIT_LABEL;
+  }
+  if (!S_ISREG(file_status.st_mode))
+  {
+    ret_code = MAP_WORD_CORPUS_NOT_REGULAR;
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* An empty file can't be mapped, but it doesn't need to be.                */
+  /****************************************************************************/
+  (*corpus)->size = (size_t) file_status.st_size;
+  if ((*corpus)->size > 0)
+  {
+    mapping = mmap(NULL,
+                   (*corpus)->size,
+                   PROT_READ,
+                   MAP_PRIVATE,
+                   file_descriptor,
+                   0);
+    if (mapping == MAP_FAILED)
+    {
+      ret_code = MAP_WORD_CORPUS_FILE_ERR;
+      goto EXIT_LABEL;
+    }
+    (*corpus)->data = (char *) mapping;
+    madvise(mapping, (*corpus)->size, MADV_SEQUENTIAL);
+  }
+
+EXIT_LABEL:
+
+  if (file_descriptor >= 0)
+  {
+    close(file_descriptor);
+  }
+  if (ret_code != MAP_WORD_CORPUS_OK && *corpus != NULL)
+  {
+    unmap_word_corpus(*corpus);
+    *corpus = NULL;
+  }
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: unmap_word_corpus                                                */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     corpus - The mapped file to be released.                */
+/*                                                                            */
+/* Operation: Unmap the file and free the structure.                          */
+/******************************************************************************/
+void unmap_word_corpus(WORD_CORPUS *corpus)
+{
+  assert(corpus != NULL);
+
+  if (corpus->data != NULL)
+  {
+    munmap(corpus->data, corpus->size);
+  }
+  free(corpus);
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: next_corpus_chunk                                                */
+/*                                                                            */
+/* Returns: One of NEXT_CORPUS_CHUNK_RET_CODES. NEXT_CORPUS_CHUNK_BAD_WORD is */
+/*          returned if a line holds anything other than generators, in which */
+/*          case line_number is the line it was on.                           */
+/*                                                                            */
+/* Parameters: IN/OUT corpus - The corpus.                                    */
+/*             IN     num_generators - The number of group generators.        */
+/*             IN     pairs - Each line must be two words with one            */
+/*                            WORD_PAIR_SEPARATOR between them.               */
+/*             IN     min_length - The fewest bytes the chunk should hold.    */
+/*             OUT    start - The offset of the start of the chunk.           */
+/*             OUT    end - The offset one past the end of the chunk. This is */
+/*                          the same as start once the corpus is used up.     */
+/*                                                                            */
+/* Operation: Check each byte from the last chunk onwards until at least      */
+/*            min_length bytes have been checked and a line has ended. A line */
+/*            may end with a carriage return before its newline, and the last */
+/*            line needn't have a newline at all.                             */
+/******************************************************************************/
+int next_corpus_chunk(WORD_CORPUS *corpus,
+                      int num_generators,
+                      bool pairs,
+                      size_t min_length,
+                      size_t *start,
+                      size_t *end)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = NEXT_CORPUS_CHUNK_OK;
+  const char *data = corpus->data;
+  char last_letter = (char) (ASCII_LOWER_A + num_generators - 1);
+  size_t ii = corpus->position;
+  int num_separators = 0;
+  char letter;
+
+  *start = corpus->position;
+  while (ii < corpus->size)
+  {
+    letter = data[ii];
+    ii++;
+    if (letter == '\n')
+    {
+      corpus->line_number++;
+      if (pairs && num_separators != 1)
+      {
+        ret_code = NEXT_CORPUS_CHUNK_BAD_WORD;
+        goto EXIT_LABEL;
+      }
+      num_separators = 0;
+      if (ii - *start >= min_length)
+      {
+        break;
+      }
+    }
+    else if (pairs && letter == WORD_PAIR_SEPARATOR)
+    {
+      num_separators++;
+    }
+    else if ((letter < ASCII_LOWER_A || letter > last_letter) &&
+             !(letter == '\r' && (ii == corpus->size || data[ii] == '\n')))
+    {
+      corpus->line_number++;
+      ret_code = NEXT_CORPUS_CHUNK_BAD_WORD;
+      goto EXIT_LABEL;
+    }
+  }
+  if (ii == corpus->size && ii > *start && data[ii - 1] != '\n')
+  {
+    corpus->line_number++;
+    if (pairs && num_separators != 1)
+    {
+      ret_code = NEXT_CORPUS_CHUNK_BAD_WORD;
+      goto EXIT_LABEL;
+    }
+  }
+  corpus->position = ii;
+  *end = ii;
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
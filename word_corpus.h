@@ -0,0 +1,36 @@
+/******************************************************************************/
+/* Group: MAP_WORD_CORPUS_RET_CODES                                           */
+/*                                                                            */
+/* The return codes for function map_word_corpus. MAP_WORD_CORPUS_NOT_REGULAR */
+/* means the file can only be read as a stream, such as a pipe.               */
+/******************************************************************************/
+#define MAP_WORD_CORPUS_OK          0
+#define MAP_WORD_CORPUS_MEM_ERR     1
+#define MAP_WORD_CORPUS_FILE_ERR    2
+#define MAP_WORD_CORPUS_NOT_REGULAR 3
+
+/******************************************************************************/
+/* Group: NEXT_CORPUS_CHUNK_RET_CODES                                         */
+/*                                                                            */
+/* The return codes for function next_corpus_chunk.                           */
+/******************************************************************************/
+#define NEXT_CORPUS_CHUNK_OK       0
+#define NEXT_CORPUS_CHUNK_BAD_WORD 1
+
+/******************************************************************************/
+/* This structure holds a file of words, one to a line, mapped read only. The */
+/* words are used straight from the mapping so none of them is copied or      */
+/* allocated on its own.                                                      */
+/* data - The start of the mapping, or NULL if the file is empty.             */
+/* size - The length of the file in bytes.                                    */
+/* position - The offset of the first line not yet handed out.                */
+/* line_number - The number of lines handed out so far, or the line of the    */
+/*               bad word if one was found.                                   */
+/******************************************************************************/
+typedef struct word_corpus
+{
+  char *data;
+  size_t size;
+  size_t position;
+  long line_number;
+} WORD_CORPUS;
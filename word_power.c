@@ -0,0 +1,266 @@
+#include "cox_prot.h"
+
+/******************************************************************************/
+/* Function: multiply_generator_words                                         */
+/*                                                                            */
+/* Returns: One of WORD_POWER_RET_CODES.                                      */
+/*                                                                            */
+/* Parameters: IN     reducer - The reducer to use.                           */
+/*             IN     first - The word on the left.                           */
+/*             IN     second - The word on the right.                         */
+/*             OUT    product - Will be returned holding the reduced form of  */
+/*                              first followed by second. It may be first but */
+/*                              not second.                                   */
+/*                                                                            */
+/* Operation: Put the two words side by side and reduce them.                 */
+/******************************************************************************/
+int multiply_generator_words(WORD_REDUCER *reducer,
+                             GENERATOR_WORD *first,
+                             GENERATOR_WORD *second,
+                             GENERATOR_WORD *product)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = WORD_POWER_OK;
+  int length;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(product != second);
+
+  if (first->length > WORD_POWER_MAX_LENGTH - second->length)
+  {
+    ret_code = WORD_POWER_TOO_LONG;
+    goto EXIT_LABEL;
+  }
+  length = first->length + second->length;
+  if (reserve_generator_word(product, length) != GENERATOR_WORD_OK)
+  {
+    ret_code = WORD_POWER_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  if (product != first)
+  {
+    memcpy(product->generators, first->generators, first->length);
+  }
+  memcpy(product->generators + first->length,
+         second->generators,
+         second->length);
+  product->length = length;
+
+  if (reduce_generator_word(reducer, product) != WORD_REDUCER_OK)
+  {
+    ret_code = WORD_POWER_MEM_ERR;
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: power_reduced_word                                               */
+/*                                                                            */
+/* Returns: One of WORD_POWER_RET_CODES.                                      */
+/*                                                                            */
+/* Parameters: IN     reducer - The reducer to use.                           */
+/*             IN     base - The word to raise to the power.                  */
+/*             IN     exponent - The power.                                   */
+/*             OUT    result - Will be returned holding the reduced form of   */
+/*                             base to the power exponent. It must not be     */
+/*                             base.                                          */
+/*                                                                            */
+/* Operation: Multiply by the base one power at a time, for at most           */
+/*            WORD_POWER_ORDER_SEARCH powers. If one of them is the identity  */
+/*            then that is the order of the element and only the exponent     */
+/*            modulo the order is worked out, so any power of an element of   */
+/*            finite order costs no more than its order. Otherwise the rest   */
+/*            of the power is worked out by repeated squaring of reduced      */
+/*            words, so only about twice the log of the exponent products are */
+/*            reduced rather than one for each power.                         */
+/******************************************************************************/
+int power_reduced_word(WORD_REDUCER *reducer,
+                       GENERATOR_WORD *base,
+                       uint64_t exponent,
+                       GENERATOR_WORD *result)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = WORD_POWER_OK;
+  GENERATOR_WORD *square = NULL;
+  GENERATOR_WORD *next_square = NULL;
+  GENERATOR_WORD *swap_word;
+  uint64_t power;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(reducer != NULL);
+  assert(base != NULL);
+  assert(result != NULL && result != base);
+
+  result->length = 0;
+  if (exponent == 0 || base->length == 0)
+  {
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* Look for the order of the element among its first few powers.            */
+  /****************************************************************************/
+  for (power = 1;
+       power <= exponent && power <= WORD_POWER_ORDER_SEARCH;
+       power++)
+  {
+    ret_code = multiply_generator_words(reducer, result, base, result);
+    if (ret_code != WORD_POWER_OK)
+    {
+      goto EXIT_LABEL;
+    }
+    if (result->length == 0)
+    {
+      exponent %= power;
+      for (power = 0; power < exponent; power++)
+      {
+        ret_code = multiply_generator_words(reducer, result, base, result);
+        if (ret_code != WORD_POWER_OK)
+        {
+          goto EXIT_LABEL;
+        }
+      }
+      goto EXIT_LABEL;
+    }
+  }
+  if (power > exponent)
+  {
+    goto EXIT_LABEL;
+  }
+
+  /****************************************************************************/
+  /* No power up to here was the identity. The result is the base to the      */
+  /* power - 1, so multiply in the rest by squaring the base.                 */
+  /****************************************************************************/
+  exponent -= power - 1;
+  if (init_generator_word(&square) != GENERATOR_WORD_OK ||
+      init_generator_word(&next_square) != GENERATOR_WORD_OK ||
+      reserve_generator_word(square, base->length) != GENERATOR_WORD_OK)
+  {
+    ret_code = WORD_POWER_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  memcpy(square->generators, base->generators, base->length);
+  square->length = base->length;
+  while (exponent > 0)
+  {
+    if (exponent & 1)
+    {
+      ret_code = multiply_generator_words(reducer, result, square, result);
+      if (ret_code != WORD_POWER_OK)
+      {
+        goto EXIT_LABEL;
+      }
+    }
+    exponent >>= 1;
+    if (exponent > 0)
+    {
+      ret_code = multiply_generator_words(reducer,
+                                          square,
+                                          square,
+                                          next_square);
+      if (ret_code != WORD_POWER_OK)
+      {
+        goto EXIT_LABEL;
+      }
+      swap_word = square;
+      square = next_square;
+      next_square = swap_word;
+    }
+  }
+
+EXIT_LABEL:
+
+  if (square != NULL)
+  {
+    free_generator_word(square);
+  }
+  if (next_square != NULL)
+  {
+    free_generator_word(next_square);
+  }
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: evaluate_word_expression                                         */
+/*                                                                            */
+/* Returns: One of WORD_POWER_RET_CODES. WORD_POWER_INVALID is returned if    */
+/*          the expression isn't letters and bracketed words raised to        */
+/*          powers, such as ab(cd(ab)^3)^1000000000, and WORD_POWER_TOO_BIG   */
+/*          if one of the exponents doesn't fit in 64 bits.                   */
+/*                                                                            */
+/* Parameters: IN     reducer - The reducer to use.                           */
+/*             IN     expression - The word as typed.                         */
+/*             OUT    result - Will be returned holding the reduced form of   */
+/*                             the word.                                      */
+/*                                                                            */
+/* Operation: Parse the expression into a word program, so that each          */
+/*            distinct subexpression is reduced once however often it is      */
+/*            repeated, and evaluate it. The cost follows the size of the     */
+/*            program rather than the length of the word written out.         */
+/******************************************************************************/
+int evaluate_word_expression(WORD_REDUCER *reducer,
+                             const char *expression,
+                             GENERATOR_WORD *result)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = WORD_POWER_OK;
+  WORD_PROGRAM *program = NULL;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(reducer != NULL);
+  assert(expression != NULL);
+  assert(result != NULL);
+
+  if (init_word_program(&program) != WORD_PROGRAM_OK)
+  {
+    ret_code = WORD_POWER_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  switch (parse_word_program(program,
+                             expression,
+                             reducer->num_generators))
+  {
+    case WORD_PROGRAM_OK:
+      ret_code = evaluate_word_program(reducer, program, result);
+      break;
+
+    case WORD_PROGRAM_INVALID:
+      ret_code = WORD_POWER_INVALID;
+      break;
+
+    case WORD_PROGRAM_TOO_BIG:
+      ret_code = WORD_POWER_TOO_BIG;
+      break;
+
+    default:
+      ret_code = WORD_POWER_MEM_ERR;
+      break;
+  }
+
+EXIT_LABEL:
+
+  if (program != NULL)
+  {
+    free_word_program(program);
+  }
+
+  return(ret_code);
+}
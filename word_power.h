@@ -0,0 +1,28 @@
+/******************************************************************************/
+/* Group: WORD_POWER_RET_CODES                                                */
+/*                                                                            */
+/* The return codes for functions multiply_generator_words,                   */
+/* power_reduced_word and evaluate_word_expression. WORD_POWER_TOO_LONG means */
+/* the reduced word would be longer than WORD_POWER_MAX_LENGTH and            */
+/* WORD_POWER_TOO_BIG that an exponent doesn't fit in 64 bits.                */
+/******************************************************************************/
+#define WORD_POWER_OK       0
+#define WORD_POWER_MEM_ERR  1
+#define WORD_POWER_INVALID  2
+#define WORD_POWER_TOO_LONG 3
+#define WORD_POWER_TOO_BIG  4
+
+/******************************************************************************/
+/* The most powers of an element which are worked out one at a time looking   */
+/* for its order before falling back to repeated squaring. It is well above   */
+/* the order of any element of a finite parabolic subgroup of rank at most    */
+/* MAX_GENERATORS other than a dihedral one with a larger label.              */
+/******************************************************************************/
+#define WORD_POWER_ORDER_SEARCH 1024
+
+/******************************************************************************/
+/* The longest reduced word a power may have. An element of infinite order    */
+/* has powers whose length grows with the exponent, so a large enough power   */
+/* of one can't be held at all.                                               */
+/******************************************************************************/
+#define WORD_POWER_MAX_LENGTH (1 << 24)
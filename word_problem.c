@@ -0,0 +1,133 @@
+#include "cox_prot.h"
+
+/******************************************************************************/
+/* Function: words_equal                                                      */
+/*                                                                            */
+/* Returns: One of WORDS_EQUAL_RET_CODES.                                     */
+/*                                                                            */
+/* Parameters: IN     reducer - The reducer to use.                           */
+/*             IN     first - The first word.                                 */
+/*             IN     second - The second word.                               */
+/*             IN/OUT product - Room to work in. It is overwritten and grown  */
+/*                              as needed, so can be kept between calls.      */
+/*             OUT    equal - Will be returned true if the two words are the  */
+/*                            same element of the group.                      */
+/*                                                                            */
+/* Operation: Every generator is its own inverse, so the inverse of the       */
+/*            second word is just its generators in reverse. The words are    */
+/*            equal exactly when the first followed by that reduces to the    */
+/*            empty word. Words of different parity can never be equal, as    */
+/*            the parity of the length of a word is the same for every word   */
+/*            of an element, so they are not reduced at all.                  */
+/******************************************************************************/
+int words_equal(WORD_REDUCER *reducer,
+                GENERATOR_WORD *first,
+                GENERATOR_WORD *second,
+                GENERATOR_WORD *product,
+                bool *equal)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = WORDS_EQUAL_OK;
+  int ii;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(reducer != NULL);
+  assert(first != NULL);
+  assert(second != NULL);
+  assert(product != NULL);
+  assert(equal != NULL);
+
+  *equal = false;
+  if ((first->length + second->length) % 2 != 0)
+  {
+    goto EXIT_LABEL;
+  }
+
+  if (reserve_generator_word(product, first->length + second->length) !=
+                                                             GENERATOR_WORD_OK)
+  {
+    ret_code = WORDS_EQUAL_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  memcpy(product->generators, first->generators, first->length);
+  for (ii = 0; ii < second->length; ii++)
+  {
+    product->generators[first->length + ii] =
+                                 second->generators[second->length - 1 - ii];
+  }
+  product->length = first->length + second->length;
+
+  if (reduce_generator_word(reducer, product) != WORD_REDUCER_OK)
+  {
+    ret_code = WORDS_EQUAL_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  *equal = (product->length == 0);
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: words_equal_text                                                 */
+/*                                                                            */
+/* Returns: One of WORDS_EQUAL_RET_CODES. WORDS_EQUAL_BAD_LETTER is returned  */
+/*          if either word holds a letter which isn't a generator.            */
+/*                                                                            */
+/* Parameters: IN     reducer - The reducer to use.                           */
+/*             IN     first - The letters of the first word.                  */
+/*             IN     first_length - The number of letters in the first word. */
+/*             IN     second - The letters of the second word.                */
+/*             IN     second_length - The number of letters in the second     */
+/*                                    word.                                   */
+/*             IN/OUT words - Three words to work in, as for words_equal. The */
+/*                            first two hold the encoded words.               */
+/*             OUT    equal - Will be returned true if the two words are the  */
+/*                            same element of the group.                      */
+/*                                                                            */
+/* Operation: Encode the two words and compare them with words_equal.         */
+/******************************************************************************/
+int words_equal_text(WORD_REDUCER *reducer,
+                     const char *first,
+                     int first_length,
+                     const char *second,
+                     int second_length,
+                     GENERATOR_WORD **words,
+                     bool *equal)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = WORDS_EQUAL_OK;
+  int num_generators = reducer->num_generators;
+  int encode_ret_code;
+
+  encode_ret_code = encode_generator_word(first,
+                                          first_length,
+                                          num_generators,
+                                          words[0]);
+  if (encode_ret_code == GENERATOR_WORD_OK)
+  {
+    encode_ret_code = encode_generator_word(second,
+                                            second_length,
+                                            num_generators,
+                                            words[1]);
+  }
+  if (encode_ret_code != GENERATOR_WORD_OK)
+  {
+    ret_code = (encode_ret_code == GENERATOR_WORD_BAD_LETTER) ?
+                                   WORDS_EQUAL_BAD_LETTER : WORDS_EQUAL_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+
+  ret_code = words_equal(reducer, words[0], words[1], words[2], equal);
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
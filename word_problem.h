@@ -0,0 +1,13 @@
+/******************************************************************************/
+/* Group: WORDS_EQUAL_RET_CODES                                               */
+/*                                                                            */
+/* The return codes for functions words_equal and words_equal_text.           */
+/******************************************************************************/
+#define WORDS_EQUAL_OK         0
+#define WORDS_EQUAL_MEM_ERR    1
+#define WORDS_EQUAL_BAD_LETTER 2
+
+/******************************************************************************/
+/* The character between the two words of a pair in a batch of pairs.         */
+/******************************************************************************/
+#define WORD_PAIR_SEPARATOR ' '
@@ -0,0 +1,689 @@
+#include "cox_prot.h"
+
+/******************************************************************************/
+/* Function: init_word_program                                                */
+/*                                                                            */
+/* Returns: One of WORD_PROGRAM_RET_CODES.                                    */
+/*                                                                            */
+/* Parameters: OUT    program - Will be returned holding no nodes.            */
+/*                                                                            */
+/* Operation: Allocate the program with room for                              */
+/*            WORD_PROGRAM_INITIAL_CAPACITY nodes, letters and buckets, and   */
+/*            mark every bucket empty.                                        */
+/******************************************************************************/
+int init_word_program(WORD_PROGRAM **program)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = WORD_PROGRAM_OK;
+  int ii;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(program != NULL);
+
+  *program = (WORD_PROGRAM *) malloc(sizeof(WORD_PROGRAM));
+  if (*program == NULL)
+  {
+    ret_code = WORD_PROGRAM_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  (*program)->num_nodes = 0;
+  (*program)->capacity = WORD_PROGRAM_INITIAL_CAPACITY;
+  (*program)->num_letters = 0;
+  (*program)->letters_capacity = WORD_PROGRAM_INITIAL_CAPACITY;
+  (*program)->num_buckets = WORD_PROGRAM_INITIAL_CAPACITY;
+  (*program)->root = -1;
+  (*program)->nodes = (WORD_PROGRAM_NODE *) malloc(
+                     sizeof(WORD_PROGRAM_NODE) * WORD_PROGRAM_INITIAL_CAPACITY);
+  (*program)->letters = (uint8_t *) malloc(WORD_PROGRAM_INITIAL_CAPACITY);
+  (*program)->buckets = (int *) malloc(sizeof(int) *
+                                       WORD_PROGRAM_INITIAL_CAPACITY);
+  if ((*program)->nodes == NULL ||
+      (*program)->letters == NULL ||
+      (*program)->buckets == NULL)
+  {
+    free((*program)->nodes);
+    free((*program)->letters);
+    free((*program)->buckets);
+    free(*program);
+    *program = NULL;
+    ret_code = WORD_PROGRAM_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  for (ii = 0; ii < WORD_PROGRAM_INITIAL_CAPACITY; ii++)
+  {
+    (*program)->buckets[ii] = -1;
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: free_word_program                                                */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     program - The program to be freed.                      */
+/*                                                                            */
+/* Operation: Free any values still held by the nodes and then the program.   */
+/******************************************************************************/
+void free_word_program(WORD_PROGRAM *program)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ii;
+
+  assert(program != NULL);
+
+  for (ii = 0; ii < program->num_nodes; ii++)
+  {
+    if (program->nodes[ii].value != NULL)
+    {
+      free_generator_word(program->nodes[ii].value);
+    }
+  }
+  free(program->nodes);
+  free(program->letters);
+  free(program->buckets);
+  free(program);
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: hash_word_program_node                                           */
+/*                                                                            */
+/* Returns: A hash of the node.                                               */
+/*                                                                            */
+/* Parameters: IN     program - The program holding the letters of runs.      */
+/*             IN     type - One of WORD_PROGRAM_NODE_TYPES.                  */
+/*             IN     left - As for the left field of WORD_PROGRAM_NODE.      */
+/*             IN     right - As for the right field of WORD_PROGRAM_NODE.    */
+/*             IN     exponent - The exponent of a power.                     */
+/*                                                                            */
+/* Operation: Hash a run by its letters rather than where they are, so that   */
+/*            equal runs typed in different places hash the same. Mix the     */
+/*            fields with hash_root_bitset.                                   */
+/******************************************************************************/
+uint64_t hash_word_program_node(WORD_PROGRAM *program,
+                                int type,
+                                int left,
+                                int right,
+                                uint64_t exponent)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  uint64_t key[4];
+  uint64_t letters_hash = 0xcbf29ce484222325ULL;
+  int ii;
+
+  key[0] = (uint64_t) type;
+  key[2] = (uint64_t) right;
+  key[3] = exponent;
+  if (type == WORD_PROGRAM_RUN)
+  {
+    for (ii = 0; ii < right; ii++)
+    {
+      letters_hash = (letters_hash ^ program->letters[left + ii]) *
+                                                             0x100000001b3ULL;
+    }
+    key[1] = letters_hash;
+  }
+  else
+  {
+    key[1] = (uint64_t) left;
+  }
+
+  return(hash_root_bitset(key, 4));
+}
+
+/******************************************************************************/
+/* Function: add_word_program_node                                            */
+/*                                                                            */
+/* Returns: One of WORD_PROGRAM_RET_CODES.                                    */
+/*                                                                            */
+/* Parameters: IN/OUT program - The program to add the node to.               */
+/*             IN     type - One of WORD_PROGRAM_NODE_TYPES.                  */
+/*             IN     left - As for the left field of WORD_PROGRAM_NODE. The  */
+/*                           letters of a run must be the last ones in the    */
+/*                           program.                                         */
+/*             IN     right - As for the right field of WORD_PROGRAM_NODE.    */
+/*             IN     exponent - The exponent of a power.                     */
+/*             OUT    node - Will be returned holding the index of the node.  */
+/*                                                                            */
+/* Operation: A product with the empty word is the other word, a power with   */
+/*            exponent 1 is the word raised and any other power of the empty  */
+/*            word or power 0 is the empty word, so no node is added for      */
+/*            those. Otherwise look for the node in its hash bucket and only  */
+/*            add it if it isn't there. When an equal run is found its        */
+/*            letters are dropped again. The buckets are doubled once there   */
+/*            are as many nodes as buckets.                                   */
+/******************************************************************************/
+int add_word_program_node(WORD_PROGRAM *program,
+                          int type,
+                          int left,
+                          int right,
+                          uint64_t exponent,
+                          int *node)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = WORD_PROGRAM_OK;
+  WORD_PROGRAM_NODE *nodes = program->nodes;
+  WORD_PROGRAM_NODE *new_nodes;
+  int *new_buckets;
+  uint64_t hash;
+  int bucket;
+  int ii;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(type != WORD_PROGRAM_RUN || left + right == program->num_letters);
+  assert(node != NULL);
+
+  if (type == WORD_PROGRAM_PRODUCT &&
+      nodes[left].type == WORD_PROGRAM_RUN && nodes[left].right == 0)
+  {
+    *node = right;
+    goto EXIT_LABEL;
+  }
+  if (type == WORD_PROGRAM_PRODUCT &&
+      nodes[right].type == WORD_PROGRAM_RUN && nodes[right].right == 0)
+  {
+    *node = left;
+    goto EXIT_LABEL;
+  }
+  if (type == WORD_PROGRAM_POWER && exponent == 1)
+  {
+    *node = left;
+    goto EXIT_LABEL;
+  }
+  if (type == WORD_PROGRAM_POWER &&
+      (exponent == 0 ||
+       (nodes[left].type == WORD_PROGRAM_RUN && nodes[left].right == 0)))
+  {
+    type = WORD_PROGRAM_RUN;
+    left = program->num_letters;
+    right = 0;
+    exponent = 0;
+  }
+  if (type == WORD_PROGRAM_PRODUCT)
+  {
+    exponent = 0;
+  }
+  else if (type == WORD_PROGRAM_POWER)
+  {
+    right = -1;
+  }
+
+  /****************************************************************************/
+  /* Look for the node.                                                       */
+  /****************************************************************************/
+  hash = hash_word_program_node(program, type, left, right, exponent);
+  bucket = (int) (hash & (uint64_t) (program->num_buckets - 1));
+  for (*node = program->buckets[bucket];
+       *node != -1;
+       *node = nodes[*node].next)
+  {
+    if (nodes[*node].hash != hash ||
+        nodes[*node].type != type ||
+        nodes[*node].right != right ||
+        nodes[*node].exponent != exponent)
+    {
+      continue;
+    }
+    if (type != WORD_PROGRAM_RUN && nodes[*node].left == left)
+    {
+      goto EXIT_LABEL;
+    }
+    if (type == WORD_PROGRAM_RUN &&
+        memcmp(program->letters + nodes[*node].left,
+               program->letters + left,
+               right) == 0)
+    {
+      program->num_letters -= right;
+      goto EXIT_LABEL;
+    }
+  }
+
+  /****************************************************************************/
+  /* It isn't there so add it.                                                */
+  /****************************************************************************/
+  if (program->num_nodes == program->capacity)
+  {
+    new_nodes = (WORD_PROGRAM_NODE *) realloc(program->nodes,
+                     sizeof(WORD_PROGRAM_NODE) * program->capacity * 2);
+    if (new_nodes == NULL)
+    {
+      ret_code = WORD_PROGRAM_MEM_ERR;
+      goto EXIT_LABEL;
+    }
+    program->nodes = new_nodes;
+    program->capacity *= 2;
+    nodes = new_nodes;
+  }
+  *node = program->num_nodes;
+  nodes[*node].type = type;
+  nodes[*node].left = left;
+  nodes[*node].right = right;
+  nodes[*node].exponent = exponent;
+  nodes[*node].hash = hash;
+  nodes[*node].next = program->buckets[bucket];
+  nodes[*node].uses = 0;
+  nodes[*node].value = NULL;
+  program->buckets[bucket] = *node;
+  program->num_nodes++;
+
+  /****************************************************************************/
+  /* Double the buckets and put every node back in if they are full.          */
+  /****************************************************************************/
+  if (program->num_nodes >= program->num_buckets)
+  {
+    new_buckets = (int *) realloc(program->buckets,
+                                  sizeof(int) * program->num_buckets * 2);
+    if (new_buckets == NULL)
+    {
+      ret_code = WORD_PROGRAM_MEM_ERR;
+      goto EXIT_LABEL;
+    }
+    program->buckets = new_buckets;
+    program->num_buckets *= 2;
+    for (ii = 0; ii < program->num_buckets; ii++)
+    {
+      program->buckets[ii] = -1;
+    }
+    for (ii = 0; ii < program->num_nodes; ii++)
+    {
+      bucket = (int) (nodes[ii].hash &
+                      (uint64_t) (program->num_buckets - 1));
+      nodes[ii].next = program->buckets[bucket];
+      program->buckets[bucket] = ii;
+    }
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: parse_word_program                                               */
+/*                                                                            */
+/* Returns: One of WORD_PROGRAM_RET_CODES.                                    */
+/*                                                                            */
+/* Parameters: IN/OUT program - An empty program. Will be returned holding    */
+/*                              the expression with its root set.             */
+/*             IN     expression - The word as typed, such as                 */
+/*                                 ab(cd(ab)^3)^1000000000.                   */
+/*             IN     num_generators - The number of group generators.        */
+/*                                                                            */
+/* Operation: Read the expression once from left to right. A stack holds the  */
+/*            node for the part of each open bracket read so far, so brackets */
+/*            may be nested as deeply as memory allows. Each run of letters,  */
+/*            each closed bracket with its exponent and each item multiplied  */
+/*            onto the part before it is added with add_word_program_node, so */
+/*            nothing is written out in full and repeated subexpressions      */
+/*            become the same node.                                           */
+/******************************************************************************/
+int parse_word_program(WORD_PROGRAM *program,
+                       const char *expression,
+                       int num_generators)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = WORD_PROGRAM_OK;
+  int *sequences = NULL;
+  int *new_sequences;
+  int sequences_capacity = WORD_PROGRAM_INITIAL_CAPACITY;
+  int depth = 0;
+  int position = 0;
+  int run_start;
+  int item;
+  int digit;
+  uint8_t *new_letters;
+  uint64_t exponent;
+  char letter;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(program != NULL && program->num_nodes == 0);
+  assert(expression != NULL);
+
+  sequences = (int *) malloc(sizeof(int) * sequences_capacity);
+  if (sequences == NULL)
+  {
+    ret_code = WORD_PROGRAM_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  sequences[0] = -1;
+
+  while (true)
+  {
+    letter = expression[position];
+    if (letter >= ASCII_LOWER_A && letter < ASCII_LOWER_A + num_generators)
+    {
+      /************************************************************************/
+      /* Copy the run of letters to the end of the letters of the program.    */
+      /************************************************************************/
+      run_start = program->num_letters;
+      while (letter >= ASCII_LOWER_A &&
+             letter < ASCII_LOWER_A + num_generators)
+      {
+        if (program->num_letters == program->letters_capacity)
+        {
+          new_letters = (uint8_t *) realloc(program->letters,
+                                            program->letters_capacity * 2);
+          if (new_letters == NULL)
+          {
+            ret_code = WORD_PROGRAM_MEM_ERR;
+            goto EXIT_LABEL;
+          }
+          program->letters = new_letters;
+          program->letters_capacity *= 2;
+        }
+        program->letters[program->num_letters] =
+                                             (uint8_t) (letter - ASCII_LOWER_A);
+        program->num_letters++;
+        position++;
+        letter = expression[position];
+      }
+      ret_code = add_word_program_node(program,
+                                       WORD_PROGRAM_RUN,
+                                       run_start,
+                                       program->num_letters - run_start,
+                                       0,
+                                       &item);
+    }
+    else if (letter == '(')
+    {
+      /************************************************************************/
+      /* Open a bracket with nothing in it yet.                               */
+      /************************************************************************/
+      depth++;
+      if (depth == sequences_capacity)
+      {
+        new_sequences = (int *) realloc(sequences,
+                                   sizeof(int) * sequences_capacity * 2);
+        if (new_sequences == NULL)
+        {
+          ret_code = WORD_PROGRAM_MEM_ERR;
+          goto EXIT_LABEL;
+        }
+        sequences = new_sequences;
+        sequences_capacity *= 2;
+      }
+      sequences[depth] = -1;
+      position++;
+      continue;
+    }
+    else if (letter == ')' && depth > 0)
+    {
+      /************************************************************************/
+      /* Close the bracket, which must be followed by ^ and at least one      */
+      /* digit, and raise what was in it to the power.                        */
+      /************************************************************************/
+      if (expression[position + 1] != '^' ||
+          !isdigit((unsigned char) expression[position + 2]))
+      {
+        ret_code = WORD_PROGRAM_INVALID;
+        goto EXIT_LABEL;
+      }
+      position += 2;
+      exponent = 0;
+      while (isdigit((unsigned char) expression[position]))
+      {
+        digit = expression[position] - '0';
+        if (exponent > (UINT64_MAX - digit) / 10)
+        {
+          ret_code = WORD_PROGRAM_TOO_BIG;
+          goto EXIT_LABEL;
+        }
+        exponent = exponent * 10 + digit;
+        position++;
+      }
+      item = sequences[depth];
+      depth--;
+      if (item == -1)
+      {
+        ret_code = add_word_program_node(program,
+                                         WORD_PROGRAM_RUN,
+                                         program->num_letters,
+                                         0,
+                                         0,
+                                         &item);
+        if (ret_code != WORD_PROGRAM_OK)
+        {
+          goto EXIT_LABEL;
+        }
+      }
+      ret_code = add_word_program_node(program,
+                                       WORD_PROGRAM_POWER,
+                                       item,
+                                       -1,
+                                       exponent,
+                                       &item);
+    }
+    else if (letter == '\0' && depth == 0)
+    {
+      break;
+    }
+    else
+    {
+      ret_code = WORD_PROGRAM_INVALID;
+      goto EXIT_LABEL;
+    }
+    if (ret_code != WORD_PROGRAM_OK)
+    {
+      goto EXIT_LABEL;
+    }
+
+    /**************************************************************************/
+    /* Multiply the item onto the part of the innermost open bracket read so  */
+    /* far.                                                                   */
+    /**************************************************************************/
+    if (sequences[depth] == -1)
+    {
+      sequences[depth] = item;
+    }
+    else
+    {
+      ret_code = add_word_program_node(program,
+                                       WORD_PROGRAM_PRODUCT,
+                                       sequences[depth],
+                                       item,
+                                       0,
+                                       &sequences[depth]);
+      if (ret_code != WORD_PROGRAM_OK)
+      {
+        goto EXIT_LABEL;
+      }
+    }
+  }
+
+  /****************************************************************************/
+  /* An empty expression is the empty word.                                   */
+  /****************************************************************************/
+  program->root = sequences[0];
+  if (program->root == -1)
+  {
+    ret_code = add_word_program_node(program,
+                                     WORD_PROGRAM_RUN,
+                                     program->num_letters,
+                                     0,
+                                     0,
+                                     &program->root);
+  }
+
+EXIT_LABEL:
+
+  free(sequences);
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: evaluate_word_program                                            */
+/*                                                                            */
+/* Returns: One of WORD_POWER_RET_CODES.                                      */
+/*                                                                            */
+/* Parameters: IN     reducer - The reducer to use.                           */
+/*             IN/OUT program - A parsed program. Its nodes are evaluated.    */
+/*             OUT    result - Will be returned holding the reduced form of   */
+/*                             the whole expression.                          */
+/*                                                                            */
+/* Operation: Count how many nodes use each node, working back from the root  */
+/*            so that nodes which were added but aren't needed are never      */
+/*            evaluated. Then evaluate the nodes in order, so that every node */
+/*            is reduced exactly once from the reduced words of the nodes it  */
+/*            uses. Once the last node using a value has been evaluated the   */
+/*            value is freed, and a product whose left value has no other use */
+/*            is built in that value rather than in a copy.                   */
+/******************************************************************************/
+int evaluate_word_program(WORD_REDUCER *reducer,
+                          WORD_PROGRAM *program,
+                          GENERATOR_WORD *result)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = WORD_POWER_OK;
+  WORD_PROGRAM_NODE *nodes = program->nodes;
+  WORD_PROGRAM_NODE *node;
+  GENERATOR_WORD *value;
+  GENERATOR_WORD *first;
+  int ii;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(reducer != NULL);
+  assert(program != NULL && program->root != -1);
+  assert(result != NULL);
+
+  for (ii = 0; ii < program->num_nodes; ii++)
+  {
+    nodes[ii].uses = 0;
+  }
+  nodes[program->root].uses = 1;
+  for (ii = program->root; ii >= 0; ii--)
+  {
+    if (nodes[ii].uses > 0 && nodes[ii].type != WORD_PROGRAM_RUN)
+    {
+      nodes[nodes[ii].left].uses++;
+      if (nodes[ii].type == WORD_PROGRAM_PRODUCT)
+      {
+        nodes[nodes[ii].right].uses++;
+      }
+    }
+  }
+
+  for (ii = 0; ii <= program->root; ii++)
+  {
+    node = &(nodes[ii]);
+    if (node->uses == 0)
+    {
+      continue;
+    }
+
+    /**************************************************************************/
+    /* A product may take over its left value if nothing else needs it.       */
+    /**************************************************************************/
+    first = (node->type == WORD_PROGRAM_RUN) ? NULL : nodes[node->left].value;
+    if (node->type == WORD_PROGRAM_PRODUCT &&
+        node->left != node->right &&
+        nodes[node->left].uses == 1)
+    {
+      node->value = first;
+      nodes[node->left].value = NULL;
+      first = NULL;
+    }
+    else if (init_generator_word(&(node->value)) != GENERATOR_WORD_OK)
+    {
+      ret_code = WORD_POWER_MEM_ERR;
+      goto EXIT_LABEL;
+    }
+    value = node->value;
+
+    if (node->type == WORD_PROGRAM_RUN)
+    {
+      if (reserve_generator_word(value, node->right) != GENERATOR_WORD_OK)
+      {
+        ret_code = WORD_POWER_MEM_ERR;
+        goto EXIT_LABEL;
+      }
+      memcpy(value->generators, program->letters + node->left, node->right);
+      value->length = node->right;
+      if (reduce_generator_word(reducer, value) != WORD_REDUCER_OK)
+      {
+        ret_code = WORD_POWER_MEM_ERR;
+      }
+    }
+    else if (node->type == WORD_PROGRAM_PRODUCT)
+    {
+      ret_code = multiply_generator_words(reducer,
+                                          (first == NULL) ? value : first,
+                                          nodes[node->right].value,
+                                          value);
+    }
+    else
+    {
+      ret_code = power_reduced_word(reducer,
+                                    nodes[node->left].value,
+                                    node->exponent,
+                                    value);
+    }
+    if (ret_code != WORD_POWER_OK)
+    {
+      goto EXIT_LABEL;
+    }
+
+    /**************************************************************************/
+    /* Free the values of the nodes used which aren't needed any more.        */
+    /**************************************************************************/
+    if (node->type != WORD_PROGRAM_RUN)
+    {
+      nodes[node->left].uses--;
+      if (nodes[node->left].uses == 0 && nodes[node->left].value != NULL)
+      {
+        free_generator_word(nodes[node->left].value);
+        nodes[node->left].value = NULL;
+      }
+    }
+    if (node->type == WORD_PROGRAM_PRODUCT)
+    {
+      nodes[node->right].uses--;
+      if (nodes[node->right].uses == 0 && nodes[node->right].value != NULL)
+      {
+        free_generator_word(nodes[node->right].value);
+        nodes[node->right].value = NULL;
+      }
+    }
+  }
+
+  /****************************************************************************/
+  /* Copy the value of the root out.                                          */
+  /****************************************************************************/
+  value = nodes[program->root].value;
+  if (reserve_generator_word(result, value->length) != GENERATOR_WORD_OK)
+  {
+    ret_code = WORD_POWER_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  memcpy(result->generators, value->generators, value->length);
+  result->length = value->length;
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
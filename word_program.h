@@ -0,0 +1,85 @@
+/******************************************************************************/
+/* Group: WORD_PROGRAM_RET_CODES                                              */
+/*                                                                            */
+/* The return codes for functions init_word_program, add_word_program_node    */
+/* and parse_word_program. WORD_PROGRAM_INVALID means the expression isn't    */
+/* letters and bracketed words raised to powers. WORD_PROGRAM_TOO_BIG means   */
+/* an exponent doesn't fit in 64 bits.                                        */
+/******************************************************************************/
+#define WORD_PROGRAM_OK      0
+#define WORD_PROGRAM_MEM_ERR 1
+#define WORD_PROGRAM_INVALID 2
+#define WORD_PROGRAM_TOO_BIG 3
+
+/******************************************************************************/
+/* Group: WORD_PROGRAM_NODE_TYPES                                             */
+/*                                                                            */
+/* The kinds of node in a word program. A run is letters as they were typed,  */
+/* a product is one node followed by another and a power is a node raised to  */
+/* an exponent.                                                               */
+/******************************************************************************/
+#define WORD_PROGRAM_RUN     0
+#define WORD_PROGRAM_PRODUCT 1
+#define WORD_PROGRAM_POWER   2
+
+/******************************************************************************/
+/* The number of nodes and hash buckets a word program has room for to begin  */
+/* with. Both double as the program grows.                                    */
+/******************************************************************************/
+#define WORD_PROGRAM_INITIAL_CAPACITY 64
+
+/******************************************************************************/
+/* This structure is a node of a word program.                                */
+/* type - One of WORD_PROGRAM_NODE_TYPES.                                     */
+/* left - For a run the index of its first letter in the letters of the       */
+/*        program, for a product the node on the left and for a power the     */
+/*        node raised to the power.                                           */
+/* right - For a run the number of letters, for a product the node on the     */
+/*         right and unused for a power.                                      */
+/* exponent - For a power the exponent and unused otherwise.                  */
+/* hash - The hash of the fields above, kept so the buckets can be rebuilt.   */
+/* next - The next node in the same hash bucket, or -1.                       */
+/* uses - The number of nodes still to be evaluated which use this one.       */
+/* value - The reduced word the node evaluates to, or NULL if it hasn't been  */
+/*         evaluated or is no longer needed.                                  */
+/******************************************************************************/
+typedef struct word_program_node
+{
+  int type;
+  int left;
+  int right;
+  uint64_t exponent;
+  uint64_t hash;
+  int next;
+  int uses;
+  GENERATOR_WORD *value;
+} WORD_PROGRAM_NODE;
+
+/******************************************************************************/
+/* This structure is a word expression held as a straight line program. Each  */
+/* node is only ever added once, so a subexpression repeated anywhere in the  */
+/* expression is a single node and is reduced once. Every node comes after    */
+/* the nodes it uses.                                                         */
+/* nodes - The nodes of the program.                                          */
+/* num_nodes - The number of nodes.                                           */
+/* capacity - The number of nodes there is room for.                          */
+/* letters - The generators of every run, one after another.                  */
+/* num_letters - The number of generators in letters.                         */
+/* letters_capacity - The number of generators there is room for.             */
+/* buckets - buckets[i] is the first node whose hash modulo num_buckets is i, */
+/*           or -1.                                                           */
+/* num_buckets - The number of buckets, which is a power of two.              */
+/* root - The node for the whole expression, or -1 before it is parsed.       */
+/******************************************************************************/
+typedef struct word_program
+{
+  WORD_PROGRAM_NODE *nodes;
+  int num_nodes;
+  int capacity;
+  uint8_t *letters;
+  int num_letters;
+  int letters_capacity;
+  int *buckets;
+  int num_buckets;
+  int root;
+} WORD_PROGRAM;
@@ -0,0 +1,552 @@
+#include "cox_prot.h"
+
+/******************************************************************************/
+/* Function: init_word_reducer                                                */
+/*                                                                            */
+/* Returns: One of WORD_REDUCER_RET_CODES.                                    */
+/*                                                                            */
+/* Parameters: IN     table - The automaton.                                  */
+/*             OUT    reducer - Will be returned with all necessary memory    */
+/*                              allocated.                                    */
+/*                                                                            */
+/* Operation: Allocate the reducer and a stack of the initial size. The       */
+/*            automaton is only pointed to and must outlive the reducer.      */
+/******************************************************************************/
+int init_word_reducer(AUTOMATON_TABLE *table, WORD_REDUCER **reducer)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = WORD_REDUCER_OK;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(table != NULL);
+  assert(reducer != NULL);
+
+  *reducer = (WORD_REDUCER *) malloc(sizeof(WORD_REDUCER));
+  if (*reducer == NULL)
+  {
+    ret_code = WORD_REDUCER_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  (*reducer)->num_generators = table->num_generators;
+  (*reducer)->table = table;
+  (*reducer)->components = NULL;
+  (*reducer)->exchange = NULL;
+  (*reducer)->projection = NULL;
+  (*reducer)->positions = NULL;
+  (*reducer)->projection_capacity = 0;
+  (*reducer)->capacity = WORD_REDUCER_INITIAL_CAPACITY;
+  (*reducer)->states = (int32_t *) malloc(sizeof(int32_t) *
+                                          WORD_REDUCER_INITIAL_CAPACITY);
+  if ((*reducer)->states == NULL)
+  {
+    free(*reducer);
+    *reducer = NULL;
+    ret_code = WORD_REDUCER_MEM_ERR;
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: init_component_word_reducer                                      */
+/*                                                                            */
+/* Returns: One of WORD_REDUCER_RET_CODES.                                    */
+/*                                                                            */
+/* Parameters: IN     components - The automata for each component of a       */
+/*                                 reducible group.                           */
+/*             OUT    reducer - Will be returned with all necessary memory    */
+/*                              allocated.                                    */
+/*                                                                            */
+/* Operation: The same as init_word_reducer but the words are reduced one     */
+/*            component at a time with reduce_component_word. The room for    */
+/*            the letters of a component is only allocated when a word is     */
+/*            reduced.                                                        */
+/******************************************************************************/
+int init_component_word_reducer(COMPONENT_AUTOMATON *components,
+                                WORD_REDUCER **reducer)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = WORD_REDUCER_OK;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(components != NULL);
+  assert(reducer != NULL);
+
+  *reducer = (WORD_REDUCER *) malloc(sizeof(WORD_REDUCER));
+  if (*reducer == NULL)
+  {
+    ret_code = WORD_REDUCER_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  (*reducer)->num_generators = components->num_generators;
+  (*reducer)->table = NULL;
+  (*reducer)->components = components;
+  (*reducer)->exchange = NULL;
+  (*reducer)->projection = NULL;
+  (*reducer)->positions = NULL;
+  (*reducer)->projection_capacity = 0;
+  (*reducer)->capacity = WORD_REDUCER_INITIAL_CAPACITY;
+  (*reducer)->states = (int32_t *) malloc(sizeof(int32_t) *
+                                          WORD_REDUCER_INITIAL_CAPACITY);
+  if ((*reducer)->states == NULL)
+  {
+    free(*reducer);
+    *reducer = NULL;
+    ret_code = WORD_REDUCER_MEM_ERR;
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: init_exchange_word_reducer                                       */
+/*                                                                            */
+/* Returns: One of WORD_REDUCER_RET_CODES.                                    */
+/*                                                                            */
+/* Parameters: IN     exchange - The exchange condition reducer to use.       */
+/*             OUT    reducer - Will be returned with all necessary memory    */
+/*                              allocated.                                    */
+/*                                                                            */
+/* Operation: The same as init_word_reducer but the words are reduced with    */
+/*            exchange_reduce_generator_word, which keeps its own stack, so   */
+/*            no stack is allocated. The exchange reducer is only pointed to  */
+/*            and must outlive the reducer.                                   */
+/******************************************************************************/
+int init_exchange_word_reducer(EXCHANGE_REDUCER *exchange,
+                               WORD_REDUCER **reducer)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = WORD_REDUCER_OK;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(exchange != NULL);
+  assert(reducer != NULL);
+
+  *reducer = (WORD_REDUCER *) calloc(1, sizeof(WORD_REDUCER));
+  if (*reducer == NULL)
+  {
+    ret_code = WORD_REDUCER_MEM_ERR;
+    goto EXIT_LABEL;
+  }
+  (*reducer)->num_generators = exchange->action_table->num_generators;
+  (*reducer)->exchange = exchange;
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: free_word_reducer                                                */
+/*                                                                            */
+/* Returns: Nothing.                                                          */
+/*                                                                            */
+/* Parameters: IN     reducer - The reducer to be freed.                      */
+/*                                                                            */
+/* Operation: Free the stack, the room for the letters of a component and     */
+/*            then the reducer itself. The automata and the exchange reducer  */
+/*            are left alone.                                                 */
+/******************************************************************************/
+void free_word_reducer(WORD_REDUCER *reducer)
+{
+  assert(reducer != NULL);
+
+  free(reducer->states);
+  free(reducer->projection);
+  free(reducer->positions);
+  free(reducer);
+
+  return;
+}
+
+/******************************************************************************/
+/* Function: reduce_word                                                      */
+/*                                                                            */
+/* Returns: One of WORD_REDUCER_RET_CODES.                                    */
+/*                                                                            */
+/* Parameters: IN     reducer - The reducer to use.                           */
+/*             IN/OUT word - The word to be reduced. Will be returned holding */
+/*                           the reduced word.                                */
+/*             OUT    length - Will be returned holding the length of the     */
+/*                             reduced word.                                  */
+/*                                                                            */
+/* Operation: Turn the letters into generator indices in place, reduce them   */
+/*            with reduce_generator_word and turn them back into letters.     */
+/******************************************************************************/
+int reduce_word(WORD_REDUCER *reducer, char *word, int *length)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = WORD_REDUCER_OK;
+  GENERATOR_WORD generator_word;
+  int ii;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(reducer != NULL);
+  assert(word != NULL);
+  assert(length != NULL);
+
+  generator_word.generators = (uint8_t *) word;
+  generator_word.length = (int) strlen(word);
+  generator_word.capacity = generator_word.length;
+  for (ii = 0; ii < generator_word.length; ii++)
+  {
+    generator_word.generators[ii] -= ASCII_LOWER_A;
+  }
+
+  ret_code = reduce_generator_word(reducer, &generator_word);
+
+  for (ii = 0; ii < generator_word.length; ii++)
+  {
+    generator_word.generators[ii] += ASCII_LOWER_A;
+  }
+  word[generator_word.length] = '\0';
+  *length = generator_word.length;
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: reserve_word_reducer                                             */
+/*                                                                            */
+/* Returns: One of WORD_REDUCER_RET_CODES.                                    */
+/*                                                                            */
+/* Parameters: IN/OUT reducer - The reducer to grow.                          */
+/*             IN     length - The length of the word about to be reduced.    */
+/*                                                                            */
+/* Operation: Make sure the stack has room for a state after every letter     */
+/*            and, when reducing by components, that there is room for every  */
+/*            letter to be in one component.                                  */
+/******************************************************************************/
+int reserve_word_reducer(WORD_REDUCER *reducer, size_t length)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = WORD_REDUCER_OK;
+  int32_t *states;
+  uint8_t *projection;
+  int32_t *positions;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(reducer != NULL);
+
+  if (length + 1 > reducer->capacity)
+  {
+    states = (int32_t *) realloc(reducer->states,
+                                 sizeof(int32_t) * (length + 1));
+    if (states == NULL)
+    {
+      ret_code = WORD_REDUCER_MEM_ERR;
+      goto EXIT_LABEL;
+    }
+    reducer->states = states;
+    reducer->capacity = length + 1;
+  }
+
+  if (reducer->components != NULL && length > reducer->projection_capacity)
+  {
+    projection = (uint8_t *) realloc(reducer->projection, length);
+    if (projection == NULL)
+    {
+      ret_code = WORD_REDUCER_MEM_ERR;
+      goto EXIT_LABEL;
+    }
+    reducer->projection = projection;
+    positions = (int32_t *) realloc(reducer->positions,
+                                    sizeof(int32_t) * length);
+    if (positions == NULL)
+    {
+      ret_code = WORD_REDUCER_MEM_ERR;
+      goto EXIT_LABEL;
+    }
+    reducer->positions = positions;
+    reducer->projection_capacity = length;
+  }
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: reduce_table_word                                                */
+/*                                                                            */
+/* Returns: The length of the reduced word.                                   */
+/*                                                                            */
+/* Parameters: IN     table - The automaton.                                  */
+/*             IN/OUT states - Room for a state after every letter.           */
+/*             IN/OUT generators - The word to be reduced. Will be returned   */
+/*                                 holding the reduced word.                  */
+/*             IN/OUT positions - If not NULL then a number for each letter,  */
+/*                                which is moved along with it. Will be       */
+/*                                returned holding the numbers of the letters */
+/*                                which are kept.                             */
+/*             IN     length - The length of the word.                        */
+/*                                                                            */
+/* Operation: Build the reduced word at the front of the same buffer, a       */
+/*            letter at a time, keeping the state reached after each letter.  */
+/*            The reduced word so far is always reduced, so when a letter is  */
+/*            rejected the letter it cancels with is the one at which the     */
+/*            automaton, reading back from the rejected letter, rejects. The  */
+/*            reduced words are closed under reversal, so this is the same    */
+/*            table read the other way. That letter is deleted, the rejected  */
+/*            one is dropped and only the states after the deleted letter are */
+/*            worked out again. This gives the same reduced word as           */
+/*            repeatedly searching the whole word from the start, but the     */
+/*            work for each cancellation is only the distance between the two */
+/*            letters.                                                        */
+/******************************************************************************/
+int reduce_table_word(AUTOMATON_TABLE *table,
+                      int32_t *states,
+                      uint8_t *generators,
+                      int32_t *positions,
+                      int length)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int num_generators = table->num_generators;
+  const int32_t *transitions = table->transitions;
+  int32_t next;
+  int reduced_length = 0;
+  int generator;
+  int read_index;
+  int cancel_index;
+
+  states[0] = table->start_state;
+
+  for (read_index = 0; read_index < length; read_index++)
+  {
+    generator = generators[read_index];
+    next = transitions[states[reduced_length] * num_generators + generator];
+    if (next != AUTOMATON_TABLE_REJECT_STATE)
+    {
+      generators[reduced_length] = (uint8_t) generator;
+      if (positions != NULL)
+      {
+        positions[reduced_length] = positions[read_index];
+      }
+      reduced_length++;
+      states[reduced_length] = next;
+      continue;
+    }
+
+    /**************************************************************************/
+    /* Find the letter the rejected one cancels with. Reading back from the   */
+    /* rejected letter always rejects before running out of letters as the    */
+    /* reduced word with the rejected letter on the end isn't reduced.        */
+    /**************************************************************************/
+    next = transitions[table->start_state * num_generators + generator];
+    for (cancel_index = reduced_length - 1; cancel_index > 0; cancel_index--)
+    {
+      next = transitions[next * num_generators + generators[cancel_index]];
+      if (next == AUTOMATON_TABLE_REJECT_STATE)
+      {
+        break;
+      }
+    }
+
+    /**************************************************************************/
+    /* Delete it and work out the states after it again. What is left is the  */
+    /* reduced word with the rejected letter on the end, so it is reduced.    */
+    /**************************************************************************/
+    memmove(generators + cancel_index,
+            generators + cancel_index + 1,
+            reduced_length - cancel_index - 1);
+    if (positions != NULL)
+    {
+      memmove(positions + cancel_index,
+              positions + cancel_index + 1,
+              sizeof(int32_t) * (reduced_length - cancel_index - 1));
+    }
+    reduced_length--;
+    for (; cancel_index < reduced_length; cancel_index++)
+    {
+      states[cancel_index + 1] =
+                  transitions[states[cancel_index] * num_generators +
+                              generators[cancel_index]];
+    }
+  }
+
+  return(reduced_length);
+}
+
+/******************************************************************************/
+/* Function: reduce_generator_word                                            */
+/*                                                                            */
+/* Returns: One of WORD_REDUCER_RET_CODES.                                    */
+/*                                                                            */
+/* Parameters: IN     reducer - The reducer to use.                           */
+/*             IN/OUT word - The word to be reduced. Will be returned holding */
+/*                           the reduced word.                                */
+/*                                                                            */
+/* Operation: Reduce the word with reduce_table_word, with                    */
+/*            reduce_component_word if the group is split into components or  */
+/*            with exchange_reduce_generator_word if there is no automaton.   */
+/******************************************************************************/
+int reduce_generator_word(WORD_REDUCER *reducer, GENERATOR_WORD *word)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = WORD_REDUCER_OK;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(reducer != NULL);
+  assert(word != NULL);
+
+  if (reducer->components != NULL)
+  {
+    ret_code = reduce_component_word(reducer, word);
+    goto EXIT_LABEL;
+  }
+  if (reducer->exchange != NULL)
+  {
+    if (exchange_reduce_generator_word(reducer->exchange, word) !=
+                                                          EXCHANGE_REDUCER_OK)
+    {
+      ret_code = WORD_REDUCER_MEM_ERR;
+    }
+    goto EXIT_LABEL;
+  }
+
+  ret_code = reserve_word_reducer(reducer, (size_t) word->length);
+  if (ret_code != WORD_REDUCER_OK)
+  {
+    goto EXIT_LABEL;
+  }
+  word->length = reduce_table_word(reducer->table,
+                                   reducer->states,
+                                   word->generators,
+                                   NULL,
+                                   word->length);
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
+
+/******************************************************************************/
+/* Function: reduce_component_word                                            */
+/*                                                                            */
+/* Returns: One of WORD_REDUCER_RET_CODES.                                    */
+/*                                                                            */
+/* Parameters: IN     reducer - The reducer to use. Its components must not   */
+/*                              be NULL.                                      */
+/*             IN/OUT word - The word to be reduced. Will be returned holding */
+/*                           the reduced word.                                */
+/*                                                                            */
+/* Operation: The group is the direct product of its components, so the       */
+/*            letters of one component only ever cancel with each other. Pick */
+/*            out the letters of each component in turn, reduce them with     */
+/*            that component's automaton alone and mark the letters which are */
+/*            kept. The marks are masked off when picking out the later       */
+/*            components. The marked letters are then kept in the order they  */
+/*            were in, which is the same reduced word reduce_table_word gives */
+/*            with the automaton for the whole group.                         */
+/******************************************************************************/
+int reduce_component_word(WORD_REDUCER *reducer, GENERATOR_WORD *word)
+{
+  /****************************************************************************/
+  /* Local Variables.                                                         */
+  /****************************************************************************/
+  int ret_code = WORD_REDUCER_OK;
+  COMPONENT_AUTOMATON *components = reducer->components;
+  AUTOMATON_TABLE *table;
+  uint8_t *generators = word->generators;
+  uint8_t *projection;
+  int32_t *positions;
+  int projection_length;
+  int reduced_length;
+  int generator;
+  int ii;
+  int cc;
+
+  /****************************************************************************/
+  /* Check input parameters.                                                  */
+  /****************************************************************************/
+  assert(reducer != NULL);
+  assert(reducer->components != NULL);
+  assert(word != NULL);
+
+  ret_code = reserve_word_reducer(reducer, (size_t) word->length);
+  if (ret_code != WORD_REDUCER_OK)
+  {
+    goto EXIT_LABEL;
+  }
+  projection = reducer->projection;
+  positions = reducer->positions;
+
+  for (cc = 0; cc < components->num_components; cc++)
+  {
+    projection_length = 0;
+    for (ii = 0; ii < word->length; ii++)
+    {
+      generator = generators[ii] & ~WORD_REDUCER_KEPT;
+      if (components->component_of[generator] == cc)
+      {
+        projection[projection_length] =
+                           (uint8_t) components->local_generator[generator];
+        positions[projection_length] = ii;
+        projection_length++;
+      }
+    }
+    if (projection_length == 0)
+    {
+      continue;
+    }
+
+    table = components->tables[cc];
+    reduced_length = reduce_table_word(table,
+                                       reducer->states,
+                                       projection,
+                                       positions,
+                                       projection_length);
+    for (ii = 0; ii < reduced_length; ii++)
+    {
+      generators[positions[ii]] |= WORD_REDUCER_KEPT;
+    }
+  }
+
+  /****************************************************************************/
+  /* Close up the letters which are kept, clearing their marks.               */
+  /****************************************************************************/
+  reduced_length = 0;
+  for (ii = 0; ii < word->length; ii++)
+  {
+    if ((generators[ii] & WORD_REDUCER_KEPT) != 0)
+    {
+      generators[reduced_length] = generators[ii] & ~WORD_REDUCER_KEPT;
+      reduced_length++;
+    }
+  }
+  word->length = reduced_length;
+
+EXIT_LABEL:
+
+  return(ret_code);
+}
@@ -0,0 +1,55 @@
+/******************************************************************************/
+/* Group: WORD_REDUCER_RET_CODES                                              */
+/*                                                                            */
+/* The return codes for functions init_word_reducer,                          */
+/* init_component_word_reducer, init_exchange_word_reducer, reduce_word,      */
+/* reduce_generator_word and reduce_component_word.                           */
+/******************************************************************************/
+#define WORD_REDUCER_OK      0
+#define WORD_REDUCER_MEM_ERR 1
+
+/******************************************************************************/
+/* The number of states the stack of a word reducer holds to begin with.      */
+/******************************************************************************/
+#define WORD_REDUCER_INITIAL_CAPACITY 256
+
+/******************************************************************************/
+/* A generator of a word being reduced component by component is marked with  */
+/* this bit once it is known to be kept. Generators are always less than it.  */
+/******************************************************************************/
+#define WORD_REDUCER_KEPT 0x80
+
+/******************************************************************************/
+/* This structure reduces words with the compiled automata in one pass.       */
+/* num_generators - The number of generators of the group.                    */
+/* table - The automaton. The reduced words are closed under reversal, so it  */
+/*         also reads words from right to left. NULL if components or         */
+/*         exchange is used instead.                                          */
+/* components - If not NULL then the automata for each component of a         */
+/*              reducible group, each of which reads its own letters in both  */
+/*              directions.                                                   */
+/* exchange - If not NULL then words are reduced with the exchange condition  */
+/*            rather than with an automaton.                                  */
+/* states - The stack of states. states[i] is the state of table after        */
+/*          reading the first i letters of the reduced word built so far.     */
+/* capacity - The number of states the stack has room for. It grows as longer */
+/*            words are reduced and is kept between words.                    */
+/* projection - The letters of one component of the word, in the columns of   */
+/*              that component's automaton. Only used with components.        */
+/* positions - positions[i] is where letter i of projection is in the word.   */
+/*             Only used with components.                                     */
+/* projection_capacity - The number of letters projection and positions have  */
+/*                       room for.                                            */
+/******************************************************************************/
+typedef struct word_reducer
+{
+  int num_generators;
+  AUTOMATON_TABLE *table;
+  COMPONENT_AUTOMATON *components;
+  EXCHANGE_REDUCER *exchange;
+  int32_t *states;
+  size_t capacity;
+  uint8_t *projection;
+  int32_t *positions;
+  size_t projection_capacity;
+} WORD_REDUCER;